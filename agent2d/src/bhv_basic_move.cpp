@@ -31,8 +31,10 @@
 #include "bhv_basic_move.h"
 
 #include "strategy.h"
+#include "marking_planner.h"
 
 #include "bhv_basic_tackle.h"
+#include "field_analyzer.h"
 
 #include "fuzzy_offensive_pos_eval-inl.h"
 
@@ -52,6 +54,8 @@
 #include "neck_offensive_intercept_neck.h"
 
 #include <algorithm>
+#include <limits>
+#include <cmath>
 
 using namespace rcsc;
 
@@ -542,66 +546,17 @@ bool Bhv_BasicMove::shouldMark(rcsc::PlayerAgent * agent,
 //robottoCode
 Vector2D Bhv_BasicMove::getMarkingPosition(PlayerAgent * agent,
 										   Vector2D strategicPosition) {
-  // static const int thr = 3;
-  static const int thr = 4;
-	
   const WorldModel & wm = agent->world();
 
-	double distNearestOpp = wm.getDistOpponentNearestTo(strategicPosition ,thr);
-
-  rcsc::Vector2D ballFpos = wm.ball().inertiaFinalPoint();
-
-	if ( (strategicPosition.dist(wm.ball().pos() ) <  distNearestOpp + 3) ||
-       (strategicPosition.dist(ballFpos) <  distNearestOpp + 3) ) {
-		// return strategicPosition;
-	}
-
-  int distThr;
-
-  if (Strategy::i().isMidfielderType(wm.self().unum() ) ) {
-    if (strategicPosition.x > -28) {
-      distThr = 7;
-    } else {
-      distThr = 7;
-    }
-  } else if (Strategy::i().isMarkerType(wm.self().unum() ) ) {
-    if (strategicPosition.x > - 30) {
-      distThr = 5;
-    } else {
-      distThr = 7;
-    }
-  } else {
-    distThr = 7;
-  }
-
-	if (distNearestOpp < distThr) {
-		const PlayerObject* opp = 
-      wm.getOpponentNearestTo(strategicPosition, thr, &distNearestOpp);
-
-		double dist = 0;
-
-		const PlayerObject* opp2 =
-      wm.getOpponentNearestTo(wm.ball().pos(), thr, &dist);
-      // wm.getOpponentNearestTo(ballFpos, thr, &dist);
-
-		if (opp == opp2) {
-			// return strategicPosition;
-		}
-
-		double distNearestMate = 1000;
-		const PlayerObject * nearestTeammate =
-      wm.getTeammateNearestTo(opp, thr, &distNearestMate);
-
-		if (distNearestMate < distNearestOpp) {
-			if (nearestTeammate->pos().x <= opp->pos().x) {
-        if (distNearestMate > 1.5 &&
-            opp->pos().dist(Vector2D(-52, 0) ) < 15 ) {
-        } else {
-          return strategicPosition;
-        }
-			}
-		}
+	// the marker and midfielder types get the opponent from the team
+	//   consistent plan, so no other teammate is marking the same opponent.
+	//   the other roles still pick the nearest opponent by themselves.
+	const PlayerObject* opp =
+		(MarkingPlanner::is_planned_role(wm.self().unum())
+		 ? MarkingPlanner::i().markTarget(wm.self().unum())
+		 : getNearestMarkTarget(wm, strategicPosition));
 
+	if (opp) {
     int factor = wm.ball().pos().y >= 0? 1 : -1;
 		if (opp->pos().x <= wm.ourDefenseLineX() && wm.ourDefenseLineX() > -30) {
 			// return rcsc::Vector2D (wm.ourDefenseLineX() - 2, opp->pos().y /*+ factor*/);
@@ -650,6 +605,40 @@ Vector2D Bhv_BasicMove::getMarkingPosition(PlayerAgent * agent,
 	return strategicPosition;
 }
 
+//robottoCode
+const PlayerObject * Bhv_BasicMove::getNearestMarkTarget(const WorldModel & wm,
+														 Vector2D strategicPosition) {
+  static const int thr = 4;
+  static const double distThr = 7;
+
+	const PlayerGrid & oppGrid = FieldAnalyzer::i().opponentGrid();
+
+	double distNearestOpp = 0;
+	const PlayerObject* opp =
+		oppGrid.nearest(strategicPosition, thr, &distNearestOpp);
+
+	if (! opp || distNearestOpp >= distThr) {
+		return static_cast<const PlayerObject *>(0);
+	}
+
+	double distNearestMate = 1000;
+	const PlayerObject * nearestTeammate =
+		FieldAnalyzer::i().teammateGrid().nearest(opp->pos(), thr, &distNearestMate);
+
+	if (nearestTeammate && distNearestMate < distNearestOpp) {
+		if (nearestTeammate->pos().x <= opp->pos().x) {
+			if (distNearestMate > 1.5 &&
+				opp->pos().dist(Vector2D(-52, 0) ) < 15 ) {
+			} else {
+				// a teammate is already marking it
+				return static_cast<const PlayerObject *>(0);
+			}
+		}
+	}
+
+	return opp;
+}
+
 //robottoCode
 bool Bhv_BasicMove::shouldMoveToAttack(rcsc::PlayerAgent * agent,
 									   rcsc::Vector2D strategicPosition) {
@@ -746,13 +735,31 @@ rcsc::Vector2D Bhv_BasicMove::getAttackPosition(rcsc::PlayerAgent * agent,
 	return wm.self().pos().dist(pos1) < wm.self().pos().dist(pos2)? pos1 : pos2;
 }
 
+namespace {
+
+// directions of the attack position candidates, (1, 0) is backward and
+//   (0, 1) is sideward
+const int kAttackDirections = 5;
+const double kAttackDirectionX[kAttackDirections] = { 1.0, 1.0, 1.0, 0.5, 0.0 };
+const double kAttackDirectionY[kAttackDirections] = { 0.0, 0.5, 1.0, 1.0, 1.0 };
+
+const int kMaxAttackCandidates = 1 + 10 * kAttackDirections;
+const int kMaxAttackOpponents = 11;
+const int kAttackOppCountThr = 5;
+
+const double kAttackGoalX = 45.0;
+const double kAttackNoOppDist = 65535.0;
+const double kAttackNoLineOppDist = 100.0;
+
+}
+
 //robottoCode
 rcsc::Vector2D Bhv_BasicMove::getFuzzyAttackPosition(rcsc::PlayerAgent * agent,
 								 	 	 	 	rcsc::Vector2D strategicPosition) {
 	const WorldModel & wm = agent->world();
 
 	double maxDisplacement = 6;
-	double step            = 2;
+	double step            = 1;
 
 	int yFactor;
 
@@ -800,63 +807,134 @@ rcsc::Vector2D Bhv_BasicMove::getFuzzyAttackPosition(rcsc::PlayerAgent * agent,
 	}
   */
 
-	rcsc::Vector2D bestAttackPos,
-	               currAttackPos;
-
-	bestAttackPos = strategicPosition;
-
-	double distBallPos,
-	       distOppPos,
-		   distBallLineOpp,
-		   distCurrPos,
-		   distOppGoalPos;
-
-	double bestPosEval,
-	       currPosEval;
-
-	bestPosEval = -10;
-
-	for (double i = 0; i < maxDisplacement; i += step) {
-		for (double j = 0; j < 3; j ++) {
-			if (j == 0) {
-				currAttackPos = strategicPosition + rcsc::Vector2D(-i * xFactor, 0);
-			} else if (j == 1) {
-				currAttackPos = strategicPosition + rcsc::Vector2D( 0, yFactor * i);
-			} else if (j == 2) {
-				currAttackPos = strategicPosition + rcsc::Vector2D(-i * xFactor, yFactor * i);
+	//
+	// build all candidate points.
+	// displacement i is applied along each direction (back, side and
+	//   the mixes between them), the zero displacement is added once.
+	//
+	double candX[kMaxAttackCandidates],
+	       candY[kMaxAttackCandidates];
+	int candCount = 0;
+
+	candX[candCount] = strategicPosition.x;
+	candY[candCount] = strategicPosition.y;
+	++candCount;
+
+	for (double i = step; i < maxDisplacement; i += step) {
+		for (int j = 0; j < kAttackDirections; j ++) {
+			if (candCount >= kMaxAttackCandidates) {
+				break;
 			}
+			candX[candCount] = strategicPosition.x - i * xFactor * kAttackDirectionX[j];
+			candY[candCount] = strategicPosition.y + i * yFactor * kAttackDirectionY[j];
+			++candCount;
+		}
+	}
 
-			distBallPos = currAttackPos.dist(wm.ball().pos() );
-			distOppPos  = wm.getDistOpponentNearestTo(currAttackPos, 5);
+	//
+	// flat opponent array taken from the per-cycle spatial index
+	//   (same count threshold as getDistOpponentNearestTo)
+	//
+	double oppX[kMaxAttackOpponents],
+	       oppY[kMaxAttackOpponents];
+	int oppCount = 0;
+
+	const std::vector<PlayerGrid::Entry> & oppEntries =
+		FieldAnalyzer::i().opponentGrid().entries();
+	const std::vector<PlayerGrid::Entry>::const_iterator oppEnd = oppEntries.end();
+	for (std::vector<PlayerGrid::Entry>::const_iterator it = oppEntries.begin();
+		 it != oppEnd && oppCount < kMaxAttackOpponents;
+		 ++it) {
+		if (it->pos_count_ > kAttackOppCountThr) {
+			continue;
+		}
+		oppX[oppCount] = it->x_;
+		oppY[oppCount] = it->y_;
+		++oppCount;
+	}
 
-			rcsc::Segment2D* ballLine = new rcsc::Segment2D (currAttackPos, wm.ball().pos());
+	const Vector2D ballPos = wm.ball().pos();
+	const Vector2D selfPos = wm.self().pos();
+
+	//
+	// input distances for all candidates
+	//
+	double distBallPos[kMaxAttackCandidates],
+	       distOppPos[kMaxAttackCandidates],
+	       distBallLineOpp[kMaxAttackCandidates],
+	       distCurrPos[kMaxAttackCandidates],
+	       distOppGoalPos[kMaxAttackCandidates];
+
+	for (int c = 0; c < candCount; c ++) {
+		const double bx = candX[c] - ballPos.x;
+		const double by = candY[c] - ballPos.y;
+		const double sx = candX[c] - selfPos.x;
+		const double sy = candY[c] - selfPos.y;
+		const double gx = candX[c] - kAttackGoalX;
+		const double gy = candY[c];
+
+		distBallPos[c]    = std::sqrt(bx * bx + by * by);
+		distCurrPos[c]    = std::sqrt(sx * sx + sy * sy);
+		distOppGoalPos[c] = std::sqrt(gx * gx + gy * gy);
+		distOppPos[c]     = kAttackNoOppDist * kAttackNoOppDist;
+		distBallLineOpp[c] = kAttackNoLineOppDist * kAttackNoLineOppDist;
+	}
 
-			const PlayerPtrCont & opps = wm.opponentsFromBall();
+	for (int o = 0; o < oppCount; o ++) {
+		const double ox = oppX[o];
+		const double oy = oppY[o];
+		for (int c = 0; c < candCount; c ++) {
+			const double dx = candX[c] - ox;
+			const double dy = candY[c] - oy;
+			distOppPos[c] = std::min(distOppPos[c], dx * dx + dy * dy);
+		}
+	}
 
-			if (opps.size() < 2) {
-				distBallLineOpp = 100;
-			} else {
-				distBallLineOpp = std::min(ballLine->dist(opps[0]->pos() ),
-						                   ballLine->dist(opps[1]->pos() ) );
-			}
+	// the segment from each candidate to the ball against the two
+	//   opponents nearest to the ball
+	const PlayerPtrCont & opps = wm.opponentsFromBall();
 
-			delete ballLine;
+	if (opps.size() >= 2) {
+		for (int c = 0; c < candCount; c ++) {
+			distBallLineOpp[c] = std::numeric_limits<double>::max();
+		}
 
-			distCurrPos = currAttackPos.dist(wm.self().pos() );
+		for (int o = 0; o < 2; o ++) {
+			const double px = opps[o]->pos().x;
+			const double py = opps[o]->pos().y;
+			for (int c = 0; c < candCount; c ++) {
+				const double vx = ballPos.x - candX[c];
+				const double vy = ballPos.y - candY[c];
+				const double wx = px - candX[c];
+				const double wy = py - candY[c];
+				const double len2 = vx * vx + vy * vy;
+				double t = (len2 > 0.0 ? (wx * vx + wy * vy) / len2 : 0.0);
+				t = std::max(0.0, std::min(1.0, t));
+				const double dx = wx - t * vx;
+				const double dy = wy - t * vy;
+				distBallLineOpp[c] = std::min(distBallLineOpp[c], dx * dx + dy * dy);
+			}
+		}
+	}
 
-			distOppGoalPos = currAttackPos.dist(rcsc::Vector2D(45, 0) );
+	//
+	// score through the compiled fuzzy table
+	//
+	Vector2D bestAttackPos = strategicPosition;
+	double bestPosEval = -10;
 
-			currPosEval = FuzzyOffensivePosEval::getOffensivePosEval(distBallPos,
-					                                                 distOppPos,
-					                                                 distBallLineOpp,
-					                                                 distCurrPos,
-					                                                 distOppGoalPos);
+	for (int c = 0; c < candCount; c ++) {
+		const double currPosEval
+			= FuzzyOffensivePosEval::getOffensivePosEval(distBallPos[c],
+					                                     std::sqrt(distOppPos[c]),
+					                                     std::sqrt(distBallLineOpp[c]),
+					                                     distCurrPos[c],
+					                                     distOppGoalPos[c]);
 
-			if (currPosEval > bestPosEval) {
-				bestPosEval = currPosEval;
+		if (currPosEval > bestPosEval) {
+			bestPosEval = currPosEval;
 
-				bestAttackPos = currAttackPos;
-			}
+			bestAttackPos.assign(candX[c], candY[c]);
 		}
 	}
 
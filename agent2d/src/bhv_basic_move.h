@@ -30,6 +30,11 @@
 #include <rcsc/geom/vector_2d.h>
 #include <rcsc/player/soccer_action.h>
 
+namespace rcsc {
+class PlayerObject;
+class WorldModel;
+}
+
 class Bhv_BasicMove
     : public rcsc::SoccerBehavior {
 public:
@@ -53,6 +58,8 @@ private:
 					rcsc::Vector2D strategicPosition);
     rcsc::Vector2D getMarkingPosition(rcsc::PlayerAgent * agent,
     								  rcsc::Vector2D strategicPosition);
+    const rcsc::PlayerObject * getNearestMarkTarget(const rcsc::WorldModel & wm,
+    												rcsc::Vector2D strategicPosition);
     bool shouldMoveToAttack(rcsc::PlayerAgent * agent,
 							rcsc::Vector2D strategicPosition);
 	rcsc::Vector2D getAttackPosition(rcsc::PlayerAgent * agent,
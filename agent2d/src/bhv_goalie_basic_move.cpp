@@ -32,6 +32,7 @@
 
 #include "bhv_basic_tackle.h"
 #include "neck_goalie_turn_neck.h"
+#include "ball_kinematics.h"
 
 #include <rcsc/action/basic_actions.h>
 #include <rcsc/action/body_go_to_point.h>
@@ -152,7 +153,7 @@ Bhv_GoalieBasicMove::getTargetPoint( PlayerAgent * agent )
             = std::min( wm.interceptTable()->teammateReachCycle(),
                         wm.interceptTable()->opponentReachCycle() );
     }
-    const Vector2D base_pos = wm.ball().inertiaPoint( ball_reach_step );
+    const Vector2D base_pos = BallKinematics::instance().ballInertiaPoint( wm, ball_reach_step );
 
 
     //---------------------------------------------------------//
@@ -227,10 +228,9 @@ Bhv_GoalieBasicMove::getTargetPoint( PlayerAgent * agent )
             }
 
             ball_point
-                = inertia_n_step_point( base_pos,
-                                        wm.ball().vel(),
-                                        ball_pred_cycle,
-                                        ServerParam::i().ballDecay() );
+                = BallKinematics::instance().inertiaPoint( base_pos,
+                                                           wm.ball().vel(),
+                                                           ball_pred_cycle );
             agent->debugClient().addMessage( "Pos(3)" );
         }
 
@@ -32,6 +32,7 @@
 
 #include "bhv_goalie_basic_move.h"
 #include "bhv_basic_tackle.h"
+#include "ball_kinematics.h"
 
 #include <rcsc/action/basic_actions.h>
 #include <rcsc/action/body_go_to_point.h>
@@ -73,7 +74,7 @@ Bhv_GoalieChaseBall::execute( PlayerAgent * agent )
     ////////////////////////////////////////////////////////////////////////
     // get active interception catch point
 
-    Vector2D my_int_pos = wm.ball().inertiaPoint( wm.interceptTable()->selfReachCycle() );
+    Vector2D my_int_pos = BallKinematics::instance().ballInertiaPoint( wm, wm.interceptTable()->selfReachCycle() );
     dlog.addText( Logger::TEAM,
                   __FILE__": execute. intercept point=(%.2f %.2f)",
                   my_int_pos.x, my_int_pos.y );
@@ -362,7 +363,7 @@ Bhv_GoalieChaseBall::is_ball_chase_situation( const PlayerAgent  * agent )
     ////////////////////////////////////////////////////////////////////////
     // get active interception catch point
 
-    const Vector2D my_int_pos = wm.ball().inertiaPoint( wm.interceptTable()->selfReachCycle() );
+    const Vector2D my_int_pos = BallKinematics::instance().ballInertiaPoint( wm, wm.interceptTable()->selfReachCycle() );
 
     double pen_thr = wm.ball().distFromSelf() * 0.1 + 1.0;
     if ( pen_thr < 1.0 ) pen_thr = 1.0;
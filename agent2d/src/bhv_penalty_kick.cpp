@@ -35,6 +35,7 @@
 #include "bhv_goalie_chase_ball.h"
 #include "bhv_goalie_basic_move.h"
 #include "bhv_go_to_static_ball.h"
+#include "ball_kinematics.h"
 
 #include <rcsc/action/body_clear_ball.h>
 #include <rcsc/action/body_dribble2008.h>
@@ -989,7 +990,7 @@ Bhv_PenaltyKick::doGoalieBasicMove( PlayerAgent * agent )
     ////////////////////////////////////////////////////////////////////////
     // get active interception catch point
     const int self_min = wm.interceptTable()->selfReachCycle();
-    Vector2D move_pos = wm.ball().inertiaPoint( self_min );
+    Vector2D move_pos = BallKinematics::instance().ballInertiaPoint( wm, self_min );
 
     if ( our_penalty.contains( move_pos ) )
     {
@@ -1020,10 +1021,7 @@ Bhv_PenaltyKick::doGoalieBasicMove( PlayerAgent * agent )
     }
     else
     {
-        ball_pos = inertia_n_step_point( wm.ball().pos(),
-                                         wm.ball().vel(),
-                                         3,
-                                         SP.ballDecay() );
+        ball_pos = BallKinematics::instance().ballInertiaPoint( wm, 3 );
     }
 
     move_pos = getGoalieMovePos( ball_pos, my_pos );
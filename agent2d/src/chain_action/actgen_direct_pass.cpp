@@ -28,7 +28,7 @@
 
 #include "actgen_direct_pass.h"
 
-#include "pass.h"
+#include "action_record.h"
 #include "simple_pass_checker.h"
 
 #include "predict_state.h"
@@ -302,17 +302,17 @@ ActGen_DirectPass::generate( std::vector< ActionStatePair > * result,
                                                                (*it)->unum(),
                                                                (*it)->pos() ) );
 
-        CooperativeAction::Ptr action( new Pass( holder->unum(),
-                                                 (*it)->unum(),
-                                                 (*it)->pos(),
-                                                 ball_speed,
-                                                 spend_time,
-                                                 kick_step,
-                                                 false,
-                                                 "actgenDirect" ) );
+        ActionRecord action = ActionRecord::make_pass( holder->unum(),
+                                                       (*it)->unum(),
+                                                       (*it)->pos(),
+                                                       ball_speed,
+                                                       spend_time,
+                                                       kick_step,
+                                                       false,
+                                                       "actgenDirect" );
         ++s_action_count;
         ++generated_count;
-        action->setIndex( s_action_count );
+        action.setIndex( s_action_count );
         result->push_back( ActionStatePair( action, result_state ) );
 
     }
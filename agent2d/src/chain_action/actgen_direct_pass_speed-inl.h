@@ -6,6 +6,7 @@
 #endif
 
 #include "../util/FuzzyController-inl.h"
+#include "../util/FuzzyLookupTable-inl.h"
 
 const double kMinDistance = 1.0;
 const double kMaxDistance = 21.0;
@@ -16,28 +17,52 @@ const int kSpeedOutputIndex = 1;
 const double kMinSpeed = 0.81;
 const double kMaxSpeed = 3.31;
 
+const int kDirectPassSpeedSamples = 201;
+const double kDirectPassSpeedTolerance = 0.01;
+
 class ActGen_DirectPassSpeed {
 public:
-	static double getDirectPassSpeed(double distance,
-									 double discretization = 8) {
+	static double getDirectPassSpeed(double distance) {
 		fuzzy::trimNumeric(&distance,
 				          &kMinDistance,
 				          &kMaxDistance);
 
-		Instance().directPassSpeed.fuzzify(distance,
-										   std::numeric_limits<double>::max());
+		if (Instance().directPassSpeedTable.isValid()) {
+			return Instance().directPassSpeedTable.lookup(&distance);
+		}
+
+		return Instance().evaluate(distance);
+	}
 
-		return Instance().directPassSpeed.defuzzifyCentroid(kSpeedOutputIndex,
-				     	 	 	 	 	 	 	 	 	 	kMinSpeed,
-				     	 	 	 	 	 	 	 	 	 	kMaxSpeed,
-				     	 	 	 	 	 	 	 	 	 	discretization);
+	/**
+	 * @brief
+	 * Creating the singleton compiles the lookup table, so this function
+	 *   should be called once at startup.
+	 * @return true if the lookup table passed the accuracy check
+	 */
+	static bool isLookupTableEnabled() {
+		return Instance().directPassSpeedTable.isValid();
+	}
+
+	static double getLookupTableError() {
+		return Instance().directPassSpeedTable.getMaxError();
 	}
 private:
 	ActGen_DirectPassSpeed() {
 		this->initMembershipFunctions();
 		this->initRuleBase();
+		this->initLookupTable();
 	}
 
+	// the live controller used to compile and check the lookup table
+	struct LiveController {
+		ActGen_DirectPassSpeed* controller;
+
+		double operator()(const double* input) const {
+			return controller->evaluate(input[0]);
+		}
+	};
+
 	// prevent copy-construction
 	ActGen_DirectPassSpeed(const ActGen_DirectPassSpeed&);
 
@@ -92,7 +117,28 @@ private:
 								fuzzy::kRuleEnd());
 	}
 
+	void initLookupTable() {
+		directPassSpeedTable.addAxis(kMinDistance + 1,
+									 kMaxDistance - 1,
+									 kDirectPassSpeedSamples);
+
+		LiveController live;
+		live.controller = this;
+
+		directPassSpeedTable.compile(live);
+		directPassSpeedTable.check(live, kDirectPassSpeedTolerance);
+	}
+
+	double evaluate(double distance) {
+		directPassSpeed.fuzzify(&distance, 1);
+
+		return directPassSpeed.defuzzifyCentroid(kSpeedOutputIndex,
+												 kMinSpeed,
+												 kMaxSpeed);
+	}
+
 	fuzzy::FuzzyController<double> directPassSpeed;
+	fuzzy::FuzzyLookupTable<double> directPassSpeedTable;
 };
 
 #endif // #ifndef ACTGEN_DIRECT_PASS_SPEED_H
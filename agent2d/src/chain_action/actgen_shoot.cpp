@@ -30,7 +30,7 @@
 
 #include "field_analyzer.h"
 
-#include "shoot.h"
+#include "action_record.h"
 #include "action_state_pair.h"
 #include "predict_state.h"
 
@@ -103,12 +103,12 @@ ActGen_Shoot::generate( std::vector< ActionStatePair > * result,
                                                            shoot_spend_time,
                                                            ServerParam::i().theirTeamGoalPos() ) );
 
-    CooperativeAction::Ptr action( new Shoot( holder->unum(),
-                                              ServerParam::i().theirTeamGoalPos(),
-                                              ServerParam::i().ballSpeedMax(),
-                                              shoot_spend_time,
-                                              1,
-                                              "shoot" ) );
+    const ActionRecord action = ActionRecord::make_shoot( holder->unum(),
+                                                          ServerParam::i().theirTeamGoalPos(),
+                                                          ServerParam::i().ballSpeedMax(),
+                                                          shoot_spend_time,
+                                                          1,
+                                                          "shoot" );
 
     result->push_back( ActionStatePair( action, result_state ) );
 }
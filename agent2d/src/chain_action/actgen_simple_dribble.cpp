@@ -30,7 +30,7 @@
 
 #include "actgen_simple_dribble.h"
 
-#include "dribble.h"
+#include "action_record.h"
 #include "field_analyzer.h"
 
 #include "action_state_pair.h"
@@ -183,16 +183,16 @@ ActGen_SimpleDribble::generate( std::vector< ActionStatePair > * result,
                                                                    holder_reach_step,
                                                                    holder->unum(),
                                                                    target_point ) );
-            CooperativeAction::Ptr action( new Dribble( holder->unum(),
-                                                        target_point,
-                                                        ball_speed,
-                                                        1,
-                                                        1,
-                                                        holder_reach_step - 2,
-                                                        "actgenDribble" ) );
+            ActionRecord action = ActionRecord::make_dribble( holder->unum(),
+                                                              target_point,
+                                                              ball_speed,
+                                                              1,
+                                                              1,
+                                                              holder_reach_step - 2,
+                                                              "actgenDribble" );
             ++s_action_count;
             ++generated_count;
-            action->setIndex( s_action_count );
+            action.setIndex( s_action_count );
             result->push_back( ActionStatePair( action, result_state ) );
         }
     }
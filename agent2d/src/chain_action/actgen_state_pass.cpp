@@ -0,0 +1,288 @@
+// -*-c++-*-
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "actgen_state_pass.h"
+
+#include "action_record.h"
+#include "opponent_reach_table.h"
+#include "player_state_fusion.h"
+#include "ball_kinematics.h"
+
+#include "action_state_pair.h"
+#include "predict_state.h"
+
+#include <rcsc/common/logger.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/player_type.h>
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+// #define DEBUG_PRINT
+
+using namespace rcsc;
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the receive point is acceptable
+ */
+inline
+bool
+is_valid_receive_point( const PredictState & state,
+                        const AbstractPlayerObject & receiver,
+                        const Vector2D & receive_point )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    if ( receive_point.absX() > SP.pitchHalfLength() - 1.5
+         || receive_point.absY() > SP.pitchHalfWidth() - 1.5 )
+    {
+        return false;
+    }
+
+    if ( receive_point.x > state.offsideLineX() )
+    {
+        return false;
+    }
+
+    if ( receive_point.x < SP.ourPenaltyAreaLineX() + 3.0
+         && receive_point.absY() < SP.penaltyAreaHalfWidth() + 3.0 )
+    {
+        return false;
+    }
+
+    if ( receiver.goalie() )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ActGen_StatePass::generate( std::vector< ActionStatePair > * result,
+                            const PredictState & state,
+                            const WorldModel & wm,
+                            const std::vector< ActionStatePair > & path ) const
+{
+    static const int KICK_STEP = 2;
+    static const int MAX_BALL_STEP = 20;
+    static const double MIN_PASS_DIST = 4.0;
+    static const double MAX_PASS_DIST = 30.0;
+    static const double MIN_FIRST_BALL_SPEED = 1.5;
+    static const double LEADING_DIST = 3.0;
+    static const int LEADING_DIVS = 3;
+    static const double LEADING_ANGLE_STEP = 45.0;
+
+    static GameTime s_last_call_time( 0, 0 );
+    static int s_action_count = 0;
+
+    if ( wm.time() != s_last_call_time )
+    {
+        s_action_count = 0;
+        s_last_call_time = wm.time();
+    }
+
+    const AbstractPlayerObject * holder = state.ballHolder();
+    if ( ! holder )
+    {
+        return;
+    }
+
+    //
+    // the players who already kicked the ball in this chain are not receivers.
+    //
+    bool old_holder_table[11];
+    for ( int i = 0; i < 11; ++i )
+    {
+        old_holder_table[i] = false;
+    }
+
+    for ( std::vector< ActionStatePair >::const_iterator it = path.begin(), end = path.end();
+          it != end;
+          ++it )
+    {
+        const int unum = it->action().playerUnum();
+        if ( 1 <= unum && unum <= 11 )
+        {
+            old_holder_table[unum - 1] = true;
+        }
+    }
+
+    const ServerParam & SP = ServerParam::i();
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
+    const OpponentReachTable & opponent_table = OpponentReachTable::instance();
+
+    const Vector2D first_ball_pos = state.ball().pos();
+    const int elapsed_step = static_cast< int >( state.spendTime() ) + KICK_STEP - 1;
+    const double max_first_ball_speed = SP.ballSpeedMax();
+
+    int generated_count = 0;
+
+    for ( PredictPlayerPtrCont::const_iterator
+              it = state.ourPlayers().begin(),
+              end = state.ourPlayers().end();
+          it != end;
+          ++it )
+    {
+        const AbstractPlayerObject & receiver = **it;
+
+        if ( ! (*it)->isValid()
+             || receiver.unum() == Unum_Unknown
+             || receiver.unum() == state.ballHolderUnum()
+             || old_holder_table[receiver.unum() - 1]
+             || receiver.isGhost()
+             || receiver.isTackling()
+             || PlayerStateFusion::i().radius( receiver ) > PredictState::VALID_PLAYER_RADIUS )
+        {
+            continue;
+        }
+
+        if ( receiver.pos().x > state.offsideLineX() )
+        {
+            continue;
+        }
+
+        const double receiver_dist2 = receiver.pos().dist2( first_ball_pos );
+        if ( receiver_dist2 < std::pow( MIN_PASS_DIST, 2 )
+             || std::pow( MAX_PASS_DIST, 2 ) < receiver_dist2 )
+        {
+            continue;
+        }
+
+        const PlayerType * ptype = receiver.playerTypePtr();
+        const double max_receive_ball_speed
+            = ptype->kickableArea() + ( SP.maxDashPower()
+                                        * ptype->dashPowerRate()
+                                        * ptype->effortMax() ) * 1.5;
+        const AngleDeg goal_angle = ( SP.theirTeamGoalPos() - receiver.pos() ).th();
+
+        //
+        // receive point 0 is the direct pass. the others are the leading
+        // passes toward the opponent goal.
+        //
+        for ( int i = 0; i <= LEADING_DIVS; ++i )
+        {
+            const Vector2D receive_point
+                = ( i == 0
+                    ? receiver.pos()
+                    : receiver.pos()
+                    + Vector2D::from_polar( LEADING_DIST,
+                                            goal_angle + LEADING_ANGLE_STEP * ( i - 2 ) ) );
+
+            if ( ! is_valid_receive_point( state, receiver, receive_point ) )
+            {
+                continue;
+            }
+
+            const int receiver_step = ( i == 0
+                                        ? 0
+                                        : ptype->cyclesToReachDistance( LEADING_DIST ) + 1 );
+
+            const double ball_move_dist = first_ball_pos.dist( receive_point );
+            const AngleDeg ball_move_angle = ( receive_point - first_ball_pos ).th();
+
+            //
+            // select the fastest ball that the receiver can trap
+            //
+            int ball_step = std::max( 1, receiver_step );
+            double first_ball_speed = 0.0;
+            for ( ; ball_step <= MAX_BALL_STEP; ++ball_step )
+            {
+                first_ball_speed = ball_kinematics.firstSpeed( ball_move_dist, ball_step );
+                if ( first_ball_speed <= max_first_ball_speed
+                     && ball_kinematics.speedAfter( first_ball_speed, ball_step ) <= max_receive_ball_speed )
+                {
+                    break;
+                }
+            }
+
+            if ( ball_step > MAX_BALL_STEP
+                 || first_ball_speed < MIN_FIRST_BALL_SPEED )
+            {
+                continue;
+            }
+
+            const int opponent_step
+                = opponent_table.predictReachStep( first_ball_pos,
+                                                   Vector2D::from_polar( first_ball_speed,
+                                                                         ball_move_angle ),
+                                                   elapsed_step,
+                                                   ball_step,
+                                                   static_cast< const AbstractPlayerObject ** >( 0 ) );
+            if ( opponent_step <= ball_step )
+            {
+#ifdef DEBUG_PRINT
+                dlog.addText( Logger::ACTION_CHAIN,
+                              __FILE__": xxx %d -> %d (%.1f %.1f) step=%d opponent_step=%d",
+                              holder->unum(), receiver.unum(),
+                              receive_point.x, receive_point.y,
+                              ball_step, opponent_step );
+#endif
+                continue;
+            }
+
+            const int spend_time = ball_step + KICK_STEP;
+
+            ActionRecord action = ActionRecord::make_pass( holder->unum(),
+                                                           receiver.unum(),
+                                                           receive_point,
+                                                           first_ball_speed,
+                                                           spend_time,
+                                                           KICK_STEP,
+                                                           false,
+                                                           ( i == 0 ? "stateDirect" : "stateLead" ) );
+            ++s_action_count;
+            ++generated_count;
+            action.setIndex( s_action_count );
+
+            result->push_back( ActionStatePair( action,
+                                                new PredictState( state,
+                                                                  spend_time,
+                                                                  receiver.unum(),
+                                                                  receive_point ) ) );
+        }
+    }
+
+#ifdef DEBUG_PRINT
+    dlog.addText( Logger::ACTION_CHAIN,
+                  __FILE__": path=%d generated=%d total=%d",
+                  (int)path.size(), generated_count, s_action_count );
+#endif
+}
@@ -0,0 +1,52 @@
+// -*-c++-*-
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef ACTGEN_STATE_PASS_H
+#define ACTGEN_STATE_PASS_H
+
+#include "action_generator.h"
+
+/*!
+  \class ActGen_StatePass
+  \brief pass generator for the predicted states.
+
+  Unlike ActGen_StrictCheckPass, this generator works on PredictState and
+  checks the opponents by OpponentReachTable. It generates only a few
+  receive points for each receiver, so it can be used for the second or
+  later actions of the action chain.
+ */
+class ActGen_StatePass
+    : public ActionGenerator {
+
+public:
+    virtual
+    void generate( std::vector< ActionStatePair > * result,
+                   const PredictState & state,
+                   const rcsc::WorldModel & wm,
+                   const std::vector< ActionStatePair > & path ) const;
+};
+
+#endif
@@ -0,0 +1,157 @@
+// -*-c++-*-
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef ACTGEN_STATIC_PIPELINE_H
+#define ACTGEN_STATIC_PIPELINE_H
+
+#include "action_generator.h"
+#include "actgen_action_chain_length_filter.h"
+
+#include <vector>
+
+/*
+  Compile-time composed action generators.
+
+  CompositeActionGenerator and the ActGen_*ActionChainLengthFilter classes
+  hold their children by ActionGenerator::ConstPtr, so every generate()
+  call is a virtual call through a shared_ptr. The classes in this file
+  hold their children by value and call them by qualified names, so the
+  length checks are inlined and only the root generator is called
+  virtually from the action chain search.
+
+  Example:
+
+    typedef ActGen_StaticComposite<
+        ActGen_StaticRangeFilter< ActGen_Shoot, 2, ActGen_RangeActionChainLengthFilter::MAX >,
+        ActGen_StaticMaxFilter< ActGen_StrictCheckPass, 1 >
+        > MyActionGenerator;
+
+    ActionGenerator::ConstPtr g( new MyActionGenerator() );
+ */
+
+/*!
+  \class ActGen_Null
+  \brief empty generator used as the default template argument
+ */
+class ActGen_Null {
+public:
+    void generate( std::vector< ActionStatePair > *,
+                   const PredictState &,
+                   const rcsc::WorldModel &,
+                   const std::vector< ActionStatePair > & ) const
+      { }
+};
+
+/*!
+  \class ActGen_StaticRangeFilter
+  \brief static version of ActGen_RangeActionChainLengthFilter.
+  Generator is called if MIN_LENGTH <= (chain length) <= MAX_LENGTH.
+  ActGen_RangeActionChainLengthFilter::MAX can be used as MAX_LENGTH.
+ */
+template < typename Generator, int MIN_LENGTH, int MAX_LENGTH >
+class ActGen_StaticRangeFilter {
+private:
+    Generator M_generator;
+
+public:
+    void generate( std::vector< ActionStatePair > * result,
+                   const PredictState & state,
+                   const rcsc::WorldModel & wm,
+                   const std::vector< ActionStatePair > & path ) const
+      {
+          const int length = static_cast< int >( path.size() ) + 1;
+          if ( length >= MIN_LENGTH
+               && ( MAX_LENGTH == ActGen_RangeActionChainLengthFilter::MAX
+                    || length <= MAX_LENGTH ) )
+          {
+              M_generator.Generator::generate( result, state, wm, path );
+          }
+      }
+};
+
+/*!
+  \class ActGen_StaticMaxFilter
+  \brief static version of ActGen_MaxActionChainLengthFilter.
+ */
+template < typename Generator, int MAX_LENGTH >
+class ActGen_StaticMaxFilter
+    : public ActGen_StaticRangeFilter< Generator, 1, MAX_LENGTH > {
+};
+
+/*!
+  \class ActGen_StaticMinFilter
+  \brief static version of ActGen_MinActionChainLengthFilter.
+ */
+template < typename Generator, int MIN_LENGTH >
+class ActGen_StaticMinFilter
+    : public ActGen_StaticRangeFilter< Generator, MIN_LENGTH,
+                                       ActGen_RangeActionChainLengthFilter::MAX > {
+};
+
+/*!
+  \class ActGen_StaticComposite
+  \brief static version of CompositeActionGenerator.
+  The generators are called in the order of the template arguments.
+  Unused arguments are ActGen_Null and are removed by the compiler.
+ */
+template < typename G1,
+           typename G2 = ActGen_Null,
+           typename G3 = ActGen_Null,
+           typename G4 = ActGen_Null,
+           typename G5 = ActGen_Null,
+           typename G6 = ActGen_Null,
+           typename G7 = ActGen_Null,
+           typename G8 = ActGen_Null >
+class ActGen_StaticComposite
+    : public ActionGenerator {
+private:
+    G1 M_g1;
+    G2 M_g2;
+    G3 M_g3;
+    G4 M_g4;
+    G5 M_g5;
+    G6 M_g6;
+    G7 M_g7;
+    G8 M_g8;
+
+public:
+    void generate( std::vector< ActionStatePair > * result,
+                   const PredictState & state,
+                   const rcsc::WorldModel & wm,
+                   const std::vector< ActionStatePair > & path ) const
+      {
+          M_g1.G1::generate( result, state, wm, path );
+          M_g2.G2::generate( result, state, wm, path );
+          M_g3.G3::generate( result, state, wm, path );
+          M_g4.G4::generate( result, state, wm, path );
+          M_g5.G5::generate( result, state, wm, path );
+          M_g6.G6::generate( result, state, wm, path );
+          M_g7.G7::generate( result, state, wm, path );
+          M_g8.G8::generate( result, state, wm, path );
+      }
+};
+
+#endif
@@ -28,7 +28,7 @@
 
 #include "action_chain_graph.h"
 
-#include "hold_ball.h"
+#include "action_record.h"
 
 #include <rcsc/player/player_agent.h>
 #include <rcsc/common/server_param.h>
@@ -124,6 +124,7 @@ ActionChainGraph::ActionChainGraph( const FieldEvaluator::ConstPtr & evaluator,
       M_max_chain_length( max_chain_length ),
       M_max_evaluate_limit( max_evaluate_limit ),
       M_result(),
+      M_result_actions(),
       M_best_evaluation( -std::numeric_limits< double >::max() )
 {
 #ifdef DEBUG_PAINT_EVALUATED_POINTS
@@ -159,15 +160,27 @@ ActionChainGraph::calculateResult( const WorldModel & wm )
         const PredictState current_state( wm );
 
         PredictState::ConstPtr result_state( new PredictState( current_state, 1 ) );
-        CooperativeAction::Ptr action( new HoldBall( wm.self().unum(),
-                                                     wm.ball().pos(),
-                                                     1,
-                                                     "defaultHold" ) );
-        action->setFinalAction( true );
+        ActionRecord action = ActionRecord::make_hold( wm.self().unum(),
+                                                       wm.ball().pos(),
+                                                       1,
+                                                       "defaultHold" );
+        action.setFinalAction( true );
 
         M_result.push_back( ActionStatePair( action, result_state ) );
     }
 
+    //
+    // create the action objects only for the final chain
+    //
+    M_result_actions.clear();
+    M_result_actions.reserve( M_result.size() );
+    for ( std::vector< ActionStatePair >::const_iterator it = M_result.begin(), end = M_result.end();
+          it != end;
+          ++it )
+    {
+        M_result_actions.push_back( it->action().toAction() );
+    }
+
     write_chain_log( ">>>>> best chain: ",
                      wm,
                      M_best_chain_count,
@@ -609,7 +622,7 @@ ActionChainGraph::debug_send_chain( PlayerAgent * agent,
         std::string action_string = "?";
         std::string target_string = "";
 
-        const CooperativeAction & action = path[i].action();
+        const ActionRecord & action = path[i].action();
         const PredictState * s0;
         const PredictState * s1;
 
@@ -750,7 +763,7 @@ ActionChainGraph::write_chain_log( const std::string & pre_log_message,
 
     for ( size_t i = 0; i < path.size(); ++i )
     {
-        const CooperativeAction & a = path[i].action();
+        const ActionRecord & a = path[i].action();
         const PredictState * s0;
         const PredictState * s1;
 
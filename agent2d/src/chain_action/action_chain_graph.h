@@ -75,6 +75,7 @@ private:
 
 private:
     std::vector< ActionStatePair > M_result;
+    std::vector< boost::shared_ptr< CooperativeAction > > M_result_actions; //!< action objects of M_result
     double M_best_evaluation;
 
     void calculateResult( const rcsc::WorldModel & wm );
@@ -120,7 +121,7 @@ public:
 
     const CooperativeAction & getFirstAction() const
       {
-          return (*(M_result.begin())).action();
+          return *(*(M_result_actions.begin()));
       };
 
     const PredictState & getFirstState() const
@@ -0,0 +1,361 @@
+// -*-c++-*-
+
+/*!
+  \file action_record.cpp
+  \brief compact action record type Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "action_record.h"
+
+#include "pass.h"
+#include "dribble.h"
+#include "shoot.h"
+#include "clear_ball.h"
+#include "hold_ball.h"
+
+#include <boost/static_assert.hpp>
+
+#include <cstring>
+
+using namespace rcsc;
+
+BOOST_STATIC_ASSERT( sizeof( ActionRecord ) <= 48 );
+
+namespace {
+
+/*!
+  \brief descriptions of the actions created in this tree.
+  index 0 is used for NULL and for the strings not listed here. the
+  other entries have to be sorted by std::strcmp(). the table is never
+  modified, so it can be read from any thread without a lock.
+ */
+const char * const DESCRIPTIONS[] = {
+    "unknown",
+    "SelfPass",
+    "actgenDirect",
+    "actgenDribble",
+    "clear1",
+    "clearN",
+    "cross",
+    "defaultHold",
+    "nokickDribble",
+    "queuedDribble",
+    "shoot",
+    "shortDribble",
+    "stateDirect",
+    "stateLead",
+    "strictDirect",
+    "strictLead",
+    "strictThrough",
+};
+
+const int DESCRIPTION_SIZE = sizeof( DESCRIPTIONS ) / sizeof( DESCRIPTIONS[0] );
+
+BOOST_STATIC_ASSERT( DESCRIPTION_SIZE <= 256 );
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+unsigned char
+ActionRecord::description_id( const char * description )
+{
+    if ( ! description )
+    {
+        return 0;
+    }
+
+    // binary search, index 0 is excluded
+    int first = 1;
+    int last = DESCRIPTION_SIZE;
+    while ( first < last )
+    {
+        const int mid = ( first + last ) / 2;
+        const int cmp = std::strcmp( DESCRIPTIONS[mid], description );
+        if ( cmp == 0 )
+        {
+            return static_cast< unsigned char >( mid );
+        }
+
+        if ( cmp < 0 )
+        {
+            first = mid + 1;
+        }
+        else
+        {
+            last = mid;
+        }
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const char *
+ActionRecord::description() const
+{
+    return DESCRIPTIONS[description_id_];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ActionRecord
+ActionRecord::make( const CooperativeAction::ActionCategory category,
+                    const int player_unum,
+                    const Vector2D & target_point,
+                    const int duration_step,
+                    const char * description )
+{
+    ActionRecord r;
+    std::memset( &r, 0, sizeof( ActionRecord ) );
+
+    r.target_x_ = target_point.x;
+    r.target_y_ = target_point.y;
+    r.index_ = -1;
+    r.duration_step_ = static_cast< short >( duration_step );
+    r.category_ = static_cast< unsigned char >( category );
+    r.description_id_ = description_id( description );
+    r.player_unum_ = static_cast< signed char >( player_unum );
+    r.target_player_unum_ = static_cast< signed char >( player_unum );
+
+    return r;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ActionRecord
+ActionRecord::make_pass( const int passer,
+                         const int receiver,
+                         const Vector2D & receive_point,
+                         const double & ball_speed,
+                         const int duration_step,
+                         const int kick_count,
+                         const bool final_action,
+                         const char * description )
+{
+    ActionRecord r = make( CooperativeAction::Pass,
+                           passer, receive_point, duration_step, description );
+    r.target_player_unum_ = static_cast< signed char >( receiver );
+    r.first_ball_speed_ = ball_speed;
+    r.kick_count_ = static_cast< unsigned char >( kick_count );
+    r.final_action_ = ( final_action ? 1 : 0 );
+
+    return r;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ActionRecord
+ActionRecord::make_dribble( const int dribbler,
+                            const Vector2D & target_point,
+                            const double & ball_speed,
+                            const int kick_count,
+                            const int turn_count,
+                            const int dash_count,
+                            const char * description )
+{
+    ActionRecord r = make( CooperativeAction::Dribble,
+                           dribbler, target_point,
+                           kick_count + turn_count + dash_count,
+                           description );
+    r.first_ball_speed_ = ball_speed;
+    r.kick_count_ = static_cast< unsigned char >( kick_count );
+    r.turn_count_ = static_cast< unsigned char >( turn_count );
+    r.dash_count_ = static_cast< unsigned char >( dash_count );
+
+    return r;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ActionRecord
+ActionRecord::make_shoot( const int shooter,
+                          const Vector2D & target_point,
+                          const double & ball_speed,
+                          const int duration_step,
+                          const int kick_count,
+                          const char * description )
+{
+    ActionRecord r = make( CooperativeAction::Shoot,
+                           shooter, target_point, duration_step, description );
+    r.first_ball_speed_ = ball_speed;
+    r.kick_count_ = static_cast< unsigned char >( kick_count );
+    r.final_action_ = 1;
+
+    return r;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ActionRecord
+ActionRecord::make_hold( const int player,
+                         const Vector2D & target_point,
+                         const int duration_step,
+                         const char * description )
+{
+    ActionRecord r = make( CooperativeAction::Hold,
+                           player, target_point, duration_step, description );
+    r.kick_count_ = 1;
+
+    return r;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ActionRecord
+ActionRecord::from_action( const CooperativeAction & action )
+{
+    ActionRecord r = make( action.category(),
+                           action.playerUnum(),
+                           action.targetPoint(),
+                           action.durationStep(),
+                           action.description() );
+    r.index_ = action.index();
+    r.target_player_unum_ = static_cast< signed char >( action.targetPlayerUnum() );
+    r.first_ball_speed_ = action.firstBallSpeed();
+    r.kick_count_ = static_cast< unsigned char >( action.kickCount() );
+    r.turn_count_ = static_cast< unsigned char >( action.turnCount() );
+    r.dash_count_ = static_cast< unsigned char >( action.dashCount() );
+    r.final_action_ = ( action.isFinalAction() ? 1 : 0 );
+
+    switch ( action.category() ) {
+    case CooperativeAction::Dribble:
+    case CooperativeAction::Move:
+        r.payload_.dash_.first_dash_power_ = static_cast< float >( action.firstDashPower() );
+        r.payload_.dash_.first_dash_angle_ = static_cast< float >( action.firstDashAngle().degree() );
+        break;
+    case CooperativeAction::Hold:
+        r.payload_.turn_.first_turn_moment_ = static_cast< float >( action.firstTurnMoment() );
+        break;
+    default:
+        break;
+    }
+
+    return r;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CooperativeAction::Ptr
+ActionRecord::toAction() const
+{
+    const Vector2D target_point( target_x_, target_y_ );
+    const char * desc = description();
+
+    CooperativeAction::Ptr ptr;
+
+    switch ( category() ) {
+    case CooperativeAction::Pass:
+        ptr = CooperativeAction::Ptr( new Pass( player_unum_,
+                                                target_player_unum_,
+                                                target_point,
+                                                first_ball_speed_,
+                                                duration_step_,
+                                                kick_count_,
+                                                isFinalAction(),
+                                                desc ) );
+        break;
+    case CooperativeAction::Dribble:
+        ptr = CooperativeAction::Ptr( new Dribble( player_unum_,
+                                                   target_point,
+                                                   first_ball_speed_,
+                                                   kick_count_,
+                                                   turn_count_,
+                                                   dash_count_,
+                                                   desc ) );
+        ptr->setFirstDashPower( payload_.dash_.first_dash_power_ );
+        ptr->setFirstDashAngle( AngleDeg( payload_.dash_.first_dash_angle_ ) );
+        break;
+    case CooperativeAction::Shoot:
+        ptr = CooperativeAction::Ptr( new Shoot( player_unum_,
+                                                 target_point,
+                                                 first_ball_speed_,
+                                                 duration_step_,
+                                                 kick_count_,
+                                                 desc ) );
+        break;
+    case CooperativeAction::Clear:
+        ptr = CooperativeAction::Ptr( new ClearBall( player_unum_,
+                                                     target_point,
+                                                     first_ball_speed_,
+                                                     duration_step_,
+                                                     kick_count_,
+                                                     desc ) );
+        break;
+    case CooperativeAction::Hold:
+        ptr = CooperativeAction::Ptr( new HoldBall( player_unum_,
+                                                    target_point,
+                                                    duration_step_,
+                                                    desc ) );
+        ptr->setFirstTurnMoment( payload_.turn_.first_turn_moment_ );
+        break;
+    default:
+        // no dedicated class for Move
+        ptr = CooperativeAction::Ptr( new HoldBall( player_unum_,
+                                                    target_point,
+                                                    duration_step_,
+                                                    desc ) );
+        ptr->setCategory( category() );
+        if ( category() == CooperativeAction::Move )
+        {
+            ptr->setFirstDashPower( payload_.dash_.first_dash_power_ );
+            ptr->setFirstDashAngle( AngleDeg( payload_.dash_.first_dash_angle_ ) );
+        }
+        break;
+    }
+
+    ptr->setIndex( index_ );
+    ptr->setFirstBallSpeed( first_ball_speed_ );
+    ptr->setDurationStep( duration_step_ );
+    ptr->setKickCount( kick_count_ );
+    ptr->setTurnCount( turn_count_ );
+    ptr->setDashCount( dash_count_ );
+    ptr->setFinalAction( isFinalAction() );
+
+    return ptr;
+}
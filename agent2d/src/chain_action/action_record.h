@@ -0,0 +1,172 @@
+// -*-c++-*-
+
+/*!
+  \file action_record.h
+  \brief compact action record type Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef ACTION_RECORD_H
+#define ACTION_RECORD_H
+
+#include "cooperative_action.h"
+
+#include <rcsc/geom/vector_2d.h>
+
+/*!
+  \struct ActionRecord
+  \brief trivially copyable action record used during the chain search.
+
+  The record is a 48 bytes POD. It has no vtable and no heap object, so
+  the candidates and the paths can keep it inline in contiguous buffers.
+  The description is held as an index of the static description table.
+  CooperativeAction objects are created only for the final chain by
+  toAction().
+ */
+struct ActionRecord {
+
+    double target_x_; //!< action end point
+    double target_y_; //!< action end point
+    double first_ball_speed_; //!< first ball speed (if necessary)
+
+    int index_;
+    short duration_step_; //!< action duration period
+    unsigned char category_; //!< CooperativeAction::ActionCategory
+    unsigned char description_id_; //!< index of the description table
+
+    signed char player_unum_; //!< acting player's uniform number
+    signed char target_player_unum_; //!< action target player's uniform number
+    unsigned char kick_count_; //!< kick count (if necessary)
+    unsigned char turn_count_; //!< turn count (if necessary)
+    unsigned char dash_count_; //!< dash count (if necessary)
+    unsigned char final_action_; //!< non zero if this is the final action
+
+    /*!
+      \brief category specific values. the arm is selected by category_.
+     */
+    union {
+        struct {
+            float first_dash_power_;
+            float first_dash_angle_; //!< relative to body [deg]
+        } dash_; //!< Dribble, Move
+        struct {
+            float first_turn_moment_;
+        } turn_; //!< Hold
+    } payload_;
+
+    //
+    // factories
+    //
+
+    static
+    ActionRecord make( const CooperativeAction::ActionCategory category,
+                       const int player_unum,
+                       const rcsc::Vector2D & target_point,
+                       const int duration_step,
+                       const char * description );
+
+    static
+    ActionRecord make_pass( const int passer,
+                            const int receiver,
+                            const rcsc::Vector2D & receive_point,
+                            const double & ball_speed,
+                            const int duration_step,
+                            const int kick_count,
+                            const bool final_action,
+                            const char * description );
+
+    static
+    ActionRecord make_dribble( const int dribbler,
+                               const rcsc::Vector2D & target_point,
+                               const double & ball_speed,
+                               const int kick_count,
+                               const int turn_count,
+                               const int dash_count,
+                               const char * description );
+
+    static
+    ActionRecord make_shoot( const int shooter,
+                             const rcsc::Vector2D & target_point,
+                             const double & ball_speed,
+                             const int duration_step,
+                             const int kick_count,
+                             const char * description );
+
+    static
+    ActionRecord make_hold( const int player,
+                            const rcsc::Vector2D & target_point,
+                            const int duration_step,
+                            const char * description );
+
+    /*!
+      \brief copy all values of the existing action object.
+      \param action source action
+      \return converted record
+     */
+    static
+    ActionRecord from_action( const CooperativeAction & action );
+
+    /*!
+      \brief create the action object that has the same values.
+      \return new action object
+     */
+    CooperativeAction::Ptr toAction() const;
+
+    /*!
+      \brief get the index of the description table.
+      \param description literal string
+      \return the table index. 0 ("unknown") if the string is NULL or is
+      not listed in the table. a new description has to be added to the
+      table in action_record.cpp.
+     */
+    static
+    unsigned char description_id( const char * description );
+
+    //
+    // accessors compatible with CooperativeAction
+    //
+
+    void setIndex( const int i ) { index_ = i; }
+    void setFinalAction( const bool on ) { final_action_ = ( on ? 1 : 0 ); }
+
+    CooperativeAction::ActionCategory category() const
+      {
+          return static_cast< CooperativeAction::ActionCategory >( category_ );
+      }
+    int index() const { return index_; }
+    const char * description() const;
+    int playerUnum() const { return player_unum_; }
+    int targetPlayerUnum() const { return target_player_unum_; }
+    rcsc::Vector2D targetPoint() const { return rcsc::Vector2D( target_x_, target_y_ ); }
+    const double & firstBallSpeed() const { return first_ball_speed_; }
+    int durationStep() const { return duration_step_; }
+    int kickCount() const { return kick_count_; }
+    int turnCount() const { return turn_count_; }
+    int dashCount() const { return dash_count_; }
+    bool isFinalAction() const { return final_action_ != 0; }
+};
+
+#endif
@@ -27,21 +27,23 @@
 #ifndef RCSC_PLAYER_ACTION_STATE_PAIR_H
 #define RCSC_PLAYER_ACTION_STATE_PAIR_H
 
+#include "action_record.h"
 #include "predict_state.h"
 
 #include <boost/shared_ptr.hpp>
 
 #include <vector>
 
-class CooperativeAction;
-
 /*!
   \class ActionStatePair
   \brief a pair of a cooperative action and predicted state when this action performed
+
+  The action is held inline as ActionRecord, so the candidate and path
+  vectors of the chain search do not refer to any action object on the heap.
 */
 class ActionStatePair {
 public:
-    boost::shared_ptr< const CooperativeAction > M_action;
+    ActionRecord M_action;
     boost::shared_ptr< const PredictState > M_state;
 
     // not used
@@ -73,33 +75,33 @@ public:
           return *this;
       }
 
-    ActionStatePair( const CooperativeAction * action,
+    ActionStatePair( const ActionRecord & action,
                      const PredictState * state )
         : M_action( action ),
           M_state( state )
       { }
 
-    ActionStatePair( const boost::shared_ptr< const CooperativeAction > & action,
-                     const PredictState * state )
+    ActionStatePair( const ActionRecord & action,
+                     const boost::shared_ptr< const PredictState > & state )
         : M_action( action ),
           M_state( state )
       { }
 
-    ActionStatePair( const CooperativeAction * action,
-                     const boost::shared_ptr< const PredictState > & state )
-        : M_action( action ),
+    ActionStatePair( const boost::shared_ptr< const CooperativeAction > & action,
+                     const PredictState * state )
+        : M_action( ActionRecord::from_action( *action ) ),
           M_state( state )
       { }
 
     ActionStatePair( const boost::shared_ptr< const CooperativeAction > & action,
                      const boost::shared_ptr< const PredictState > & state )
-        : M_action( action ),
+        : M_action( ActionRecord::from_action( *action ) ),
           M_state( state )
       { }
 
-    const CooperativeAction & action() const
+    const ActionRecord & action() const
       {
-          return *M_action;
+          return M_action;
       }
 
     const PredictState & state() const
@@ -107,11 +109,6 @@ public:
           return *M_state;
       }
 
-    const boost::shared_ptr< const CooperativeAction > & actionPtr() const
-      {
-          return M_action;
-      }
-
     const boost::shared_ptr< const PredictState > & statePtr() const
       {
           return M_state;
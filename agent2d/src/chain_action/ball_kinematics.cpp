@@ -0,0 +1,181 @@
+// -*-c++-*-
+
+/*!
+  \file ball_kinematics.cpp
+  \brief precomputed ball movement tables Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "ball_kinematics.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/common/server_param.h>
+
+#include <cmath>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+BallKinematics::BallKinematics()
+    : M_update_time( -1, 0 )
+{
+    M_ball_trajectory.reserve( MAX_STEP + 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+BallKinematics &
+BallKinematics::instance()
+{
+    static BallKinematics s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+BallKinematics::createTables()
+{
+    const double ball_decay = ServerParam::i().ballDecay();
+
+    if ( ball_decay <= 0.0
+         || 1.0 <= ball_decay )
+    {
+        return false;
+    }
+
+    M_decay_power.resize( MAX_STEP + 1 );
+    M_move_rate.resize( MAX_STEP + 1 );
+
+    M_decay_power[0] = 1.0;
+    M_move_rate[0] = 0.0;
+    for ( int n = 1; n <= MAX_STEP; ++n )
+    {
+        M_decay_power[n] = M_decay_power[n-1] * ball_decay;
+        M_move_rate[n] = M_move_rate[n-1] + M_decay_power[n-1];
+    }
+
+    M_update_time.assign( -1, 0 );
+    M_ball_trajectory.clear();
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+BallKinematics::decayPower( const int n_step ) const
+{
+    if ( 0 <= n_step && n_step <= MAX_STEP
+         && ! M_decay_power.empty() )
+    {
+        return M_decay_power[n_step];
+    }
+
+    return std::pow( ServerParam::i().ballDecay(), n_step );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+BallKinematics::moveRate( const int n_step ) const
+{
+    if ( 0 <= n_step && n_step <= MAX_STEP
+         && ! M_move_rate.empty() )
+    {
+        return M_move_rate[n_step];
+    }
+
+    const double ball_decay = ServerParam::i().ballDecay();
+    return ( 1.0 - std::pow( ball_decay, n_step ) ) / ( 1.0 - ball_decay );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+BallKinematics::update( const WorldModel & wm )
+{
+    if ( M_update_time == wm.time() )
+    {
+        return;
+    }
+    M_update_time = wm.time();
+
+    createTrajectory( wm.ball().pos(), wm.ball().vel(), MAX_STEP, M_ball_trajectory );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+BallKinematics::createTrajectory( const Vector2D & first_pos,
+                                  const Vector2D & first_vel,
+                                  const int max_step,
+                                  std::vector< Vector2D > & result ) const
+{
+    result.resize( max_step + 1 );
+
+    for ( int n = 0; n <= max_step; ++n )
+    {
+        result[n] = first_pos + first_vel * moveRate( n );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2D
+BallKinematics::ballInertiaPoint( const WorldModel & wm,
+                                  const int n_step )
+{
+    update( wm );
+
+    if ( 0 <= n_step && n_step <= MAX_STEP )
+    {
+        return M_ball_trajectory[n_step];
+    }
+
+    return wm.ball().inertiaPoint( n_step );
+}
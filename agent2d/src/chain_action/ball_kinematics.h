@@ -0,0 +1,176 @@
+// -*-c++-*-
+
+/*!
+  \file ball_kinematics.h
+  \brief precomputed ball movement tables Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef BALL_KINEMATICS_H
+#define BALL_KINEMATICS_H
+
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/game_time.h>
+
+#include <vector>
+
+namespace rcsc {
+class WorldModel;
+}
+
+/*!
+  \class BallKinematics
+  \brief ball movement service based on the precomputed decay tables.
+
+  The tables are created when server_param message is received, and the
+  trajectory of the current ball is cached once in each cycle. The ball
+  movement is calculated by table lookup and multiply-add instead of pow().
+ */
+class BallKinematics {
+public:
+
+    //! size of the tables
+    static const int MAX_STEP = 128;
+
+private:
+
+    std::vector< double > M_decay_power; //!< decay^n
+    std::vector< double > M_move_rate; //!< (1 - decay^n) / (1 - decay)
+
+    rcsc::GameTime M_update_time; //!< last update time of the ball trajectory
+    std::vector< rcsc::Vector2D > M_ball_trajectory; //!< current ball position after n steps
+
+    // private for singleton
+    BallKinematics();
+
+    // not used
+    BallKinematics( const BallKinematics & );
+    BallKinematics & operator=( const BallKinematics & );
+
+public:
+
+    static
+    BallKinematics & instance();
+
+    /*!
+      \brief create decay tables using the current ServerParam.
+      \return result status
+     */
+    bool createTables();
+
+    /*!
+      \brief update the trajectory cache of the current ball.
+      \param wm world model
+     */
+    void update( const rcsc::WorldModel & wm );
+
+    /*!
+      \brief get decay^n
+      \param n_step number of steps
+      \return decay power
+     */
+    double decayPower( const int n_step ) const;
+
+    /*!
+      \brief get the sum of the geometric series of the decay.
+      \param n_step number of steps
+      \return move distance rate to be multiplied to the first speed
+     */
+    double moveRate( const int n_step ) const;
+
+    /*!
+      \brief get the ball position after n steps
+      \param first_pos first ball position
+      \param first_vel first ball velocity
+      \param n_step number of steps
+      \return estimated ball position
+     */
+    rcsc::Vector2D inertiaPoint( const rcsc::Vector2D & first_pos,
+                                 const rcsc::Vector2D & first_vel,
+                                 const int n_step ) const
+      {
+          return first_pos + first_vel * moveRate( n_step );
+      }
+
+    /*!
+      \brief get the ball move distance after n steps
+      \param first_speed first ball speed
+      \param n_step number of steps
+      \return ball move distance
+     */
+    double inertiaDistance( const double & first_speed,
+                            const int n_step ) const
+      {
+          return first_speed * moveRate( n_step );
+      }
+
+    /*!
+      \brief get the first speed to move the ball by the distance in n steps
+      \param move_dist ball move distance
+      \param n_step number of steps (> 0)
+      \return first ball speed
+     */
+    double firstSpeed( const double & move_dist,
+                       const int n_step ) const
+      {
+          return move_dist / moveRate( n_step );
+      }
+
+    /*!
+      \brief get the ball speed after n steps
+      \param first_speed first ball speed
+      \param n_step number of steps
+      \return ball speed
+     */
+    double speedAfter( const double & first_speed,
+                       const int n_step ) const
+      {
+          return first_speed * decayPower( n_step );
+      }
+
+    /*!
+      \brief create the trajectory for the candidate kick velocity.
+      \param first_pos first ball position
+      \param first_vel first ball velocity
+      \param max_step the last step of the trajectory
+      \param result reference to the result variable. index is the step.
+     */
+    void createTrajectory( const rcsc::Vector2D & first_pos,
+                           const rcsc::Vector2D & first_vel,
+                           const int max_step,
+                           std::vector< rcsc::Vector2D > & result ) const;
+
+    /*!
+      \brief get the current ball position after n steps from the cache.
+      \param wm world model
+      \param n_step number of steps
+      \return estimated ball position
+     */
+    rcsc::Vector2D ballInertiaPoint( const rcsc::WorldModel & wm,
+                                     const int n_step );
+};
+
+#endif
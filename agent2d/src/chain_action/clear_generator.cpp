@@ -35,6 +35,7 @@
 
 #include "clear_generator.h"
 
+#include "ball_kinematics.h"
 #include "field_analyzer.h"
 #include "clear_ball.h"
 
@@ -44,6 +45,7 @@
 #include <rcsc/common/logger.h>
 #include <rcsc/timer.h>
 
+#include <algorithm>
 #include <limits>
 #include <cmath>
 
@@ -54,6 +56,13 @@
 
 using namespace rcsc;
 
+namespace {
+
+//! max simulation cycle. this value is also used as the initial opponent step.
+const int MAX_CYCLE = 50;
+
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -121,12 +130,15 @@ ClearGenerator::generate( const WorldModel & wm )
     Timer timer;
 #endif
 
+    M_budget.start();
+
     createCourses( wm );
 
 #ifdef DEBUG_PROFILE
     dlog.addText( Logger::CLEAR,
-                  __FILE__": (generate) PROFILE total_count=%d elapsed %.3f [ms]",
+                  __FILE__": (generate) PROFILE total_count=%d%s elapsed %.3f [ms]",
                   M_total_count,
+                  ( M_budget.truncated() ? " (truncated)" : "" ),
                   timer.elapsedReal() );
 #endif
 }
@@ -138,30 +150,14 @@ ClearGenerator::generate( const WorldModel & wm )
 void
 ClearGenerator::createCourses( const WorldModel & wm )
 {
-    static const double SPEED_STEP = 0.3;
-    static const double MIN_FIRST_SPEED
-        = std::min( ServerParam::i().ballSpeedMax() - SPEED_STEP*5,
-                    ServerParam::i().defaultPlayerSpeedMax() + 0.5 );
-
-    const ServerParam & SP = ServerParam::i();
-    const Vector2D left_back_corner( -SP.pitchHalfLength(),
-                                     -SP.pitchHalfWidth() );
-    const Vector2D right_back_corner( -SP.pitchHalfLength(),
-                                      +SP.pitchHalfWidth() );
-
-    const double min_angle = std::max( -110.0,
-                                       ( left_back_corner - wm.ball().pos() ).th().degree() );
-    const double max_angle = std::min( +110.0,
-                                       ( right_back_corner - wm.ball().pos() ).th().degree() );
+    //
+    // create all candidates, then check them in blocks of angles.
+    // the budget is checked between the blocks, so the opponent checks
+    // of an evaluated candidate are never cut.
+    //
+    createCandidates( wm );
 
-    const double angle_step = std::max( 1.0,
-                                        ( max_angle - min_angle ) / 90 );
-
-#ifdef DEBUG_PRINT
-    dlog.addText( Logger::CLEAR,
-                  "Clear: minAngle=%.1f maxAngle=%.1f angleStep=%.2f",
-                  min_angle, max_angle, angle_step );
-#endif
+    const int evaluated_size = evaluateCandidates( wm, wm.ball().pos() );
 
     int one_kick_max_opponent_reach_step = 0;
     double one_kick_best_speed = -1.0;
@@ -172,110 +168,65 @@ ClearGenerator::createCourses( const WorldModel & wm )
     AngleDeg best_angle = 0.0;
     int best_kick_count = 0;
 
-    for ( double a = min_angle; a < max_angle + 0.001; a += angle_step )
-    {
-        const AngleDeg target_angle = a;
-#ifdef DEBUG_PRINT
-        dlog.addText( Logger::CLEAR,
-                      "===== Clear: angle=%.1f ===== ",
-                      target_angle.degree() );
-#endif
-        //
-        // check accuracy of clear angle
-        //
-#if 0
-        {
-            int dir_max_count = 0;
-            wm.dirRangeCount( target_angle,
-                              30.0, // Magic Number
-                              &dir_max_count, NULL, NULL );
-#ifdef DEBUG_PRINT
-            dlog.addText( Logger::CLEAR,
-                          "Clear: angle=%.1f dirMaxCount=%d",
-                          target_angle.degree(), dir_max_count );
-#endif
-            if ( dir_max_count >= 20 )
-            {
-                continue;
-            }
-        }
-#endif
-
-        const Vector2D one_step_kick_max_vel
-            = KickTable::calc_max_velocity( target_angle,
-                                            wm.self().kickRate(),
-                                            wm.ball().vel() );
-        double ball_speed = one_step_kick_max_vel.r();
-        int kick_count = 1;
+    //
+    // the candidates are stored in the center-first order.
+    // the ties are broken by the angle order of the sweep from min_angle,
+    // so the selection does not depend on the evaluation order.
+    //
+    int best_index = -1;
+    int one_kick_best_index = -1;
 
-        if ( ball_speed < MIN_FIRST_SPEED )
+    for ( int i = 0; i < evaluated_size; ++i )
+    {
+        const AngleDeg & target_angle = M_angles[M_angle_index[i]];
+        const double ball_speed = M_speed[i];
+        const int kick_count = M_kick_count[i];
+        const int opponent_reach_step = ( M_out_of_pitch_step[i] > 0
+                                          ? 1000 + M_out_of_pitch_step[i]
+                                          : M_min_step[i] );
+
+        if ( opponent_reach_step > max_opponent_reach_step
+             || ( best_index >= 0
+                  && opponent_reach_step == max_opponent_reach_step
+                  && isPrior( i, best_index ) ) )
         {
-            ball_speed = MIN_FIRST_SPEED;
-            kick_count = 2;
+            best_index = i;
+            max_opponent_reach_step = opponent_reach_step;
+            best_speed = ball_speed;
+            best_angle = target_angle;
+            best_kick_count = kick_count;
         }
 
-        bool loop = true;
-        ball_speed -= SPEED_STEP;
-        while ( loop )
+        if ( kick_count == 1 )
         {
-            ++M_total_count;
-
-            ball_speed += SPEED_STEP;
-            if ( ball_speed > SP.ballSpeedMax() )
-            {
-                loop = false;
-                ball_speed = SP.ballSpeedMax();
-            }
-
-            int opponent_reach_step = predictOpponentsReachStep( wm,
-                                                                 wm.ball().pos(),
-                                                                 ball_speed,
-                                                                 target_angle );
-            if ( opponent_reach_step > max_opponent_reach_step )
+            if ( opponent_reach_step > one_kick_max_opponent_reach_step
+                 || ( one_kick_best_index >= 0
+                      && opponent_reach_step == one_kick_max_opponent_reach_step
+                      && isPrior( i, one_kick_best_index ) ) )
             {
-                max_opponent_reach_step = opponent_reach_step;
-                best_speed = ball_speed;
-                best_angle = target_angle;
-                best_kick_count = kick_count;
-            }
-
-            if ( kick_count == 1 )
-            {
-                if ( opponent_reach_step > one_kick_max_opponent_reach_step )
-                {
-                    one_kick_max_opponent_reach_step = opponent_reach_step;
-                    one_kick_best_speed = ball_speed;
-                    one_kick_best_angle = target_angle;
-                }
+                one_kick_best_index = i;
+                one_kick_max_opponent_reach_step = opponent_reach_step;
+                one_kick_best_speed = ball_speed;
+                one_kick_best_angle = target_angle;
             }
+        }
 
 #ifdef DEBUG_PRINT
-            dlog.addText( Logger::CLEAR,
-                          "%d Clear: angle=%.1f speed=%.2f nKick=%d opponentStep=%d",
-                          M_total_count,
-                          target_angle.degree(),
-                          ball_speed,
-                          kick_count,
-                          opponent_reach_step );
+        dlog.addText( Logger::CLEAR,
+                      "%d Clear: angle=%.1f speed=%.2f nKick=%d opponentStep=%d",
+                      i + 1,
+                      target_angle.degree(),
+                      ball_speed,
+                      kick_count,
+                      opponent_reach_step );
 #endif
-
-            if ( wm.gameMode().type() != GameMode::PlayOn )
-            {
-                break;
-            }
-
-            kick_count = 2;
-            if ( ball_speed > 2.5 ) kick_count = 3;
-        }
     }
 
-
     if ( best_speed > 0.0 )
     {
         {
-            double move_dist = inertia_n_step_distance( best_speed,
-                                                        max_opponent_reach_step,
-                                                        SP.ballDecay() );
+            double move_dist = BallKinematics::instance().inertiaDistance( best_speed,
+                                                                           max_opponent_reach_step );
             Vector2D target_point
                 = wm.ball().pos()
                 + Vector2D::from_polar( move_dist, best_angle );
@@ -305,9 +256,8 @@ ClearGenerator::createCourses( const WorldModel & wm )
 
         if ( best_kick_count > 1 )
         {
-            double move_dist = inertia_n_step_distance( one_kick_best_speed,
-                                                        one_kick_max_opponent_reach_step,
-                                                        SP.ballDecay() );
+            double move_dist = BallKinematics::instance().inertiaDistance( one_kick_best_speed,
+                                                                           one_kick_max_opponent_reach_step );
             Vector2D target_point
                 = wm.ball().pos()
                 + Vector2D::from_polar( move_dist, one_kick_best_angle );
@@ -340,22 +290,106 @@ ClearGenerator::createCourses( const WorldModel & wm )
 /*!
 
  */
-namespace {
+void
+ClearGenerator::createCandidates( const WorldModel & wm )
+{
+    static const double SPEED_STEP = 0.3;
+    static const double MIN_FIRST_SPEED
+        = std::min( ServerParam::i().ballSpeedMax() - SPEED_STEP*5,
+                    ServerParam::i().defaultPlayerSpeedMax() + 0.5 );
 
-struct OpponentAngleCompare {
-    const AngleDeg ball_move_angle_;
-    OpponentAngleCompare( const AngleDeg & angle )
-        : ball_move_angle_( angle )
-      { }
+    const ServerParam & SP = ServerParam::i();
+    const Vector2D left_back_corner( -SP.pitchHalfLength(),
+                                     -SP.pitchHalfWidth() );
+    const Vector2D right_back_corner( -SP.pitchHalfLength(),
+                                      +SP.pitchHalfWidth() );
 
-    bool operator()( const AbstractPlayerObject * lhs,
-                     const AbstractPlayerObject * rhs ) const
-      {
-          return ( lhs->angleFromBall() - ball_move_angle_ ).abs()
-              < ( rhs->angleFromBall() - ball_move_angle_ ).abs();
-      }
-};
+    const double min_angle = std::max( -110.0,
+                                       ( left_back_corner - wm.ball().pos() ).th().degree() );
+    const double max_angle = std::min( +110.0,
+                                       ( right_back_corner - wm.ball().pos() ).th().degree() );
 
+    const double angle_step = std::max( 1.0,
+                                        ( max_angle - min_angle ) / 90 );
+
+#ifdef DEBUG_PRINT
+    dlog.addText( Logger::CLEAR,
+                  "Clear: minAngle=%.1f maxAngle=%.1f angleStep=%.2f",
+                  min_angle, max_angle, angle_step );
+#endif
+
+    M_angles.clear();
+    M_angle_order.clear();
+    M_angle_begin.clear();
+    M_angle_index.clear();
+    M_speed.clear();
+    M_kick_count.clear();
+
+    //
+    // the angles near the forward direction are tried first.
+    //
+    const int angle_divs = static_cast< int >( std::floor( ( max_angle - min_angle + 0.001 )
+                                                           / angle_step ) ) + 1;
+    const int center_index = std::min( angle_divs - 1,
+                                       std::max( 0,
+                                                 static_cast< int >( std::floor( -min_angle / angle_step + 0.5 ) ) ) );
+
+    for ( int i = 0; i < angle_divs * 2; ++i )
+    {
+        const int a_index = center_index + GeneratorBudget::alternate_offset( i );
+        if ( a_index < 0
+             || angle_divs <= a_index )
+        {
+            continue;
+        }
+
+        const AngleDeg target_angle = min_angle + angle_step * a_index;
+        const int angle_index = M_angles.size();
+        M_angles.push_back( target_angle );
+        M_angle_order.push_back( a_index );
+        M_angle_begin.push_back( M_speed.size() );
+
+        const Vector2D one_step_kick_max_vel
+            = KickTable::calc_max_velocity( target_angle,
+                                            wm.self().kickRate(),
+                                            wm.ball().vel() );
+        double ball_speed = one_step_kick_max_vel.r();
+        int kick_count = 1;
+
+        if ( ball_speed < MIN_FIRST_SPEED )
+        {
+            ball_speed = MIN_FIRST_SPEED;
+            kick_count = 2;
+        }
+
+        bool loop = true;
+        ball_speed -= SPEED_STEP;
+        while ( loop )
+        {
+            ++M_total_count;
+
+            ball_speed += SPEED_STEP;
+            if ( ball_speed > SP.ballSpeedMax() )
+            {
+                loop = false;
+                ball_speed = SP.ballSpeedMax();
+            }
+
+            M_angle_index.push_back( angle_index );
+            M_speed.push_back( ball_speed );
+            M_kick_count.push_back( kick_count );
+
+            if ( wm.gameMode().type() != GameMode::PlayOn )
+            {
+                break;
+            }
+
+            kick_count = 2;
+            if ( ball_speed > 2.5 ) kick_count = 3;
+        }
+    }
+
+    M_angle_begin.push_back( M_speed.size() );
 }
 
 /*-------------------------------------------------------------------*/
@@ -363,55 +397,210 @@ struct OpponentAngleCompare {
 
  */
 int
-ClearGenerator::predictOpponentsReachStep( const WorldModel & wm,
-                                           const Vector2D & first_ball_pos,
-                                           const double & first_ball_speed,
-                                           const AngleDeg & ball_move_angle )
+ClearGenerator::evaluateCandidates( const WorldModel & wm,
+                                    const Vector2D & first_ball_pos )
 {
-    // AbstractPlayerCont opponents = wm.allOpponents();
-    // std::sort( opponents.begin(), opponents.end(),
-    //            OpponentAngleCompare( ball_move_angle ) );
+    static const int ANGLE_BLOCK = 8;
 
+    const int size = M_speed.size();
+    const int angle_size = M_angles.size();
 
-    const Vector2D first_ball_vel = Vector2D::from_polar( first_ball_speed, ball_move_angle );
+    if ( size == 0 )
+    {
+        return 0;
+    }
 
-    int min_step = 50;
-    int out_of_pitch_step = -1;
+    M_ball_x.resize( ( MAX_CYCLE + 1 ) * size );
+    M_ball_y.resize( ( MAX_CYCLE + 1 ) * size );
+    M_dist.resize( ( MAX_CYCLE + 1 ) * size );
+    M_min_step.assign( size, MAX_CYCLE );
+    M_out_of_pitch_step.assign( size, -1 );
 
-    for ( AbstractPlayerCont::const_iterator
-              o = wm.theirPlayers().begin(),
-              end = wm.theirPlayers().end();
-          o != end;
-          ++o )
+    int first_angle = 0;
+    while ( first_angle < angle_size )
     {
-        int step = predictOpponentReachStep( *o,
-                                             first_ball_pos,
-                                             first_ball_vel,
-                                             ball_move_angle,
-                                             min_step );
-        if ( step > 1000 )
+        int last_angle = first_angle;
+        while ( last_angle < angle_size
+                && last_angle < first_angle + ANGLE_BLOCK )
         {
-            out_of_pitch_step = step - 1000;
-            if ( out_of_pitch_step < min_step )
+            if ( ! M_budget.consume() )
             {
-                min_step = out_of_pitch_step;
+                break;
             }
+            ++last_angle;
         }
-        else if ( step < min_step )
+
+        if ( last_angle > first_angle )
         {
-            out_of_pitch_step = -1;
-            min_step = step;
+            const int begin = M_angle_begin[first_angle];
+            const int end = M_angle_begin[last_angle];
+
+            createBallTrajectories( first_ball_pos, begin, end );
+            predictOpponentsReachStep( wm, first_ball_pos, begin, end );
         }
+
+        if ( M_budget.truncated() )
+        {
+            dlog.addText( Logger::CLEAR,
+                          __FILE__": (evaluateCandidates) truncated by budget. angles=%d/%d elapsed %.3f [ms]",
+                          last_angle, angle_size, M_budget.elapsed() );
+            return M_angle_begin[last_angle];
+        }
+
+        first_angle = last_angle;
+    }
+
+    return size;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ClearGenerator::createBallTrajectories( const Vector2D & first_ball_pos,
+                                        const int begin,
+                                        const int end )
+{
+    const double ball_decay = ServerParam::i().ballDecay();
+    const int size = M_speed.size();
+
+    std::vector< double > vel_x( size );
+    std::vector< double > vel_y( size );
+
+    for ( int i = begin; i < end; ++i )
+    {
+        const Vector2D vel = Vector2D::from_polar( M_speed[i], M_angles[M_angle_index[i]] );
+        vel_x[i] = vel.x;
+        vel_y[i] = vel.y;
+        M_ball_x[i] = first_ball_pos.x;
+        M_ball_y[i] = first_ball_pos.y;
     }
 
-    if ( out_of_pitch_step > 0 )
+    //
+    // all candidates are updated in the same cycle.
+    // the inner loop has no dependency between candidates.
+    //
+    for ( int cycle = 1; cycle <= MAX_CYCLE; ++cycle )
     {
-        return 1000 + out_of_pitch_step;
+        const double * prev_x = &M_ball_x[( cycle - 1 ) * size];
+        const double * prev_y = &M_ball_y[( cycle - 1 ) * size];
+        double * x = &M_ball_x[cycle * size];
+        double * y = &M_ball_y[cycle * size];
+
+        for ( int i = begin; i < end; ++i )
+        {
+            x[i] = prev_x[i] + vel_x[i];
+            y[i] = prev_y[i] + vel_y[i];
+            vel_x[i] *= ball_decay;
+            vel_y[i] *= ball_decay;
+        }
     }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
 
-    return min_step;
+ */
+void
+ClearGenerator::predictOpponentsReachStep( const WorldModel & wm,
+                                           const Vector2D & first_ball_pos,
+                                           const int begin,
+                                           const int end )
+{
+    for ( AbstractPlayerCont::const_iterator
+              o = wm.theirPlayers().begin(),
+              o_end = wm.theirPlayers().end();
+          o != o_end;
+          ++o )
+    {
+        predictOpponentReachStep( *o, first_ball_pos, begin, end );
+    }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ClearGenerator::predictOpponentReachStep( const AbstractPlayerObject * opponent,
+                                          const Vector2D & first_ball_pos,
+                                          const int begin,
+                                          const int end )
+{
+    const PlayerType * ptype = opponent->playerTypePtr();
+    const int size = M_speed.size();
+
+    //
+    // estimate the min reach cycle for each angle
+    //
+    M_opponent_min_cycle.resize( M_angles.size() );
+    for ( int a = M_angle_index[begin]; a <= M_angle_index[end - 1]; ++a )
+    {
+        int min_cycle = FieldAnalyzer::estimate_min_reach_cycle( opponent->pos(),
+                                                                 ptype->realSpeedMax(),
+                                                                 first_ball_pos,
+                                                                 M_angles[a] );
+        M_opponent_min_cycle[a] = ( min_cycle < 0 ? 10 : min_cycle );
+    }
+
+    int first_cycle = MAX_CYCLE + 1;
+    int last_cycle = -1;
+    for ( int i = begin; i < end; ++i )
+    {
+        first_cycle = std::min( first_cycle, M_opponent_min_cycle[M_angle_index[i]] );
+        last_cycle = std::max( last_cycle, M_min_step[i] );
+    }
+    first_cycle = std::max( 0, first_cycle );
+    last_cycle = std::min( MAX_CYCLE, last_cycle );
+
+    if ( first_cycle > last_cycle )
+    {
+        return;
+    }
+
+    //
+    // opponent distance to the ball for all candidates
+    //
+    M_opponent_inertia_pos.resize( MAX_CYCLE + 1 );
+    for ( int cycle = first_cycle; cycle <= last_cycle; ++cycle )
+    {
+        const Vector2D inertia_pos = opponent->inertiaPoint( cycle );
+        M_opponent_inertia_pos[cycle] = inertia_pos;
+
+        const double * x = &M_ball_x[cycle * size];
+        const double * y = &M_ball_y[cycle * size];
+        double * dist = &M_dist[cycle * size];
+
+        for ( int i = begin; i < end; ++i )
+        {
+            const double dx = x[i] - inertia_pos.x;
+            const double dy = y[i] - inertia_pos.y;
+            dist[i] = std::sqrt( dx * dx + dy * dy );
+        }
+    }
+
+    //
+    // update the reach step of each candidate
+    //
+    for ( int i = begin; i < end; ++i )
+    {
+        int step = predictOpponentReachStep( opponent, i, M_min_step[i] );
+        if ( step > 1000 )
+        {
+            M_out_of_pitch_step[i] = step - 1000;
+            if ( M_out_of_pitch_step[i] < M_min_step[i] )
+            {
+                M_min_step[i] = M_out_of_pitch_step[i];
+            }
+        }
+        else if ( step < M_min_step[i] )
+        {
+            M_out_of_pitch_step[i] = -1;
+            M_min_step[i] = step;
+        }
+    }
+}
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -419,32 +608,21 @@ ClearGenerator::predictOpponentsReachStep( const WorldModel & wm,
  */
 int
 ClearGenerator::predictOpponentReachStep( const AbstractPlayerObject * opponent,
-                                          const Vector2D & first_ball_pos,
-                                          const Vector2D & first_ball_vel,
-                                          const AngleDeg & ball_move_angle,
+                                          const int candidate,
                                           const int max_cycle )
 {
     const ServerParam & SP = ServerParam::i();
 
-
     const PlayerType * ptype = opponent->playerTypePtr();
     const double opponent_speed = opponent->vel().r();
+    const int size = M_speed.size();
 
-    int min_cycle = FieldAnalyzer::estimate_min_reach_cycle( opponent->pos(),
-                                                             ptype->realSpeedMax(),
-                                                             first_ball_pos,
-                                                             ball_move_angle );
-    if ( min_cycle < 0 )
-    {
-        min_cycle = 10;
-    }
+    const int min_cycle = M_opponent_min_cycle[M_angle_index[candidate]];
 
     for ( int cycle = min_cycle; cycle <= max_cycle; ++cycle )
     {
-        Vector2D ball_pos = inertia_n_step_point( first_ball_pos,
-                                                  first_ball_vel,
-                                                  cycle,
-                                                  SP.ballDecay() );
+        const Vector2D ball_pos( M_ball_x[cycle * size + candidate],
+                                 M_ball_y[cycle * size + candidate] );
 
         if ( ball_pos.absX() > SP.pitchHalfLength()
              || ball_pos.absY() > SP.pitchHalfWidth() )
@@ -459,8 +637,8 @@ ClearGenerator::predictOpponentReachStep( const AbstractPlayerObject * opponent,
             return 1000 + cycle;
         }
 
-        Vector2D inertia_pos = opponent->inertiaPoint( cycle );
-        double target_dist = inertia_pos.dist( ball_pos );
+        const Vector2D & inertia_pos = M_opponent_inertia_pos[cycle];
+        const double target_dist = M_dist[cycle * size + candidate];
 
         if ( target_dist - ptype->kickableArea() - 0.15 < 0.001 )
         {
@@ -29,10 +29,11 @@
 
 /////////////////////////////////////////////////////////////////////
 
-#ifndef CROSS_GENERATOR_H
-#define CROSS_GENERATOR_H
+#ifndef CLEAR_GENERATOR_H
+#define CLEAR_GENERATOR_H
 
 #include "cooperative_action.h"
+#include "generator_budget.h"
 
 #include <rcsc/geom/vector_2d.h>
 #include <rcsc/game_time.h>
@@ -54,6 +55,32 @@ private:
 
     std::vector< CooperativeAction::Ptr > M_courses;
 
+    //
+    // candidate courses (structure of arrays)
+    //
+    std::vector< rcsc::AngleDeg > M_angles; //!< clear angles
+    std::vector< int > M_angle_order; //!< sweep order from the min angle for each angle
+    std::vector< int > M_angle_begin; //!< first candidate index for each angle (+ end mark)
+    std::vector< int > M_angle_index; //!< index of M_angles for each candidate
+    std::vector< double > M_speed; //!< first ball speed for each candidate
+    std::vector< int > M_kick_count; //!< kick count for each candidate
+    std::vector< int > M_min_step; //!< opponent reach step for each candidate
+    std::vector< int > M_out_of_pitch_step; //!< ball out of pitch step for each candidate
+
+    //
+    // ball trajectories and opponent distances. index = cycle * size + candidate
+    //
+    std::vector< double > M_ball_x;
+    std::vector< double > M_ball_y;
+    std::vector< double > M_dist;
+
+    //
+    // work area for each opponent
+    //
+    std::vector< int > M_opponent_min_cycle; //!< estimated min reach cycle for each angle
+    std::vector< rcsc::Vector2D > M_opponent_inertia_pos; //!< inertia position for each cycle
+
+    GeneratorBudget M_budget;
 
     // private for singleton
     ClearGenerator();
@@ -75,21 +102,68 @@ public:
           return M_courses;
       }
 
+    /*!
+      \brief set the search budget.
+      \param max_msec time limit [ms]. a non positive value means unlimited.
+      \param max_count the maximum number of clear angles.
+     */
+    void setBudget( const double & max_msec,
+                    const int max_count )
+      {
+          M_budget.setLimits( max_msec, max_count );
+      }
+
+    /*!
+      \brief check if the last search was cut by the budget.
+      \return true if the generated courses are a partial result.
+     */
+    bool truncated() const
+      {
+          return M_budget.truncated();
+      }
+
 private:
 
     void clear();
 
     void createCourses( const rcsc::WorldModel & wm );
 
-    int predictOpponentsReachStep( const rcsc::WorldModel & wm,
+    void createCandidates( const rcsc::WorldModel & wm );
+
+    /*!
+      \brief check the candidates while the budget remains.
+      \return the number of the evaluated candidates
+     */
+    int evaluateCandidates( const rcsc::WorldModel & wm,
+                            const rcsc::Vector2D & first_ball_pos );
+
+    void createBallTrajectories( const rcsc::Vector2D & first_ball_pos,
+                                 const int begin,
+                                 const int end );
+
+    void predictOpponentsReachStep( const rcsc::WorldModel & wm,
+                                    const rcsc::Vector2D & first_ball_pos,
+                                    const int begin,
+                                    const int end );
+    void predictOpponentReachStep( const rcsc::AbstractPlayerObject * opponent,
                                    const rcsc::Vector2D & first_ball_pos,
-                                   const double & first_ball_speed,
-                                   const rcsc::AngleDeg & ball_move_angle );
+                                   const int begin,
+                                   const int end );
     int predictOpponentReachStep( const rcsc::AbstractPlayerObject * opponent,
-                                  const rcsc::Vector2D & first_ball_pos,
-                                  const rcsc::Vector2D & first_ball_vel,
-                                  const rcsc::AngleDeg & ball_move_angle,
+                                  const int candidate,
                                   const int max_cycle );
+
+    /*!
+      \brief compare the candidates in the order of the original angle sweep.
+      \return true if the candidate i comes before the candidate j.
+     */
+    bool isPrior( const int i,
+                  const int j ) const
+      {
+          const int oi = M_angle_order[M_angle_index[i]];
+          const int oj = M_angle_order[M_angle_index[j]];
+          return ( oi != oj ? oi < oj : i < j );
+      }
 };
 
 #endif
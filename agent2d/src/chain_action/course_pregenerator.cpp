@@ -0,0 +1,402 @@
+// -*-c++-*-
+
+/*!
+  \file course_pregenerator.cpp
+  \brief concurrent course generation Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "course_pregenerator.h"
+
+#include "strict_check_pass_generator.h"
+#include "cross_generator.h"
+#include "shoot_generator.h"
+#include "short_dribble_generator.h"
+#include "self_pass_generator.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/player/intercept_table.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/logger.h>
+#include <rcsc/timer.h>
+
+#include <iostream>
+#include <cmath>
+
+// #define DEBUG_PROFILE
+
+using namespace rcsc;
+
+namespace {
+
+//
+// tasks
+//
+
+void
+generate_strict_check_pass( const WorldModel & wm )
+{
+    StrictCheckPassGenerator::instance().generate( wm );
+}
+
+void
+generate_cross( const WorldModel & wm )
+{
+    CrossGenerator::instance().generate( wm );
+}
+
+void
+generate_shoot( const WorldModel & wm )
+{
+    ShootGenerator::instance().generate( wm );
+}
+
+void
+generate_short_dribble( const WorldModel & wm )
+{
+    ShortDribbleGenerator::instance().generate( wm );
+}
+
+void
+generate_self_pass( const WorldModel & wm )
+{
+    SelfPassGenerator::instance().generate( wm );
+}
+
+//
+// filters. each one is a cheap copy of the early return conditions of
+// the generator. a generator filtered out here is still called lazily
+// by the chain search, so a filter only has to be conservative.
+//
+
+bool
+is_pass_cycle( const WorldModel & wm )
+{
+    return ( wm.time().stopped() == 0
+             && ! wm.gameMode().isPenaltyKickMode() );
+}
+
+bool
+is_cross_cycle( const WorldModel & wm )
+{
+    // the first point is the ball or its inertia point at the passer's
+    // reach cycle, and the generator requires it within 35m of the goal.
+    static const double BALL_DIST_THR = 35.0 + 10.0; // Magic Number
+
+    return ( is_pass_cycle( wm )
+             && wm.ball().pos().dist2( ServerParam::i().theirTeamGoalPos() )
+             < std::pow( BALL_DIST_THR, 2 ) );
+}
+
+bool
+is_shoot_cycle( const WorldModel & wm )
+{
+    return ( ( wm.self().isKickable()
+               || wm.interceptTable()->selfReachCycle() <= 1 )
+             && wm.time().stopped() == 0
+             && wm.self().pos().dist2( ServerParam::i().theirTeamGoalPos() )
+             <= std::pow( 30.0, 2 ) );
+}
+
+bool
+is_dribble_cycle( const WorldModel & wm )
+{
+    return ( ( wm.gameMode().type() == GameMode::PlayOn
+               || wm.gameMode().isPenaltyKickMode() )
+             && wm.self().isKickable()
+             && ! wm.self().isFrozen() );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CoursePregenerator::CoursePregenerator()
+    : M_world( static_cast< const WorldModel * >( 0 ) ),
+      M_generation( 0 ),
+      M_next_task( 0 ),
+      M_finished_count( 0 ),
+      M_quit( false )
+{
+    pthread_mutex_init( &M_mutex, NULL );
+    pthread_cond_init( &M_start_cond, NULL );
+    pthread_cond_init( &M_done_cond, NULL );
+
+    //
+    // the generators consumed by the chain search and the preprocess,
+    // the most expensive generator first.
+    // ClearGenerator is not registered because no action generator
+    // reads its courses.
+    //
+    M_tasks.push_back( TaskEntry( &generate_strict_check_pass, &is_pass_cycle ) );
+    M_tasks.push_back( TaskEntry( &generate_short_dribble, &is_dribble_cycle ) );
+    M_tasks.push_back( TaskEntry( &generate_self_pass, &is_dribble_cycle ) );
+    M_tasks.push_back( TaskEntry( &generate_shoot, &is_shoot_cycle ) );
+    M_tasks.push_back( TaskEntry( &generate_cross, &is_cross_cycle ) );
+
+    M_active_tasks.reserve( M_tasks.size() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CoursePregenerator::~CoursePregenerator()
+{
+    stopThreads();
+
+    pthread_cond_destroy( &M_done_cond );
+    pthread_cond_destroy( &M_start_cond );
+    pthread_mutex_destroy( &M_mutex );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CoursePregenerator &
+CoursePregenerator::instance()
+{
+    static CoursePregenerator s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CoursePregenerator::startThreads( const int n_threads )
+{
+    stopThreads();
+
+    for ( int i = 0; i < n_threads; ++i )
+    {
+        pthread_t thread;
+        if ( pthread_create( &thread, NULL, &CoursePregenerator::worker_main, this ) != 0 )
+        {
+            std::cerr << "(CoursePregenerator::startThreads) failed to create a thread."
+                      << std::endl;
+            return false;
+        }
+        M_threads.push_back( thread );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoursePregenerator::stopThreads()
+{
+    if ( M_threads.empty() )
+    {
+        return;
+    }
+
+    pthread_mutex_lock( &M_mutex );
+    M_quit = true;
+    pthread_cond_broadcast( &M_start_cond );
+    pthread_mutex_unlock( &M_mutex );
+
+    for ( std::vector< pthread_t >::iterator t = M_threads.begin();
+          t != M_threads.end();
+          ++t )
+    {
+        pthread_join( *t, NULL );
+    }
+    M_threads.clear();
+
+    M_quit = false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoursePregenerator::run( const WorldModel & wm )
+{
+#ifdef DEBUG_PROFILE
+    MSecTimer timer;
+#endif
+
+    //
+    // no worker thread. each generator is called lazily by the chain search.
+    //
+    if ( M_threads.empty() )
+    {
+        return;
+    }
+
+    //
+    // select the generators that this cycle can consume
+    //
+    M_active_tasks.clear();
+    for ( std::vector< TaskEntry >::const_iterator t = M_tasks.begin();
+          t != M_tasks.end();
+          ++t )
+    {
+        if ( t->filter_( wm ) )
+        {
+            M_active_tasks.push_back( t->task_ );
+        }
+    }
+
+    //
+    // the logger is not thread safe, and the generators and the analyzer
+    // functions they call write logs at various levels.
+    // if any log level is enabled, no task is given to the worker threads.
+    // a single task is also executed in this thread.
+    //
+    if ( M_active_tasks.size() <= 1
+         || dlog.isEnabled( Logger::LEVEL_ANY ) )
+    {
+        for ( std::vector< Task >::const_iterator t = M_active_tasks.begin();
+              t != M_active_tasks.end();
+              ++t )
+        {
+            (*t)( wm );
+        }
+        return;
+    }
+
+    pthread_mutex_lock( &M_mutex );
+    M_world = &wm;
+    M_next_task = 0;
+    M_finished_count = 0;
+    ++M_generation;
+    pthread_cond_broadcast( &M_start_cond );
+    pthread_mutex_unlock( &M_mutex );
+
+    // this thread also executes the tasks
+    while ( runNextTask() )
+    {
+
+    }
+
+    //
+    // barrier
+    //
+    pthread_mutex_lock( &M_mutex );
+    while ( M_finished_count < M_active_tasks.size() )
+    {
+        pthread_cond_wait( &M_done_cond, &M_mutex );
+    }
+    M_world = static_cast< const WorldModel * >( 0 );
+    pthread_mutex_unlock( &M_mutex );
+
+#ifdef DEBUG_PROFILE
+    dlog.addText( Logger::TEAM,
+                  __FILE__": (run) PROFILE elapsed %.3f [ms]",
+                  timer.elapsedReal() );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CoursePregenerator::runNextTask()
+{
+    pthread_mutex_lock( &M_mutex );
+    if ( ! M_world
+         || M_next_task >= M_active_tasks.size() )
+    {
+        pthread_mutex_unlock( &M_mutex );
+        return false;
+    }
+    const Task task = M_active_tasks[M_next_task];
+    const WorldModel & wm = *M_world;
+    ++M_next_task;
+    pthread_mutex_unlock( &M_mutex );
+
+    task( wm );
+
+    pthread_mutex_lock( &M_mutex );
+    ++M_finished_count;
+    if ( M_finished_count >= M_active_tasks.size() )
+    {
+        pthread_cond_signal( &M_done_cond );
+    }
+    pthread_mutex_unlock( &M_mutex );
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoursePregenerator::workerLoop()
+{
+    int generation = 0;
+
+    while ( true )
+    {
+        pthread_mutex_lock( &M_mutex );
+        while ( ! M_quit
+                && M_generation == generation )
+        {
+            pthread_cond_wait( &M_start_cond, &M_mutex );
+        }
+        const bool quit = M_quit;
+        generation = M_generation;
+        pthread_mutex_unlock( &M_mutex );
+
+        if ( quit )
+        {
+            break;
+        }
+
+        while ( runNextTask() )
+        {
+
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void *
+CoursePregenerator::worker_main( void * arg )
+{
+    static_cast< CoursePregenerator * >( arg )->workerLoop();
+    return NULL;
+}
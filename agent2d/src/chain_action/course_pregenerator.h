@@ -0,0 +1,131 @@
+// -*-c++-*-
+
+/*!
+  \file course_pregenerator.h
+  \brief concurrent course generation Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef COURSE_PREGENERATOR_H
+#define COURSE_PREGENERATOR_H
+
+#include <vector>
+#include <cstddef>
+
+#include <pthread.h>
+
+namespace rcsc {
+class WorldModel;
+}
+
+/*!
+  \class CoursePregenerator
+  \brief runs the independent course generators concurrently before the
+  action chain search.
+
+  Each task calls generate() of one generator singleton. run() selects
+  the tasks whose generator can be consumed in the current cycle. They
+  are executed by the worker threads and the caller thread, and run()
+  returns after all of them are finished. After that, the chain search
+  only reads the cached courses of the current cycle.
+ */
+class CoursePregenerator {
+public:
+
+    //! task type. a task must not touch the state of other tasks.
+    typedef void (*Task)( const rcsc::WorldModel & wm );
+
+    //! filter type. returns true if the task result can be used in this cycle.
+    typedef bool (*Filter)( const rcsc::WorldModel & wm );
+
+private:
+
+    struct TaskEntry {
+        Task task_;
+        Filter filter_;
+
+        TaskEntry( Task task,
+                   Filter filter )
+            : task_( task ),
+              filter_( filter )
+          { }
+    };
+
+    std::vector< TaskEntry > M_tasks; //!< registered tasks
+    std::vector< Task > M_active_tasks; //!< tasks selected for the current run()
+    std::vector< pthread_t > M_threads; //!< worker threads
+
+    pthread_mutex_t M_mutex;
+    pthread_cond_t M_start_cond; //!< signaled when the new tasks are ready
+    pthread_cond_t M_done_cond; //!< signaled when all tasks are finished
+
+    const rcsc::WorldModel * M_world; //!< world model for the current tasks
+    int M_generation; //!< incremented by each run()
+    std::size_t M_next_task; //!< index of the next task to be executed
+    std::size_t M_finished_count; //!< number of finished tasks
+    bool M_quit; //!< flag to terminate the worker threads
+
+    // private for singleton
+    CoursePregenerator();
+
+    // not used
+    CoursePregenerator( const CoursePregenerator & );
+    CoursePregenerator & operator=( const CoursePregenerator & );
+
+public:
+
+    ~CoursePregenerator();
+
+    static
+    CoursePregenerator & instance();
+
+    /*!
+      \brief start the worker threads.
+      \param n_threads number of the worker threads. if 0, run() does nothing
+      and the generators are called lazily as before.
+      \return true if all threads are started
+     */
+    bool startThreads( const int n_threads );
+
+    /*!
+      \brief execute all tasks and wait for them.
+      \param wm world model
+     */
+    void run( const rcsc::WorldModel & wm );
+
+private:
+
+    void stopThreads();
+
+    bool runNextTask();
+
+    void workerLoop();
+
+    static
+    void * worker_main( void * arg );
+};
+
+#endif
@@ -35,6 +35,7 @@
 
 #include "cross_generator.h"
 
+#include "ball_kinematics.h"
 #include "field_analyzer.h"
 
 #include <rcsc/player/world_model.h>
@@ -45,6 +46,8 @@
 #include <rcsc/soccer_math.h>
 #include <rcsc/timer.h>
 
+#include <algorithm>
+
 #define USE_ONLY_MAX_ANGLE_WIDTH
 
 #define DEBUG_PROFILE
@@ -71,6 +74,37 @@ debug_paint_failed( const int count,
                      receive_point, num );
 }
 
+struct ReceiverGoalDistCompare {
+
+    const Vector2D goal_;
+
+    ReceiverGoalDistCompare()
+        : goal_( ServerParam::i().theirTeamGoalPos() )
+      { }
+
+    bool operator()( const AbstractPlayerObject * lhs,
+                     const AbstractPlayerObject * rhs ) const
+      {
+          return lhs->pos().dist2( goal_ ) < rhs->pos().dist2( goal_ );
+      }
+};
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CrossGenerator::Opponent::Opponent( const AbstractPlayerObject * p,
+                                    const Vector2D & first_ball_pos )
+    : player_( p ),
+      ptype_( p->playerTypePtr() ),
+      pos_( p->inertiaFinalPoint() )
+{
+    dist_from_ball_ = pos_.dist( first_ball_pos );
+    control_area_ = ( p->goalie()
+                      ? ServerParam::i().catchableArea()
+                      : ptype_->kickableArea() );
 }
 
 /*-------------------------------------------------------------------*/
@@ -79,6 +113,8 @@ debug_paint_failed( const int count,
  */
 CrossGenerator::CrossGenerator()
 {
+    M_opponent_cache.reserve( 11 );
+    M_ball_trajectory.reserve( 32 );
     M_courses.reserve( 1024 );
 
     clear();
@@ -107,6 +143,8 @@ CrossGenerator::clear()
     M_first_point.invalidate();
     M_receiver_candidates.clear();
     M_opponents.clear();
+    M_opponent_cache.clear();
+    M_ball_trajectory.clear();
     M_courses.clear();
 }
 
@@ -165,13 +203,16 @@ CrossGenerator::generate( const WorldModel & wm )
 
     updateOpponents( wm );
 
+    M_budget.start();
+
     createCourses( wm );
 
 #ifdef DEBUG_PROFILE
     dlog.addText( Logger::CROSS,
-                  __FILE__" (generate) PROFILE course_size=%d/%d elapsed %f [ms]",
+                  __FILE__" (generate) PROFILE course_size=%d/%d%s elapsed %f [ms]",
                   (int)M_courses.size(),
                   M_total_count,
+                  ( M_budget.truncated() ? " (truncated)" : "" ),
                   timer.elapsedReal() );
 #endif
 }
@@ -214,7 +255,7 @@ CrossGenerator::updatePasser( const WorldModel & wm )
         if ( s_min <= 2 )
         {
             M_passer = &wm.self();
-            M_first_point = wm.ball().inertiaPoint( s_min );
+            M_first_point = BallKinematics::instance().ballInertiaPoint( wm, s_min );
         }
     }
     else
@@ -222,7 +263,7 @@ CrossGenerator::updatePasser( const WorldModel & wm )
         if ( t_min <= 2 )
         {
             M_passer = wm.interceptTable()->fastestTeammate();
-            M_first_point = wm.ball().inertiaPoint( t_min );
+            M_first_point = BallKinematics::instance().ballInertiaPoint( wm, t_min );
         }
     }
 
@@ -316,6 +357,11 @@ CrossGenerator::updateReceivers( const WorldModel & wm )
                       (*p)->pos().x, (*p)->pos().y );
 #endif
     }
+
+    // the receiver nearest to the goal is tried first
+    std::sort( M_receiver_candidates.begin(),
+               M_receiver_candidates.end(),
+               ReceiverGoalDistCompare() );
 }
 
 /*-------------------------------------------------------------------*/
@@ -348,6 +394,7 @@ CrossGenerator::updateOpponents( const WorldModel & wm )
         }
 
         M_opponents.push_back( *p );
+        M_opponent_cache.push_back( Opponent( *p, M_first_point ) );
 
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::PASS,
@@ -356,6 +403,29 @@ CrossGenerator::updateOpponents( const WorldModel & wm )
                       (*p)->pos().x, (*p)->pos().y );
 #endif
     }
+
+    //
+    // the nearest opponent is checked first, and the opponent loop in
+    // checkOpponent() can be terminated by the first too far opponent.
+    //
+    std::sort( M_opponent_cache.begin(), M_opponent_cache.end(),
+               OpponentDistCompare() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CrossGenerator::createBallTrajectory( const double & first_ball_speed,
+                                      const AngleDeg & ball_move_angle,
+                                      const int max_cycle )
+{
+    BallKinematics::instance().createTrajectory( M_first_point,
+                                                 Vector2D::polar2vector( first_ball_speed,
+                                                                         ball_move_angle ),
+                                                 max_cycle,
+                                                 M_ball_trajectory );
 }
 
 /*-------------------------------------------------------------------*/
@@ -366,11 +436,18 @@ void
 CrossGenerator::createCourses( const WorldModel & wm )
 {
     for ( AbstractPlayerCont::const_iterator p = M_receiver_candidates.begin();
-          p != M_receiver_candidates.end();
+          p != M_receiver_candidates.end() && ! M_budget.truncated();
           ++p )
     {
         createCross( wm, *p );
     }
+
+    if ( M_budget.truncated() )
+    {
+        dlog.addText( Logger::CROSS,
+                      __FILE__" (createCourses) truncated by budget. count=%d elapsed %.3f [ms]",
+                      M_budget.count(), M_budget.elapsed() );
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -398,6 +475,8 @@ CrossGenerator::createCross( const WorldModel & wm,
 
     const ServerParam & SP = ServerParam::i();
 
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
+
     const double min_first_ball_speed = SP.ballSpeedMax() * 0.67; // Magic Number
     const double max_first_ball_speed = ( wm.gameMode().type() == GameMode::PlayOn
                                           ? SP.ballSpeedMax()
@@ -416,10 +495,11 @@ CrossGenerator::createCross( const WorldModel & wm,
 #endif
 
     //
-    // angle loop
+    // angle loop. the angles near the receiver direction are tried first.
     //
-    for ( int a = -2; a < 3; ++a )
+    for ( int i = 0; i < 5 && ! M_budget.truncated(); ++i )
     {
+        const int a = GeneratorBudget::alternate_offset( i );
         const AngleDeg cross_angle = receiver_angle_from_ball + ( ANGLE_STEP * a );
 
         //
@@ -427,6 +507,11 @@ CrossGenerator::createCross( const WorldModel & wm,
         //
         for ( int d = 0; d < 5; ++d )
         {
+            if ( ! M_budget.consume() )
+            {
+                break;
+            }
+
             const double sub_dist = DIST_STEP * d;
             const double ball_move_dist = receiver_dist - sub_dist;
             const Vector2D receive_point
@@ -466,9 +551,7 @@ CrossGenerator::createCross( const WorldModel & wm,
             {
                 ++M_total_count;
 
-                double first_ball_speed = calc_first_term_geom_series( ball_move_dist,
-                                                                       SP.ballDecay(),
-                                                                       step );
+                double first_ball_speed = ball_kinematics.firstSpeed( ball_move_dist, step );
                 if ( first_ball_speed < min_first_ball_speed )
                 {
 #ifdef DEBUG_PRINT_FAILED_COURSE
@@ -499,7 +582,20 @@ CrossGenerator::createCross( const WorldModel & wm,
                     continue;
                 }
 
-                double receive_ball_speed = first_ball_speed * std::pow( SP.ballDecay(), step );
+                int kick_count = FieldAnalyzer::predict_kick_count( wm,
+                                                                    M_passer,
+                                                                    first_ball_speed,
+                                                                    cross_angle );
+
+                //
+                // one trajectory per course, indexed by step in both checks.
+                // kick_count >= 1, so the table always covers step + 1.
+                //
+                createBallTrajectory( first_ball_speed,
+                                      cross_angle,
+                                      step + kick_count );
+
+                double receive_ball_speed = M_ball_trajectory[step + 1].dist( M_ball_trajectory[step] );
                 if ( receive_ball_speed < MIN_RECEIVE_BALL_SPEED )
                 {
 #ifdef DEBUG_PRINT_FAILED_COURSE
@@ -515,16 +611,8 @@ CrossGenerator::createCross( const WorldModel & wm,
                     break;
                 }
 
-
-                int kick_count = FieldAnalyzer::predict_kick_count( wm,
-                                                                    M_passer,
-                                                                    first_ball_speed,
-                                                                    cross_angle );
-
-                if ( ! checkOpponent( M_first_point,
-                                      receiver,
+                if ( ! checkOpponent( receiver,
                                       receive_point,
-                                      first_ball_speed,
                                       cross_angle,
                                       step + kick_count - 1 ) ) // 1 step penalty for observation delay
                 {
@@ -597,57 +685,51 @@ CrossGenerator::createCross( const WorldModel & wm,
 
  */
 bool
-CrossGenerator::checkOpponent( const Vector2D & first_ball_pos,
-                               const rcsc::AbstractPlayerObject * receiver,
+CrossGenerator::checkOpponent( const rcsc::AbstractPlayerObject * receiver,
                                const Vector2D & receive_pos,
-                               const double & first_ball_speed,
                                const AngleDeg & ball_move_angle,
                                const int max_cycle )
 {
     static const double CONTROL_AREA_BUF = 0.15;  // buffer for kick table
 
-    const ServerParam & SP = ServerParam::i();
+    const double receiver_dist = receiver->pos().dist( M_first_point );
+    const double opponent_dist_thr = receiver_dist + 1.0;
 
-    const double receiver_dist = receiver->pos().dist( first_ball_pos );
-    const Vector2D first_ball_vel
-        = Vector2D( receive_pos - first_ball_pos ).setLength( first_ball_speed );
+    //
+    // M_ball_trajectory has been created by createBallTrajectory()
+    //
 
-    const AbstractPlayerCont::const_iterator end = M_opponents.end();
-    for ( AbstractPlayerCont::const_iterator o = M_opponents.begin();
+    const std::vector< Opponent >::const_iterator end = M_opponent_cache.end();
+    for ( std::vector< Opponent >::const_iterator o = M_opponent_cache.begin();
           o != end;
           ++o )
     {
-        const PlayerType * ptype = (*o)->playerTypePtr();
-        const double control_area = ( (*o)->goalie()
-                                      ? SP.catchableArea()
-                                      : ptype->kickableArea() );
-
-        const Vector2D opponent_pos = (*o)->inertiaFinalPoint();
-        const int min_cycle = FieldAnalyzer::estimate_min_reach_cycle( opponent_pos,
-                                                                       ptype->realSpeedMax(),
-                                                                       first_ball_pos,
-                                                                       ball_move_angle );
-
-
-        if ( opponent_pos.dist( first_ball_pos ) > receiver_dist + 1.0 )
+        if ( o->dist_from_ball_ > opponent_dist_thr )
         {
 #ifdef DEBUG_PRINT
             dlog.addText( Logger::CROSS,
                           "__ opponent[%d](%.2f %.2f) skip. distance over",
-                          (*o)->unum(),
-                          opponent_pos.x, opponent_pos.y );
+                          o->player_->unum(),
+                          o->pos_.x, o->pos_.y );
 #endif
-            continue;
+            // M_opponent_cache is sorted by distance.
+            // all other opponents are also too far.
+            break;
         }
 
+        const PlayerType * ptype = o->ptype_;
+        const double control_area = o->control_area_;
+        const Vector2D & opponent_pos = o->pos_;
+        const int min_cycle = FieldAnalyzer::estimate_min_reach_cycle( opponent_pos,
+                                                                       ptype->realSpeedMax(),
+                                                                       M_first_point,
+                                                                       ball_move_angle );
+
         for ( int cycle = std::max( 1, min_cycle );
               cycle <= max_cycle;
               ++cycle )
         {
-            Vector2D ball_pos = inertia_n_step_point( first_ball_pos,
-                                                      first_ball_vel,
-                                                      cycle,
-                                                      SP.ballDecay() );
+            const Vector2D & ball_pos = M_ball_trajectory[cycle];
             double target_dist = opponent_pos.dist( ball_pos );
 
             if ( target_dist - control_area - CONTROL_AREA_BUF < 0.001 )
@@ -660,7 +742,7 @@ CrossGenerator::checkOpponent( const Vector2D & first_ball_pos,
                               M_total_count,
                               receive_pos.x, receive_pos.y,
                               cycle, max_cycle,
-                              (*o)->unum(), opponent_pos.x, opponent_pos.y ,
+                              o->player_->unum(), opponent_pos.x, opponent_pos.y ,
                               ball_pos.x, ball_pos.y );
                 debug_paint_failed( M_total_count, receive_pos );
 #endif
@@ -695,18 +777,18 @@ CrossGenerator::checkOpponent( const Vector2D & first_ball_pos,
             //
             // turn
             //
-            int n_turn = ( (*o)->bodyCount() >= 3
+            int n_turn = ( o->player_->bodyCount() >= 3
                            ? 2
                            : FieldAnalyzer::predict_player_turn_cycle( ptype,
-                                                                       (*o)->body(),
-                                                                       (*o)->vel().r(),
+                                                                       o->player_->body(),
+                                                                       o->player_->vel().r(),
                                                                        target_dist,
                                                                        ( ball_pos - opponent_pos ).th(),
                                                                        control_area,
                                                                        true ) );
 
             int n_step = n_turn + n_dash + 1; // 1 step penalty for observation delay
-            if ( (*o)->isTackling() )
+            if ( o->player_->isTackling() )
             {
                 n_step += 5; // Magic Number
             }
@@ -721,7 +803,7 @@ CrossGenerator::checkOpponent( const Vector2D & first_ball_pos,
                               M_total_count,
                               receive_pos.x, receive_pos.y,
                               cycle, max_cycle,
-                              (*o)->unum(), opponent_pos.x, opponent_pos.y,
+                              o->player_->unum(), opponent_pos.x, opponent_pos.y,
                               ball_pos.x, ball_pos.y );
                 debug_paint_failed( M_total_count, receive_pos );
 #endif
@@ -33,6 +33,7 @@
 #define CROSS_GENERATOR_H
 
 #include "pass.h"
+#include "generator_budget.h"
 
 #include <rcsc/player/abstract_player_object.h>
 #include <rcsc/geom/vector_2d.h>
@@ -42,12 +43,39 @@
 
 namespace rcsc {
 class PlayerObject;
+class PlayerType;
 class WorldModel;
 }
 
 
 class CrossGenerator {
 private:
+
+    /*!
+      \brief opponent data shared by all cross courses in the same cycle
+     */
+    struct Opponent {
+        const rcsc::AbstractPlayerObject * player_; //!< original object
+        const rcsc::PlayerType * ptype_; //!< player type
+        rcsc::Vector2D pos_; //!< estimated final position
+        double dist_from_ball_; //!< distance from the first ball position
+        double control_area_; //!< kickable area or catchable area
+
+        Opponent( const rcsc::AbstractPlayerObject * p,
+                  const rcsc::Vector2D & first_ball_pos );
+    };
+
+    /*!
+      \brief compare the distance from the first ball position
+     */
+    struct OpponentDistCompare {
+        bool operator()( const Opponent & lhs,
+                         const Opponent & rhs ) const
+          {
+              return lhs.dist_from_ball_ < rhs.dist_from_ball_;
+          }
+    };
+
     int M_total_count;
 
     const rcsc::AbstractPlayerObject * M_passer; //!< estimated passer
@@ -56,8 +84,14 @@ private:
     rcsc::AbstractPlayerCont M_receiver_candidates;
     rcsc::AbstractPlayerCont M_opponents;
 
+    std::vector< Opponent > M_opponent_cache; //!< sorted by the distance from the first point
+
+    std::vector< rcsc::Vector2D > M_ball_trajectory; //!< ball position table of the current course, indexed by cycle
+
     std::vector< CooperativeAction::Ptr > M_courses;
 
+    GeneratorBudget M_budget;
+
 
     // private for singleton
     CrossGenerator();
@@ -79,6 +113,26 @@ public:
           return M_courses;
       }
 
+    /*!
+      \brief set the search budget.
+      \param max_msec time limit [ms]. a non positive value means unlimited.
+      \param max_count the maximum number of receive points.
+     */
+    void setBudget( const double & max_msec,
+                    const int max_count )
+      {
+          M_budget.setLimits( max_msec, max_count );
+      }
+
+    /*!
+      \brief check if the last search was cut by the budget.
+      \return true if the generated courses are a partial result.
+     */
+    bool truncated() const
+      {
+          return M_budget.truncated();
+      }
+
 private:
 
     void clear();
@@ -87,14 +141,16 @@ private:
     void updateReceivers( const rcsc::WorldModel & wm );
     void updateOpponents( const rcsc::WorldModel & wm );
 
+    void createBallTrajectory( const double & first_ball_speed,
+                               const rcsc::AngleDeg & ball_move_angle,
+                               const int max_cycle );
+
     void createCourses( const rcsc::WorldModel & wm );
     void createCross( const rcsc::WorldModel & wm,
                       const rcsc::AbstractPlayerObject * receiver );
 
-    bool checkOpponent( const rcsc::Vector2D & first_ball_pos,
-                        const rcsc::AbstractPlayerObject * receiver,
+    bool checkOpponent( const rcsc::AbstractPlayerObject * receiver,
                         const rcsc::Vector2D & receive_pos,
-                        const double & first_ball_speed,
                         const rcsc::AngleDeg & ball_move_angle,
                         const int max_cycle );
 
@@ -0,0 +1,153 @@
+// -*-c++-*-
+
+/*!
+  \file dash_trajectory_table.cpp
+  \brief precomputed self movement table for each player type Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "dash_trajectory_table.h"
+
+#include <rcsc/player/stamina_model.h>
+#include <rcsc/common/server_param.h>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DashTrajectoryTable::DashTrajectoryTable()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DashTrajectoryTable &
+DashTrajectoryTable::instance()
+{
+    static DashTrajectoryTable s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DashTrajectoryTable::create()
+{
+    const PlayerTypeSet::PlayerTypeMap & types = PlayerTypeSet::i().playerTypeMap();
+
+    for ( PlayerTypeSet::PlayerTypeMap::const_iterator it = types.begin(), end = types.end();
+          it != end;
+          ++it )
+    {
+        const int id = it->first;
+        if ( id < 0 ) continue;
+
+        if ( static_cast< int >( M_rates.size() ) <= id )
+        {
+            M_rates.resize( id + 1 );
+        }
+
+        const double decay = it->second.playerDecay();
+
+        Rates & rates = M_rates[id];
+        rates.inertia_.resize( MAX_STEP + 1 );
+        rates.dash_.resize( MAX_STEP + 1 );
+
+        double decay_power = 1.0;
+        rates.inertia_[0] = 0.0;
+        rates.dash_[0] = 0.0;
+        for ( int n = 1; n <= MAX_STEP; ++n )
+        {
+            rates.inertia_[n] = rates.inertia_[n-1] + decay_power;
+            rates.dash_[n] = rates.dash_[n-1] + rates.inertia_[n];
+            decay_power *= decay;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DashTrajectoryTable::hasTable( const PlayerType & ptype,
+                               const int n_step ) const
+{
+    return ( 0 <= ptype.id()
+             && ptype.id() < static_cast< int >( M_rates.size() )
+             && ! M_rates[ptype.id()].inertia_.empty()
+             && n_step <= MAX_STEP );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DashTrajectoryTable::is_full_stamina_band( const PlayerType & ptype,
+                                           const StaminaModel & stamina_model,
+                                           const double & stamina_thr,
+                                           const int n_dash )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    //
+    // the recovery during the waits and dashes only increases the stamina.
+    // so the stamina before each dash is never less than this lower bound.
+    //
+    const double min_stamina = stamina_model.stamina() - SP.maxDashPower() * n_dash;
+
+    // every dash has the max power
+    if ( min_stamina < stamina_thr )
+    {
+        return false;
+    }
+
+    // the effort never increases
+    if ( stamina_model.effort() < ptype.effortMax() )
+    {
+        return false;
+    }
+
+    // the effort never decreases
+    if ( min_stamina <= SP.effortDecThrValue() )
+    {
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,150 @@
+// -*-c++-*-
+
+/*!
+  \file dash_trajectory_table.h
+  \brief precomputed self movement table for each player type Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef DASH_TRAJECTORY_TABLE_H
+#define DASH_TRAJECTORY_TABLE_H
+
+#include <rcsc/common/player_type.h>
+
+#include <vector>
+
+namespace rcsc {
+class StaminaModel;
+}
+
+/*!
+  \class DashTrajectoryTable
+  \brief self movement table for waits (kick/turn) followed by full power dashes.
+
+  The movement of "n_wait steps without acceleration, then n_dash dashes in
+  the same direction" is separated into the inertia move of the first
+  velocity and the dash move along the dash direction:
+
+    pos = first_pos
+          + first_vel * inertiaRate( n_wait + n_dash )
+          + unit( dash_angle ) * dashAccel * dashRate( n_dash )
+
+  Both rates depend only on the player decay, so the table is created once
+  for each player type. The initial velocity and the dash direction are
+  applied by scaling and rotation at run time. Like the step-by-step
+  simulation, the player speed max is not considered.
+
+  The dash move is exact only while every dash is performed by the maximum
+  dash power and the effort does not change (the "full stamina" band).
+  isFullStaminaBand() checks this condition. Otherwise, the caller has to
+  simulate the dashes step by step.
+*/
+class DashTrajectoryTable {
+public:
+
+    //! max size of the table
+    static const int MAX_STEP = 32;
+
+private:
+
+    /*!
+      \brief rate table of one player type
+     */
+    struct Rates {
+        std::vector< double > inertia_; //!< sum_{i<n} decay^i
+        std::vector< double > dash_; //!< sum_{k=1..n} inertia_[k]
+    };
+
+    //! rate tables indexed by player type id
+    std::vector< Rates > M_rates;
+
+    // private for singleton
+    DashTrajectoryTable();
+
+    // not used
+    DashTrajectoryTable( const DashTrajectoryTable & );
+    DashTrajectoryTable & operator=( const DashTrajectoryTable & );
+
+public:
+
+    static
+    DashTrajectoryTable & instance();
+
+    /*!
+      \brief (re)create tables for all player types received from the server.
+     */
+    void create();
+
+    /*!
+      \brief check if the table for the player type is available.
+      \param ptype player type
+      \param n_step total number of steps (waits + dashes)
+      \return true if table can be used
+     */
+    bool hasTable( const rcsc::PlayerType & ptype,
+                   const int n_step ) const;
+
+    /*!
+      \brief check if all dashes are performed by the max dash power without
+      effort change.
+      \param ptype player type
+      \param stamina_model current stamina state
+      \param stamina_thr dash power is limited to (stamina - stamina_thr)
+      \param n_dash number of dashes
+      \return true if the dash move can be calculated by the table
+     */
+    static
+    bool is_full_stamina_band( const rcsc::PlayerType & ptype,
+                               const rcsc::StaminaModel & stamina_model,
+                               const double & stamina_thr,
+                               const int n_dash );
+
+    /*!
+      \brief get the movement by the first velocity
+      \param ptype player type
+      \param n_step number of steps
+      \return rate to be multiplied to the first velocity
+     */
+    const double & inertiaRate( const rcsc::PlayerType & ptype,
+                                const int n_step ) const
+      {
+          return M_rates[ptype.id()].inertia_[n_step];
+      }
+
+    /*!
+      \brief get the movement by the dash acceleration
+      \param ptype player type
+      \param n_dash number of dashes
+      \return rate to be multiplied to the dash acceleration
+     */
+    const double & dashRate( const rcsc::PlayerType & ptype,
+                             const int n_dash ) const
+      {
+          return M_rates[ptype.id()].dash_[n_dash];
+      }
+};
+
+#endif
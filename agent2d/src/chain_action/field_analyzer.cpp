@@ -61,6 +61,7 @@ using namespace rcsc;
 
  */
 FieldAnalyzer::FieldAnalyzer()
+    : M_teammate_grid_source( static_cast< const PlayerCont * >( 0 ) )
 {
 
 }
@@ -907,6 +908,20 @@ FieldAnalyzer::get_dist_player_nearest_to_point( const Vector2D & point,
                                                  const PlayerCont & players,
                                                  const int count_thr )
 {
+    const FieldAnalyzer & analyzer = FieldAnalyzer::i();
+    const PlayerGrid * grid = ( &players == analyzer.M_teammate_grid_source
+                                ? &analyzer.M_teammate_grid
+                                : static_cast< const PlayerGrid * >( 0 ) );
+    if ( grid )
+    {
+        double dist = 0.0;
+        if ( grid->nearest( point, count_thr, &dist ) )
+        {
+            return dist;
+        }
+        return std::sqrt( 65535.0 );
+    }
+
     double min_dist2 = 65535.0;
 
     const PlayerCont::const_iterator end = players.end();
@@ -1212,6 +1227,8 @@ FieldAnalyzer::update( const WorldModel & wm )
     }
     s_update_time = wm.time();
 
+    updatePlayerGrid( wm );
+
     if ( wm.gameMode().type() == GameMode::BeforeKickOff
          || wm.gameMode().type() == GameMode::AfterGoal_
          || wm.gameMode().isPenaltyKickMode() )
@@ -1234,6 +1251,20 @@ FieldAnalyzer::update( const WorldModel & wm )
 
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FieldAnalyzer::updatePlayerGrid( const WorldModel & wm )
+{
+    M_teammate_grid.build( wm.teammates() );
+    // unknown players are treated as opponents, the same as getOpponentNearestTo()
+    M_opponent_grid.build( wm.opponentsFromSelf() );
+
+    M_teammate_grid_source = &wm.teammates();
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
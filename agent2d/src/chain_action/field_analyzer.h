@@ -33,6 +33,7 @@
 #define FIELD_ANALYZER_H
 
 #include "predict_state.h"
+#include "player_grid.h"
 
 #include <rcsc/geom/voronoi_diagram.h>
 #include <rcsc/geom/vector_2d.h>
@@ -56,6 +57,10 @@ private:
     rcsc::VoronoiDiagram M_teammates_voronoi_diagram;
     rcsc::VoronoiDiagram M_pass_voronoi_diagram;
 
+    PlayerGrid M_teammate_grid;
+    PlayerGrid M_opponent_grid; //!< opponents and unknown players
+    const rcsc::PlayerCont * M_teammate_grid_source; //!< container indexed by M_teammate_grid
+
     FieldAnalyzer();
 public:
 
@@ -83,12 +88,30 @@ public:
           return M_pass_voronoi_diagram;
       }
 
+    /*!
+      \brief get the spatial index of teammates built in this cycle.
+     */
+    const PlayerGrid & teammateGrid() const
+      {
+          return M_teammate_grid;
+      }
+
+    /*!
+      \brief get the spatial index of opponents built in this cycle.
+      unknown players are included, as in WorldModel::opponentsFromSelf().
+     */
+    const PlayerGrid & opponentGrid() const
+      {
+          return M_opponent_grid;
+      }
+
     void update( const rcsc::WorldModel & wm );
 
 
 private:
 
     void updateVoronoiDiagram( const rcsc::WorldModel & wm );
+    void updatePlayerGrid( const rcsc::WorldModel & wm );
 
     void writeDebugLog();
 
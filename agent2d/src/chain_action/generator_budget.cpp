@@ -0,0 +1,109 @@
+// -*-c++-*-
+
+/*!
+  \file generator_budget.cpp
+  \brief time and work limits of the action generators Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "generator_budget.h"
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+GeneratorBudget::GeneratorBudget()
+    : M_max_msec( 0.0 ),
+      M_max_count( 0 ),
+      M_count( 0 ),
+      M_truncated( false )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+GeneratorBudget::setLimits( const double & max_msec,
+                            const int max_count )
+{
+    M_max_msec = max_msec;
+    M_max_count = max_count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+GeneratorBudget::start()
+{
+    M_timer.restart();
+    M_count = 0;
+    M_truncated = false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+GeneratorBudget::consume()
+{
+    // the clock is read only once per TIME_CHECK_INTERVAL units
+    static const int TIME_CHECK_INTERVAL = 8;
+
+    if ( M_truncated )
+    {
+        return false;
+    }
+
+    if ( M_max_count > 0
+         && M_count >= M_max_count )
+    {
+        M_truncated = true;
+        return false;
+    }
+
+    if ( M_max_msec > 0.0
+         && M_count % TIME_CHECK_INTERVAL == 0
+         && M_timer.elapsedReal() > M_max_msec )
+    {
+        M_truncated = true;
+        return false;
+    }
+
+    ++M_count;
+    return true;
+}
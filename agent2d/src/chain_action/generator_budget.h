@@ -0,0 +1,135 @@
+// -*-c++-*-
+
+/*!
+  \file generator_budget.h
+  \brief time and work limits of the action generators Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef GENERATOR_BUDGET_H
+#define GENERATOR_BUDGET_H
+
+#include <rcsc/timer.h>
+
+/*!
+  \class GeneratorBudget
+  \brief time and work limits for one action generator call.
+
+  A generator calls start() at the beginning of its search and consume()
+  before each candidate evaluation. When either limit is exceeded,
+  consume() returns false and the generator should stop with the
+  candidates found so far. Since the generators try the promising region
+  first, a truncated search still contains the most important courses.
+
+  Only the candidate loops may be cut. The opponent checks of a candidate
+  must never be truncated, or an unsafe course could be accepted.
+ */
+class GeneratorBudget {
+private:
+
+    //! time limit [ms]. a non positive value means unlimited.
+    double M_max_msec;
+    //! work limit (the number of candidates). a non positive value means unlimited.
+    int M_max_count;
+
+    rcsc::MSecTimer M_timer;
+    int M_count;
+    bool M_truncated;
+
+public:
+
+    GeneratorBudget();
+
+    /*!
+      \brief set the limits.
+      \param max_msec time limit [ms]. zero or a negative value disables it.
+      \param max_count work limit. zero or a negative value disables it.
+     */
+    void setLimits( const double & max_msec,
+                    const int max_count );
+
+    double maxMSec() const
+      {
+          return M_max_msec;
+      }
+
+    int maxCount() const
+      {
+          return M_max_count;
+      }
+
+    bool isUnlimited() const
+      {
+          return M_max_msec <= 0.0 && M_max_count <= 0;
+      }
+
+    /*!
+      \brief reset the counters and the timer for a new search.
+     */
+    void start();
+
+    /*!
+      \brief try to use one unit of the budget.
+      \return false if the budget has been exhausted.
+     */
+    bool consume();
+
+    /*!
+      \brief check if the last search was cut by the budget.
+      \return true if truncated
+     */
+    bool truncated() const
+      {
+          return M_truncated;
+      }
+
+    int count() const
+      {
+          return M_count;
+      }
+
+    double elapsed() const
+      {
+          return M_timer.elapsedReal();
+      }
+
+    /*!
+      \brief convert the loop counter to the offset from the center index
+      in the order 0, +1, -1, +2, -2, ... so that the loop tries the
+      candidates near the center direction first.
+      \param i loop counter (>= 0)
+      \return offset from the center
+     */
+    static
+    int alternate_offset( const int i )
+      {
+          return ( i % 2 == 0
+                   ? -( i / 2 )
+                   : ( i + 1 ) / 2 );
+      }
+};
+
+#endif
@@ -0,0 +1,198 @@
+// -*-c++-*-
+
+/*!
+  \file opponent_reach_table.cpp
+  \brief approximate opponent reach distance table Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "opponent_reach_table.h"
+
+#include "ball_kinematics.h"
+#include "field_analyzer.h"
+#include "player_state_fusion.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/geom/segment_2d.h>
+
+#include <algorithm>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+OpponentReachTable::OpponentReachTable()
+    : M_update_time( -1, 0 )
+{
+    M_opponents.reserve( 11 );
+    M_reach_dist.reserve( 11 * ( MAX_STEP + 1 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+OpponentReachTable &
+OpponentReachTable::instance()
+{
+    static OpponentReachTable s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+OpponentReachTable::update( const WorldModel & wm )
+{
+    static const double VALID_OPPONENT_RADIUS = 6.0; // Magic Number
+    static const int REACTION_STEP = 1; // turn or observation delay
+
+    if ( M_update_time == wm.time() )
+    {
+        return;
+    }
+    M_update_time = wm.time();
+
+    M_opponents.clear();
+    M_reach_dist.clear();
+
+    const ServerParam & SP = ServerParam::i();
+    const PlayerStateFusion & fusion = PlayerStateFusion::i();
+
+    for ( AbstractPlayerCont::const_iterator
+              p = wm.theirPlayers().begin(),
+              end = wm.theirPlayers().end();
+          p != end;
+          ++p )
+    {
+        const double radius = fusion.radius( **p );
+        if ( radius > VALID_OPPONENT_RADIUS ) continue;
+
+        const PlayerType * ptype = (*p)->playerTypePtr();
+
+        Opponent o;
+        o.player_ = *p;
+        o.pos_ = ptype->inertiaFinalPoint( fusion.position( **p ), (*p)->vel() );
+        o.catch_bonus_ = ( (*p)->goalie()
+                           ? std::max( 0.0, SP.catchableArea() - ptype->kickableArea() )
+                           : 0.0 );
+        M_opponents.push_back( o );
+
+        //
+        // full power dashes from the stopped state after the reaction step
+        //
+        const double accel = SP.maxDashPower() * ptype->dashPowerRate() * ptype->effortMax();
+        const double speed_max = ptype->realSpeedMax();
+
+        // the radius can only shrink the count based observation bonus
+        // (at most about 2.5m), e.g. for a recently heard opponent.
+        double dist = ptype->kickableArea()
+            + std::min( radius, FieldAnalyzer::estimate_virtual_dash_distance( *p ) );
+        double speed = 0.0;
+
+        for ( int step = 0; step <= MAX_STEP; ++step )
+        {
+            if ( step > REACTION_STEP )
+            {
+                speed = std::min( speed_max, speed + accel );
+                dist += speed;
+                speed *= ptype->playerDecay();
+            }
+            M_reach_dist.push_back( dist );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+OpponentReachTable::predictReachStep( const Vector2D & first_ball_pos,
+                                      const Vector2D & first_ball_vel,
+                                      const int elapsed_step,
+                                      const int max_step,
+                                      const AbstractPlayerObject ** opponent ) const
+{
+    const ServerParam & SP = ServerParam::i();
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
+
+    const int elapsed = std::min( std::max( 0, elapsed_step ), MAX_ELAPSED_STEP );
+    const Segment2D ball_move( first_ball_pos,
+                               ball_kinematics.inertiaPoint( first_ball_pos,
+                                                             first_ball_vel,
+                                                             max_step ) );
+
+    int min_step = max_step + 1;
+
+    const size_t size = M_opponents.size();
+    for ( size_t i = 0; i < size; ++i )
+    {
+        const Opponent & o = M_opponents[i];
+
+        //
+        // the opponent cannot reach the ball course at all
+        //
+        const double max_reach = reachDistance( i, elapsed + max_step ) + o.catch_bonus_;
+        if ( ball_move.dist( o.pos_ ) > max_reach )
+        {
+            continue;
+        }
+
+        for ( int step = 1; step < min_step; ++step )
+        {
+            const Vector2D ball_pos = ball_kinematics.inertiaPoint( first_ball_pos,
+                                                                    first_ball_vel,
+                                                                    step );
+            double reach_dist = reachDistance( i, elapsed + step );
+            if ( o.catch_bonus_ > 0.0
+                 && ball_pos.x > SP.theirPenaltyAreaLineX()
+                 && ball_pos.absY() < SP.penaltyAreaHalfWidth() )
+            {
+                reach_dist += o.catch_bonus_;
+            }
+
+            if ( ball_pos.dist2( o.pos_ ) <= reach_dist * reach_dist )
+            {
+                min_step = step;
+                if ( opponent ) *opponent = o.player_;
+                break;
+            }
+        }
+    }
+
+    return min_step;
+}
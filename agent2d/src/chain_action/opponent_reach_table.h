@@ -0,0 +1,144 @@
+// -*-c++-*-
+
+/*!
+  \file opponent_reach_table.h
+  \brief approximate opponent reach distance table Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef OPPONENT_REACH_TABLE_H
+#define OPPONENT_REACH_TABLE_H
+
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/game_time.h>
+
+#include <vector>
+
+namespace rcsc {
+class AbstractPlayerObject;
+class WorldModel;
+}
+
+/*!
+  \class OpponentReachTable
+  \brief approximate opponent interception table for the predicted states.
+
+  For each opponent, the distance that the player can cover in n steps
+  (control area + uncertainty radius of PlayerStateFusion, capped by the
+  count based observation bonus + full power dashes after one reaction
+  step) is precomputed once per cycle. The
+  opponent position is also taken from PlayerStateFusion. A ball course
+  is then checked only by the distance between the ball position and the
+  opponent position at each step. No per-course player simulation is
+  needed, so the check is cheap enough for the deeper actions of the
+  action chain search.
+
+  The opponents do not move in PredictState. Their movement before the
+  course starts is approximated by adding the elapsed steps of the state
+  to the reach step. The elapsed steps are capped by MAX_ELAPSED_STEP,
+  because the opponents also go back to their positions and the reach
+  area would cover the whole field otherwise.
+ */
+class OpponentReachTable {
+public:
+
+    //! max size of the table
+    static const int MAX_STEP = 50;
+    //! max number of elapsed steps added to the reach step
+    static const int MAX_ELAPSED_STEP = 10;
+
+private:
+
+    struct Opponent {
+        const rcsc::AbstractPlayerObject * player_; //!< original object
+        rcsc::Vector2D pos_; //!< estimated final position
+        double catch_bonus_; //!< additional control area in the penalty area (goalie only)
+    };
+
+    rcsc::GameTime M_update_time;
+
+    std::vector< Opponent > M_opponents;
+    //! reach distance. index = opponent * ( MAX_STEP + 1 ) + step
+    std::vector< double > M_reach_dist;
+
+    // private for singleton
+    OpponentReachTable();
+
+    // not used
+    OpponentReachTable( const OpponentReachTable & );
+    OpponentReachTable & operator=( const OpponentReachTable & );
+
+public:
+
+    static
+    OpponentReachTable & instance();
+
+    /*!
+      \brief update the table for the current world. the table is
+      created only once per cycle.
+      \param wm world model reference
+     */
+    void update( const rcsc::WorldModel & wm );
+
+    /*!
+      \brief get the number of registered opponents
+      \return the number of opponents
+     */
+    size_t size() const
+      {
+          return M_opponents.size();
+      }
+
+    /*!
+      \brief get the reach distance of the opponent
+      \param i opponent index
+      \param step number of steps from the current time
+      \return reach distance
+     */
+    double reachDistance( const size_t i,
+                          const int step ) const
+      {
+          return M_reach_dist[i * ( MAX_STEP + 1 )
+                              + ( step < 0 ? 0 : step > MAX_STEP ? MAX_STEP : step )];
+      }
+
+    /*!
+      \brief estimate the first step when any opponent can reach the moving ball
+      \param first_ball_pos ball position at the start of the course
+      \param first_ball_vel first ball velocity
+      \param elapsed_step steps from the current time to the start of the course
+      \param max_step max ball step to be checked
+      \param opponent the reached opponent is set if not null
+      \return ball step when the ball is reached. max_step + 1 if not reached.
+     */
+    int predictReachStep( const rcsc::Vector2D & first_ball_pos,
+                          const rcsc::Vector2D & first_ball_vel,
+                          const int elapsed_step,
+                          const int max_step,
+                          const rcsc::AbstractPlayerObject ** opponent ) const;
+};
+
+#endif
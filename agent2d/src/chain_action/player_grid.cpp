@@ -0,0 +1,480 @@
+// -*-c++-*-
+
+/*!
+  \file player_grid.cpp
+  \brief uniform grid spatial index of players Source File
+*/
+
+/*
+ *Copyright:
+
+  Copyright (C) robOTTO team
+
+  This code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this code; see the file COPYING.  If not, write to
+  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "player_grid.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+using namespace rcsc;
+
+const double PlayerGrid::CELL_SIZE = 8.0; // Magic Number
+
+namespace {
+
+// covered area. players out of this area are stored in the border cells.
+const double GRID_HALF_LENGTH = 60.0;
+const double GRID_HALF_WIDTH = 40.0;
+
+//! max number of cells in one ring
+const int MAX_RING_CELLS = 128;
+//! max k of nearestK()
+const int MAX_K = 22;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+bool
+is_valid_count( const int pos_count,
+                const int count_thr )
+{
+    return count_thr < 0 || pos_count <= count_thr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the cells on the ring around (cx, cy).
+  \return the number of cells
+ */
+int
+get_ring_cells( const int cx,
+                const int cy,
+                const int ring,
+                const int cols,
+                const int rows,
+                int * cells )
+{
+    int n = 0;
+
+    for ( int y = cy - ring; y <= cy + ring; ++y )
+    {
+        if ( y < 0 || rows <= y ) continue;
+
+        const bool edge_row = ( y == cy - ring || y == cy + ring );
+        const int step = ( edge_row || ring == 0 ? 1 : 2 * ring );
+
+        for ( int x = cx - ring; x <= cx + ring; x += step )
+        {
+            if ( x < 0 || cols <= x ) continue;
+
+            if ( n < MAX_RING_CELLS )
+            {
+                cells[n++] = y * cols + x;
+            }
+        }
+    }
+
+    return n;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+PlayerGrid::PlayerGrid()
+    : M_min_x( -GRID_HALF_LENGTH ),
+      M_min_y( -GRID_HALF_WIDTH ),
+      M_cols( static_cast< int >( std::ceil( GRID_HALF_LENGTH * 2.0 / CELL_SIZE ) ) ),
+      M_rows( static_cast< int >( std::ceil( GRID_HALF_WIDTH * 2.0 / CELL_SIZE ) ) )
+{
+    M_entries.reserve( 32 );
+    M_unsorted.reserve( 32 );
+    M_cell_begin.assign( M_cols * M_rows + 1, 0 );
+    M_cell_of_entry.reserve( 32 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+PlayerGrid::cellX( const double & x ) const
+{
+    int c = static_cast< int >( std::floor( ( x - M_min_x ) / CELL_SIZE ) );
+    return std::min( std::max( c, 0 ), M_cols - 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+PlayerGrid::cellY( const double & y ) const
+{
+    int c = static_cast< int >( std::floor( ( y - M_min_y ) / CELL_SIZE ) );
+    return std::min( std::max( c, 0 ), M_rows - 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerGrid::build( const PlayerCont & players )
+{
+    clearEntries();
+
+    const PlayerCont::const_iterator end = players.end();
+    for ( PlayerCont::const_iterator it = players.begin();
+          it != end;
+          ++it )
+    {
+        addEntry( *it );
+    }
+
+    sortEntries();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerGrid::build( const PlayerPtrCont & players )
+{
+    clearEntries();
+
+    const PlayerPtrCont::const_iterator end = players.end();
+    for ( PlayerPtrCont::const_iterator it = players.begin();
+          it != end;
+          ++it )
+    {
+        addEntry( **it );
+    }
+
+    sortEntries();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerGrid::clearEntries()
+{
+    M_unsorted.clear();
+    M_cell_of_entry.clear();
+
+    std::fill( M_cell_begin.begin(), M_cell_begin.end(), 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerGrid::addEntry( const PlayerObject & player )
+{
+    if ( player.isGhost() )
+    {
+        return;
+    }
+
+    Entry e;
+    e.x_ = player.pos().x;
+    e.y_ = player.pos().y;
+    e.pos_count_ = player.posCount();
+    e.player_ = &player;
+
+    const int cell = cellY( e.y_ ) * M_cols + cellX( e.x_ );
+    M_unsorted.push_back( e );
+    M_cell_of_entry.push_back( cell );
+    ++M_cell_begin[cell + 1];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerGrid::sortEntries()
+{
+    //
+    // counting sort by cell
+    //
+    for ( size_t c = 1; c < M_cell_begin.size(); ++c )
+    {
+        M_cell_begin[c] += M_cell_begin[c - 1];
+    }
+
+    M_entries.resize( M_unsorted.size() );
+
+    std::vector< int > next( M_cell_begin.begin(), M_cell_begin.end() - 1 );
+    for ( size_t i = 0; i < M_unsorted.size(); ++i )
+    {
+        M_entries[ next[M_cell_of_entry[i]]++ ] = M_unsorted[i];
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+PlayerGrid::isCovered( const int cx,
+                       const int cy,
+                       const int ring ) const
+{
+    return ( cx - ring <= 0
+             && cx + ring >= M_cols - 1
+             && cy - ring <= 0
+             && cy + ring >= M_rows - 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PlayerGrid::ringBound( const Vector2D & point,
+                       const int cx,
+                       const int cy,
+                       const int ring ) const
+{
+    const double min_x = M_min_x + ( cx - ring ) * CELL_SIZE;
+    const double max_x = M_min_x + ( cx + ring + 1 ) * CELL_SIZE;
+    const double min_y = M_min_y + ( cy - ring ) * CELL_SIZE;
+    const double max_y = M_min_y + ( cy + ring + 1 ) * CELL_SIZE;
+
+    return std::min( std::min( point.x - min_x, max_x - point.x ),
+                     std::min( point.y - min_y, max_y - point.y ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const PlayerObject *
+PlayerGrid::nearest( const Vector2D & point,
+                     const int count_thr,
+                     double * result_dist ) const
+{
+    const PlayerObject * result = static_cast< const PlayerObject * >( 0 );
+
+    if ( nearestK( point, 1, count_thr, &result, result_dist ) == 0 )
+    {
+        if ( result_dist ) *result_dist = std::numeric_limits< double >::max();
+        return static_cast< const PlayerObject * >( 0 );
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+PlayerGrid::nearestK( const Vector2D & point,
+                      const int k,
+                      const int count_thr,
+                      const PlayerObject ** result,
+                      double * result_dist ) const
+{
+    const int max_k = std::min( k, MAX_K );
+    if ( max_k <= 0
+         || M_entries.empty() )
+    {
+        return 0;
+    }
+
+    double best_d2[MAX_K];
+    int n = 0;
+
+    const int cx = cellX( point.x );
+    const int cy = cellY( point.y );
+
+    int cells[MAX_RING_CELLS];
+
+    for ( int ring = 0; ; ++ring )
+    {
+        const int n_cells = get_ring_cells( cx, cy, ring, M_cols, M_rows, cells );
+
+        for ( int c = 0; c < n_cells; ++c )
+        {
+            const int last = M_cell_begin[cells[c] + 1];
+            for ( int i = M_cell_begin[cells[c]]; i < last; ++i )
+            {
+                const Entry & e = M_entries[i];
+                if ( ! is_valid_count( e.pos_count_, count_thr ) ) continue;
+
+                const double dx = e.x_ - point.x;
+                const double dy = e.y_ - point.y;
+                const double d2 = dx * dx + dy * dy;
+
+                if ( n == max_k
+                     && d2 >= best_d2[n - 1] )
+                {
+                    continue;
+                }
+
+                // insertion into the sorted result
+                int j = ( n < max_k ? n++ : n - 1 );
+                while ( j > 0 && best_d2[j - 1] > d2 )
+                {
+                    best_d2[j] = best_d2[j - 1];
+                    result[j] = result[j - 1];
+                    --j;
+                }
+                best_d2[j] = d2;
+                result[j] = e.player_;
+            }
+        }
+
+        if ( isCovered( cx, cy, ring ) )
+        {
+            break;
+        }
+
+        if ( n == max_k )
+        {
+            const double bound = ringBound( point, cx, cy, ring );
+            if ( bound > 0.0
+                 && best_d2[n - 1] <= bound * bound )
+            {
+                break;
+            }
+        }
+    }
+
+    if ( result_dist )
+    {
+        for ( int i = 0; i < n; ++i )
+        {
+            result_dist[i] = std::sqrt( best_d2[i] );
+        }
+    }
+
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+PlayerGrid::withinRadius( const Vector2D & point,
+                          const double & radius,
+                          const int count_thr,
+                          std::vector< const PlayerObject * > * result ) const
+{
+    const double r2 = radius * radius;
+    const int min_cx = cellX( point.x - radius );
+    const int max_cx = cellX( point.x + radius );
+    const int min_cy = cellY( point.y - radius );
+    const int max_cy = cellY( point.y + radius );
+
+    int n = 0;
+
+    for ( int y = min_cy; y <= max_cy; ++y )
+    {
+        for ( int x = min_cx; x <= max_cx; ++x )
+        {
+            const int cell = y * M_cols + x;
+            const int last = M_cell_begin[cell + 1];
+            for ( int i = M_cell_begin[cell]; i < last; ++i )
+            {
+                const Entry & e = M_entries[i];
+                if ( ! is_valid_count( e.pos_count_, count_thr ) ) continue;
+
+                const double dx = e.x_ - point.x;
+                const double dy = e.y_ - point.y;
+                if ( dx * dx + dy * dy <= r2 )
+                {
+                    result->push_back( e.player_ );
+                    ++n;
+                }
+            }
+        }
+    }
+
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const PlayerObject *
+PlayerGrid::nearestToSegment( const Segment2D & segment,
+                              const int count_thr,
+                              double * result_dist ) const
+{
+    // the number of players is small, so all entries are checked
+    // in the contiguous array.
+    const double ox = segment.origin().x;
+    const double oy = segment.origin().y;
+    const double vx = segment.terminal().x - ox;
+    const double vy = segment.terminal().y - oy;
+    const double len2 = vx * vx + vy * vy;
+
+    const PlayerObject * result = static_cast< const PlayerObject * >( 0 );
+    double min_d2 = std::numeric_limits< double >::max();
+
+    const std::vector< Entry >::const_iterator end = M_entries.end();
+    for ( std::vector< Entry >::const_iterator e = M_entries.begin();
+          e != end;
+          ++e )
+    {
+        if ( ! is_valid_count( e->pos_count_, count_thr ) ) continue;
+
+        const double wx = e->x_ - ox;
+        const double wy = e->y_ - oy;
+        double t = ( len2 > 0.0 ? ( wx * vx + wy * vy ) / len2 : 0.0 );
+        t = std::max( 0.0, std::min( 1.0, t ) );
+
+        const double dx = wx - t * vx;
+        const double dy = wy - t * vy;
+        const double d2 = dx * dx + dy * dy;
+
+        if ( d2 < min_d2 )
+        {
+            min_d2 = d2;
+            result = e->player_;
+        }
+    }
+
+    if ( result_dist )
+    {
+        *result_dist = ( result ? std::sqrt( min_d2 ) : std::numeric_limits< double >::max() );
+    }
+
+    return result;
+}
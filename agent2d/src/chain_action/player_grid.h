@@ -0,0 +1,175 @@
+// -*-c++-*-
+
+/*!
+  \file player_grid.h
+  \brief uniform grid spatial index of players Header File
+*/
+
+/*
+ *Copyright:
+
+  Copyright (C) robOTTO team
+
+  This code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this code; see the file COPYING.  If not, write to
+  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef PLAYER_GRID_H
+#define PLAYER_GRID_H
+
+#include <rcsc/player/player_object.h>
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/segment_2d.h>
+
+#include <vector>
+
+/*!
+  \class PlayerGrid
+  \brief per-cycle uniform grid index of the players of one side.
+
+  The players are bucketed into square cells covering the field. The
+  entries are sorted by cell in one contiguous array. Nearest, nearest-k
+  and within-radius queries visit the cells ring by ring and stop when
+  no closer player can exist. Every query takes an accuracy count
+  threshold. Players whose posCount() is greater than the threshold are
+  ignored. -1 means no filter.
+ */
+class PlayerGrid {
+public:
+
+    //! cell edge length
+    static const double CELL_SIZE;
+
+    struct Entry {
+        double x_;
+        double y_;
+        int pos_count_;
+        const rcsc::PlayerObject * player_;
+    };
+
+private:
+
+    double M_min_x; //!< left edge of the grid
+    double M_min_y; //!< top edge of the grid
+    int M_cols;
+    int M_rows;
+
+    std::vector< Entry > M_entries; //!< players sorted by cell
+    std::vector< int > M_cell_begin; //!< first entry index of each cell (+ sentinel)
+    std::vector< Entry > M_unsorted; //!< work area used by build()
+    std::vector< int > M_cell_of_entry; //!< work area used by build()
+
+public:
+
+    PlayerGrid();
+
+    /*!
+      \brief rebuild the index. ghost players are skipped.
+      \param players source container
+     */
+    void build( const rcsc::PlayerCont & players );
+
+    /*!
+      \brief rebuild the index. ghost players are skipped.
+      \param players source pointer container
+     */
+    void build( const rcsc::PlayerPtrCont & players );
+
+    /*!
+      \brief get all indexed players.
+      \return entries sorted by cell
+     */
+    const std::vector< Entry > & entries() const
+      {
+          return M_entries;
+      }
+
+    /*!
+      \brief get the player nearest to the point.
+      \param point target point
+      \param count_thr accuracy count threshold
+      \param result_dist variable to store the distance (may be NULL)
+      \return player pointer or NULL
+     */
+    const rcsc::PlayerObject * nearest( const rcsc::Vector2D & point,
+                                        const int count_thr,
+                                        double * result_dist ) const;
+
+    /*!
+      \brief get the k players nearest to the point.
+      \param point target point
+      \param k the number of players
+      \param count_thr accuracy count threshold
+      \param result array of size k to store the players (nearest first)
+      \param result_dist array of size k to store the distances (may be NULL)
+      \return the number of the found players
+     */
+    int nearestK( const rcsc::Vector2D & point,
+                  const int k,
+                  const int count_thr,
+                  const rcsc::PlayerObject ** result,
+                  double * result_dist ) const;
+
+    /*!
+      \brief get the players within the radius from the point.
+      \param point target point
+      \param radius search radius
+      \param count_thr accuracy count threshold
+      \param result container to store the players (not cleared)
+      \return the number of the found players
+     */
+    int withinRadius( const rcsc::Vector2D & point,
+                      const double & radius,
+                      const int count_thr,
+                      std::vector< const rcsc::PlayerObject * > * result ) const;
+
+    /*!
+      \brief get the player nearest to the segment.
+      \param segment target segment
+      \param count_thr accuracy count threshold
+      \param result_dist variable to store the distance (may be NULL)
+      \return player pointer or NULL
+     */
+    const rcsc::PlayerObject * nearestToSegment( const rcsc::Segment2D & segment,
+                                                 const int count_thr,
+                                                 double * result_dist ) const;
+
+private:
+
+    void clearEntries();
+    void addEntry( const rcsc::PlayerObject & player );
+    void sortEntries();
+
+    int cellX( const double & x ) const;
+    int cellY( const double & y ) const;
+
+    /*!
+      \brief get the minimum distance from the point to the outside of
+      the cell block of the given ring.
+     */
+    double ringBound( const rcsc::Vector2D & point,
+                      const int cx,
+                      const int cy,
+                      const int ring ) const;
+
+    bool isCovered( const int cx,
+                    const int cy,
+                    const int ring ) const;
+};
+
+#endif
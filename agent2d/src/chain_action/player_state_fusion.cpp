@@ -0,0 +1,297 @@
+// -*-c++-*-
+
+/*!
+  \file player_state_fusion.cpp
+  \brief fused position uncertainty of the players Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "player_state_fusion.h"
+
+#include "packed_say_message.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/player/abstract_player_object.h>
+#include <rcsc/common/logger.h>
+
+#include <algorithm>
+#include <cmath>
+
+// #define DEBUG_PRINT
+
+using namespace rcsc;
+
+namespace {
+
+//! variance added every cycle (player movement)
+const double PROCESS_VARIANCE = std::pow( 0.6, 2 ); // Magic Number
+//! error of the seen position per distance
+const double SEEN_ERROR_RATE = 0.03; // Magic Number
+const double SEEN_ERROR_MIN = 0.1; // Magic Number
+//! radius = RADIUS_RATE * standard deviation
+const double RADIUS_RATE = 2.0; // Magic Number
+const double MAX_VARIANCE = std::pow( 20.0, 2 ); // Magic Number
+//! max count used to estimate the variance
+const int MAX_COUNT = 100; // Magic Number
+//! the entry is initialized again if it is not updated for this steps
+const int RESET_STEP = 10; // Magic Number
+
+inline
+double
+seen_variance( const AbstractPlayerObject & player )
+{
+    return std::pow( SEEN_ERROR_MIN + SEEN_ERROR_RATE * player.distFromSelf(), 2 );
+}
+
+/*!
+  \brief get the variance of the heard position.
+  the sender selects the coarsest grid step not larger than twice its
+  own error, so the sender's error and the rounding error are both about
+  the step. a position heard by another message gets the coarsest step.
+ */
+inline
+double
+heard_variance( const AbstractPlayerObject & player,
+                const SideID our_side,
+                const GameTime & time )
+{
+    const int number = ( player.side() == our_side
+                         ? player.unum()
+                         : player.unum() + 11 );
+    return std::pow( PackedObjectMessageParser::heard_pos_step( number, time ), 2 );
+}
+
+/*!
+  \brief fuse the measurement into the entry
+ */
+inline
+void
+fuse( const Vector2D & measured_pos,
+      const double & measured_variance,
+      Vector2D * pos,
+      double * variance )
+{
+    const double gain = *variance / ( *variance + measured_variance );
+    *pos += ( measured_pos - *pos ) * gain;
+    *variance *= ( 1.0 - gain );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+PlayerStateFusion::PlayerStateFusion()
+    : M_update_time( -1, 0 ),
+      M_our_side( NEUTRAL )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+PlayerStateFusion &
+PlayerStateFusion::instance()
+{
+    static PlayerStateFusion s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerStateFusion::update( const WorldModel & wm )
+{
+    if ( M_update_time == wm.time() )
+    {
+        return;
+    }
+    M_update_time = wm.time();
+    M_our_side = wm.ourSide();
+
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        const AbstractPlayerObject * t = wm.ourPlayer( unum );
+        if ( t )
+        {
+            updateEntry( wm, *t, M_teammates[unum] );
+        }
+
+        const AbstractPlayerObject * o = wm.theirPlayer( unum );
+        if ( o )
+        {
+            updateEntry( wm, *o, M_opponents[unum] );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerStateFusion::updateEntry( const WorldModel & wm,
+                                const AbstractPlayerObject & player,
+                                Entry & entry )
+{
+    if ( player.isSelf() )
+    {
+        entry.pos_ = player.pos();
+        entry.variance_ = 0.0;
+        entry.time_ = wm.time();
+        return;
+    }
+
+    const long step = wm.time().cycle() - entry.time_.cycle();
+
+    if ( entry.time_.cycle() < 0
+         || ! entry.pos_.isValid()
+         || step > RESET_STEP
+         || player.isGhost() )
+    {
+        entry.pos_ = player.pos();
+        entry.variance_ = estimate_variance( player );
+    }
+    else
+    {
+        //
+        // prediction. the players move even if the time is stopped.
+        //
+        entry.pos_ += player.vel();
+        entry.variance_ += PROCESS_VARIANCE * std::max( 1L, step );
+
+        //
+        // measurements
+        //
+        if ( player.seenPosCount() == 0 )
+        {
+            fuse( player.seenPos(), seen_variance( player ),
+                  &entry.pos_, &entry.variance_ );
+        }
+
+        if ( player.heardPosCount() == 0 )
+        {
+            fuse( player.heardPos(), heard_variance( player, wm.ourSide(), wm.time() ),
+                  &entry.pos_, &entry.variance_ );
+        }
+    }
+
+    entry.variance_ = std::min( entry.variance_, MAX_VARIANCE );
+    entry.time_ = wm.time();
+
+#ifdef DEBUG_PRINT
+    dlog.addText( Logger::WORLD,
+                  __FILE__": (updateEntry) %s %d wm=(%.2f %.2f) fused=(%.2f %.2f) radius=%.2f",
+                  player.side() == wm.ourSide() ? "teammate" : "opponent",
+                  player.unum(),
+                  player.pos().x, player.pos().y,
+                  entry.pos_.x, entry.pos_.y,
+                  RADIUS_RATE * std::sqrt( entry.variance_ ) );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const PlayerStateFusion::Entry *
+PlayerStateFusion::getEntry( const AbstractPlayerObject & player ) const
+{
+    if ( player.unum() < 1 || 11 < player.unum() )
+    {
+        return static_cast< const Entry * >( 0 );
+    }
+
+    const Entry & entry = ( player.side() == M_our_side
+                            ? M_teammates[player.unum()]
+                            : M_opponents[player.unum()] );
+
+    if ( entry.time_ != M_update_time )
+    {
+        return static_cast< const Entry * >( 0 );
+    }
+
+    return &entry;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2D
+PlayerStateFusion::position( const AbstractPlayerObject & player ) const
+{
+    const Entry * entry = getEntry( player );
+    return ( entry
+             ? entry->pos_
+             : player.pos() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PlayerStateFusion::radius( const AbstractPlayerObject & player ) const
+{
+    const Entry * entry = getEntry( player );
+    return RADIUS_RATE * std::sqrt( entry
+                                    ? entry->variance_
+                                    : estimate_variance( player ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PlayerStateFusion::estimate_variance( const AbstractPlayerObject & player )
+{
+    if ( player.isSelf() )
+    {
+        return 0.0;
+    }
+
+    const double seen_var = seen_variance( player )
+        + PROCESS_VARIANCE * std::min( player.seenPosCount(), MAX_COUNT );
+    // the heard time is unknown here, so the coarsest step is used.
+    const double heard_var
+        = std::pow( PackedObjectMessage::get_pos_step( PackedObjectMessage::STEP_LEVEL_SIZE - 1 ), 2 )
+        + PROCESS_VARIANCE * std::min( player.heardPosCount(), MAX_COUNT );
+
+    return std::min( 1.0 / ( 1.0 / seen_var + 1.0 / heard_var ),
+                     MAX_VARIANCE );
+}
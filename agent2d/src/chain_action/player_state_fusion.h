@@ -0,0 +1,154 @@
+// -*-c++-*-
+
+/*!
+  \file player_state_fusion.h
+  \brief fused position uncertainty of the players Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifndef PLAYER_STATE_FUSION_H
+#define PLAYER_STATE_FUSION_H
+
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/game_time.h>
+#include <rcsc/types.h>
+
+namespace rcsc {
+class AbstractPlayerObject;
+class WorldModel;
+}
+
+/*!
+  \class PlayerStateFusion
+  \brief position and its uncertainty of each player fused from the
+  seen and heard information.
+
+  The world model uses the heard position as it is when it is newer than
+  the seen one. Instead, this class keeps a position and an isotropic
+  covariance (variance) for each player with a known uniform number, and
+  updates them once per cycle like a Kalman filter:
+  - the variance grows by a process noise every cycle,
+  - a new seen position is fused with an error that grows with the
+    distance from self,
+  - a new heard position is fused with the quantization step of the
+    message (the coarsest step if it is unknown).
+
+  The generators use radius() as the uncertainty of the player, e.g.
+  an interception check adds it to the reach distance, and a player is
+  dropped only if the radius is too large. A player with a recent heard
+  position keeps a small radius even if it has not been seen for a
+  while, so more players remain valid than with a position count
+  threshold.
+
+  update() has to be called before the action generators run, because
+  they read this table concurrently.
+ */
+class PlayerStateFusion {
+public:
+
+    /*!
+      \struct Entry
+      \brief fused state of a player.
+     */
+    struct Entry {
+        rcsc::GameTime time_; //!< last updated time
+        rcsc::Vector2D pos_; //!< fused position
+        double variance_; //!< variance of each axis
+
+        Entry()
+            : time_( -1, 0 ),
+              pos_( rcsc::Vector2D::INVALIDATED ),
+              variance_( 0.0 )
+          { }
+    };
+
+private:
+
+    rcsc::GameTime M_update_time;
+    rcsc::SideID M_our_side;
+
+    //! entries indexed by the uniform number
+    Entry M_teammates[12];
+    Entry M_opponents[12];
+
+    // private for singleton
+    PlayerStateFusion();
+
+    // not used
+    PlayerStateFusion( const PlayerStateFusion & );
+    PlayerStateFusion & operator=( const PlayerStateFusion & );
+
+public:
+
+    static
+    PlayerStateFusion & instance();
+
+    static
+    const PlayerStateFusion & i()
+      {
+          return instance();
+      }
+
+    /*!
+      \brief update the entries. it is done only once per cycle.
+      \param wm world model reference
+     */
+    void update( const rcsc::WorldModel & wm );
+
+    /*!
+      \brief get the fused position of the player.
+      \param player player object
+      \return fused position, or the world model position if not tracked
+     */
+    rcsc::Vector2D position( const rcsc::AbstractPlayerObject & player ) const;
+
+    /*!
+      \brief get the uncertainty radius of the player position.
+      \param player player object
+      \return radius (twice the standard deviation)
+     */
+    double radius( const rcsc::AbstractPlayerObject & player ) const;
+
+    /*!
+      \brief estimate the variance from the counters of the player.
+      it is used for the players without the uniform number.
+      \param player player object
+      \return variance of each axis
+     */
+    static
+    double estimate_variance( const rcsc::AbstractPlayerObject & player );
+
+private:
+
+    const Entry * getEntry( const rcsc::AbstractPlayerObject & player ) const;
+
+    void updateEntry( const rcsc::WorldModel & wm,
+                      const rcsc::AbstractPlayerObject & player,
+                      Entry & entry );
+};
+
+#endif
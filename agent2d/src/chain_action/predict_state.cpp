@@ -35,6 +35,8 @@
 
 #include "predict_state.h"
 
+#include "player_state_fusion.h"
+
 #include <rcsc/common/server_param.h>
 
 #include <algorithm>
@@ -43,7 +45,7 @@ using namespace rcsc;
 
 //#define STRICT_LINE_UPDATE
 
-const int PredictState::VALID_PLAYER_THRESHOLD = 8;
+const double PredictState::VALID_PLAYER_RADIUS = 3.5;
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -154,10 +156,22 @@ PredictState::init( const WorldModel & wm )
     //
     // initialize ball holder
     //
-    const AbstractPlayerObject * h = wm.getTeammateNearestToBall( VALID_PLAYER_THRESHOLD );
+    const PlayerStateFusion & fusion = PlayerStateFusion::i();
+
+    const AbstractPlayerObject * h = static_cast< const AbstractPlayerObject * >( 0 );
+    for ( PlayerPtrCont::const_iterator t = wm.teammatesFromBall().begin(), end = wm.teammatesFromBall().end();
+          t != end;
+          ++t )
+    {
+        if ( fusion.radius( **t ) <= VALID_PLAYER_RADIUS )
+        {
+            h = *t;
+            break;
+        }
+    }
 
     if ( h
-         && wm.ball().pos().dist2( h->pos() ) < wm.ball().pos().dist2( wm.self().pos() ) )
+         && wm.ball().pos().dist2( fusion.position( *h ) ) < wm.ball().pos().dist2( wm.self().pos() ) )
     {
         M_ball_holder_unum = h->unum();
     }
@@ -185,7 +199,7 @@ PredictState::init( const WorldModel & wm )
 
             if ( t )
             {
-                ptr = PredictPlayerObject::Ptr( new PredictPlayerObject( *t ) );
+                ptr = PredictPlayerObject::Ptr( new PredictPlayerObject( *t, fusion.position( *t ) ) );
 
             }
             else
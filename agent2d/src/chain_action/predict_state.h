@@ -47,7 +47,8 @@
 
 class PredictState {
 public:
-    static const int VALID_PLAYER_THRESHOLD;
+    //! max uncertainty radius (PlayerStateFusion) of the valid teammates
+    static const double VALID_PLAYER_RADIUS;
 
     typedef boost::shared_ptr< PredictState > Ptr; //!< pointer type alias
     typedef boost::shared_ptr< const PredictState > ConstPtr; //!< const pointer type alias
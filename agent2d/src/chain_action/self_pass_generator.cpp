@@ -36,6 +36,7 @@
 #include "self_pass_generator.h"
 
 #include "dribble.h"
+#include "dash_trajectory_table.h"
 #include "field_analyzer.h"
 
 #include <rcsc/action/kick_table.h>
@@ -142,6 +143,8 @@ SelfPassGenerator::generate( const WorldModel & wm )
     Timer timer;
 #endif
 
+    M_budget.start();
+
     createCourses( wm );
 
     std::sort( M_courses.begin(), M_courses.end(),
@@ -149,9 +152,10 @@ SelfPassGenerator::generate( const WorldModel & wm )
 
 #ifdef DEBUG_PROFILE
     dlog.addText( Logger::DRIBBLE,
-                  __FILE__": (generate) PROFILE size=%d/%d elapsed %.3f [ms]",
+                  __FILE__": (generate) PROFILE size=%d/%d%s elapsed %.3f [ms]",
                   (int)M_courses.size(),
                   M_total_count,
+                  ( M_budget.truncated() ? " (truncated)" : "" ),
                   timer.elapsedReal() );
 #endif
 }
@@ -189,8 +193,12 @@ SelfPassGenerator::createCourses( const WorldModel & wm )
     const Vector2D our_goal = ServerParam::i().ourTeamGoalPos();
     const double goal_dist_thr2 = std::pow( 18.0, 2 ); // Magic Number
 
-    for ( int a = 0; a < ANGLE_DIVS; ++a )
+    //
+    // angle loop. the directions near the body angle are tried first.
+    //
+    for ( int i = 0; i < ANGLE_DIVS; ++i )
     {
+        const int a = ( ANGLE_DIVS + GeneratorBudget::alternate_offset( i ) ) % ANGLE_DIVS;
         const double add_angle = ANGLE_STEP * a;
 
         int n_turn = 0;
@@ -223,6 +231,14 @@ SelfPassGenerator::createCourses( const WorldModel & wm )
             continue;
         }
 
+        if ( ! M_budget.consume() )
+        {
+            dlog.addText( Logger::DRIBBLE,
+                          __FILE__": (createCourses) truncated by budget. count=%d elapsed %.3f [ms]",
+                          M_budget.count(), M_budget.elapsed() );
+            break;
+        }
+
         createSelfCache( wm, dash_angle,
                          n_turn, max_dash,
                          self_cache );
@@ -348,6 +364,17 @@ SelfPassGenerator::createSelfCache( const WorldModel & wm,
                                  ? -ptype.extraStamina() // minus value to set available stamina
                                  : ServerParam::i().recoverDecThrValue() + 350.0 );
 
+    const DashTrajectoryTable & table = DashTrajectoryTable::instance();
+    if ( table.hasTable( ptype, 1 + n_turn + n_dash )
+         && DashTrajectoryTable::is_full_stamina_band( ptype,
+                                                       wm.self().staminaModel(),
+                                                       stamina_thr,
+                                                       n_dash ) )
+    {
+        createSelfCacheByTable( wm, dash_angle, n_turn, n_dash, self_cache );
+        return;
+    }
+
     StaminaModel stamina_model = wm.self().staminaModel();
 
     Vector2D my_pos = wm.self().pos();
@@ -448,6 +475,76 @@ SelfPassGenerator::createSelfCache( const WorldModel & wm,
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SelfPassGenerator::createSelfCacheByTable( const WorldModel & wm,
+                                           const AngleDeg & dash_angle,
+                                           const int n_turn,
+                                           const int n_dash,
+                                           std::vector< Vector2D > & self_cache )
+{
+    const ServerParam & SP = ServerParam::i();
+    const PlayerType & ptype = wm.self().playerType();
+    const DashTrajectoryTable & table = DashTrajectoryTable::instance();
+
+    const Vector2D first_pos = wm.self().pos();
+    const Vector2D first_vel = wm.self().vel();
+
+    //
+    // 1 kick + turns
+    //
+    for ( int i = 0; i < n_turn; ++i )
+    {
+        self_cache.push_back( first_pos + first_vel * table.inertiaRate( ptype, 2 + i ) );
+    }
+
+    //
+    // dashes by the max power
+    //
+    const Vector2D dash_accel
+        = Vector2D::polar2vector( SP.maxDashPower() * ptype.dashPowerRate()
+                                  * wm.self().staminaModel().effort(),
+                                  dash_angle );
+
+    for ( int i = 1; i <= n_dash; ++i )
+    {
+        const Vector2D my_pos = first_pos
+            + first_vel * table.inertiaRate( ptype, 1 + n_turn + i )
+            + dash_accel * table.dashRate( ptype, i );
+
+        if ( my_pos.x > SP.pitchHalfLength() - 2.5 )
+        {
+#ifdef DEBUG_PRINT_SELF_CACHE
+            dlog.addText( Logger::DRIBBLE,
+                          "?: SelfPass (createSelfCacheByTable) turn=%d dash=%d. my_x=%.2f. over goal line",
+                          n_turn, n_dash, my_pos.x );
+#endif
+            break;
+        }
+
+        if ( my_pos.absY() > SP.pitchHalfWidth() - 3.0
+             && ( ( my_pos.y > 0.0 && dash_angle.degree() > 0.0 )
+                  || ( my_pos.y < 0.0 && dash_angle.degree() < 0.0 ) )
+             )
+        {
+#ifdef DEBUG_PRINT_SELF_CACHE
+            dlog.addText( Logger::DRIBBLE,
+                          "?: SelfPass (createSelfCacheByTable) turn=%d dash=%d."
+                          " my_pos=(%.2f %.2f). dash_angle=%.1f",
+                          n_turn, n_dash,
+                          my_pos.x, my_pos.y,
+                          dash_angle.degree() );
+#endif
+            break;
+        }
+
+        self_cache.push_back( my_pos );
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
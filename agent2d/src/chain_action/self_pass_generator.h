@@ -33,6 +33,7 @@
 #define SELF_PASS_GENERATOR_H
 
 #include "cooperative_action.h"
+#include "generator_budget.h"
 
 #include <rcsc/player/abstract_player_object.h>
 #include <rcsc/geom/vector_2d.h>
@@ -53,6 +54,8 @@ private:
 
     std::vector< CooperativeAction::Ptr > M_courses;
 
+    GeneratorBudget M_budget;
+
     // private for singleton
     SelfPassGenerator();
 
@@ -72,6 +75,26 @@ public:
           return M_courses;
       }
 
+    /*!
+      \brief set the search budget.
+      \param max_msec time limit [ms]. a non positive value means unlimited.
+      \param max_count the maximum number of dash directions.
+     */
+    void setBudget( const double & max_msec,
+                    const int max_count )
+      {
+          M_budget.setLimits( max_msec, max_count );
+      }
+
+    /*!
+      \brief check if the last search was cut by the budget.
+      \return true if the generated courses are a partial result.
+     */
+    bool truncated() const
+      {
+          return M_budget.truncated();
+      }
+
 private:
 
     void clear();
@@ -83,6 +106,11 @@ private:
                           const int n_turn,
                           const int n_dash,
                           std::vector< rcsc::Vector2D > & self_cache );
+    void createSelfCacheByTable( const rcsc::WorldModel & wm,
+                                 const rcsc::AngleDeg & dash_angle,
+                                 const int n_turn,
+                                 const int n_dash,
+                                 std::vector< rcsc::Vector2D > & self_cache );
 
     bool canKick( const rcsc::WorldModel & wm,
                   const int n_turn,
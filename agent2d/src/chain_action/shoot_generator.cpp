@@ -35,6 +35,7 @@
 
 #include "shoot_generator.h"
 
+#include "ball_kinematics.h"
 #include "field_analyzer.h"
 
 #include <rcsc/action/kick_table.h>
@@ -43,9 +44,14 @@
 #include <rcsc/player/intercept_table.h>
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
+#include <rcsc/common/player_type.h>
 #include <rcsc/math_util.h>
 #include <rcsc/timer.h>
 
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+
 #define SEARCH_UNTIL_MAX_SPEED_AT_SAME_POINT
 
 #define DEBUG_PROFILE
@@ -63,8 +69,11 @@ using namespace rcsc;
 
  */
 ShootGenerator::ShootGenerator()
+    : M_goalie( static_cast< const PlayerObject * >( 0 ) )
 {
     M_courses.reserve( 32 );
+    M_goalie_inertia_pos.reserve( 64 );
+    M_goalie_reach_dist.reserve( 64 );
 
     clear();
 }
@@ -89,6 +98,9 @@ ShootGenerator::clear()
 {
     M_total_count = 0;
     M_courses.clear();
+    M_goalie = static_cast< const PlayerObject * >( 0 );
+    M_goalie_inertia_pos.clear();
+    M_goalie_reach_dist.clear();
 }
 
 /*-------------------------------------------------------------------*/
@@ -156,7 +168,9 @@ ShootGenerator::generate( const WorldModel & wm )
         goal_r.x = wm.self().pos().x + 1.5;
     }
 
-    const int DIST_DIVS = 25;
+    updateGoalieEnvelope( wm );
+
+    const int DIST_DIVS = 31;
     const double dist_step = std::fabs( goal_l.y - goal_r.y ) / ( DIST_DIVS - 1 );
 
 #ifdef DEBUG_PRINT
@@ -165,12 +179,44 @@ ShootGenerator::generate( const WorldModel & wm )
                   goal_l.x, goal_l.y, goal_r.x, goal_r.y, dist_step );
 #endif
 
+    //
+    // the target points far from the goalie are tried first,
+    // so that the most promising courses survive even if the budget runs out.
+    //
+    const PlayerObject * goalie = wm.getOpponentGoalie();
+    const AngleDeg goalie_angle = ( goalie
+                                    ? ( goalie->pos() - M_first_ball_pos ).th()
+                                    : AngleDeg( 180.0 ) );
+
+    std::pair< double, int > search_order[DIST_DIVS];
     for ( int i = 0; i < DIST_DIVS; ++i )
     {
+        Vector2D target_point = goal_l;
+        target_point.y += dist_step * i;
+
+        search_order[i].first = ( goalie
+                                  ? -( ( target_point - M_first_ball_pos ).th() - goalie_angle ).abs()
+                                  : std::abs( i - DIST_DIVS / 2 ) );
+        search_order[i].second = i;
+    }
+    std::sort( search_order, search_order + DIST_DIVS );
+
+    M_budget.start();
+
+    for ( int i = 0; i < DIST_DIVS; ++i )
+    {
+        if ( ! M_budget.consume() )
+        {
+            dlog.addText( Logger::SHOOT,
+                          __FILE__": truncated by budget. count=%d elapsed %.3f [ms]",
+                          M_budget.count(), M_budget.elapsed() );
+            break;
+        }
+
         ++M_total_count;
 
         Vector2D target_point = goal_l;
-        target_point.y += dist_step * i;
+        target_point.y += dist_step * search_order[i].second;
 
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::SHOOT,
@@ -187,14 +233,74 @@ ShootGenerator::generate( const WorldModel & wm )
 
 #ifdef DEBUG_PROFILE
     dlog.addText( Logger::SHOOT,
-                  __FILE__": PROFILE %d/%d. elapsed=%.3f [ms]",
+                  __FILE__": PROFILE %d/%d. search=%d%s elapsed=%.3f [ms]",
                   (int)M_courses.size(),
                   DIST_DIVS,
+                  M_total_count,
+                  ( M_budget.truncated() ? " (truncated)" : "" ),
                   timer.elapsedReal() );
 #endif
 
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ShootGenerator::updateGoalieEnvelope( const WorldModel & wm )
+{
+    static const int MAX_CYCLE = 50;
+
+    M_goalie = wm.getOpponentGoalie();
+    M_goalie_inertia_pos.clear();
+    M_goalie_reach_dist.clear();
+
+    if ( ! M_goalie )
+    {
+        return;
+    }
+
+    //
+    // the goalie's inertia position and its reachable distance do not
+    // depend on the shoot course. they are shared by all target points
+    // and ball speeds.
+    // the reachable distance is taken from the dash distance table, so the
+    // envelope rejects exactly the cycles where the goalie needs more than
+    // (cycle + posCount) dashes.
+    //
+
+    const PlayerType * ptype = M_goalie->playerTypePtr();
+    const std::vector< double > & dash_table = ptype->dashDistanceTable();
+    const int count = M_goalie->posCount();
+
+    for ( int cycle = 0; cycle <= MAX_CYCLE; ++cycle )
+    {
+        M_goalie_inertia_pos.push_back( M_goalie->inertiaPoint( cycle ) );
+
+        const int n_dash = cycle + count;
+        double reach_dist = 0.0;
+        if ( n_dash <= 0 )
+        {
+            reach_dist = 0.0;
+        }
+        else if ( n_dash <= static_cast< int >( dash_table.size() ) )
+        {
+            reach_dist = dash_table[n_dash - 1];
+        }
+        else
+        {
+            // same extrapolation as PlayerType::cyclesToReachDistance()
+            const int table_size = dash_table.size();
+            reach_dist = ( dash_table.empty() ? 0.0 : dash_table.back() )
+                + ptype->realSpeedMax() * ( n_dash - table_size );
+        }
+
+        // 0.001 is the tolerance used by PlayerType::cyclesToReachDistance()
+        M_goalie_reach_dist.push_back( reach_dist + 0.001 );
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -203,6 +309,8 @@ void
 ShootGenerator::createShoot( const WorldModel & wm,
                              const Vector2D & target_point )
 {
+    static const double SPEED_RESOLUTION = 0.3;
+
     const AngleDeg ball_move_angle = ( target_point - M_first_ball_pos ).th();
 
     const PlayerObject * goalie = wm.getOpponentGoalie();
@@ -237,131 +345,200 @@ ShootGenerator::createShoot( const WorldModel & wm,
             : ( target_point - M_first_ball_pos ).setLengthVector( 0.1 ) );
     const double max_one_step_speed = max_one_step_vel.r();
 
-    double first_ball_speed
-        = std::max( ( ball_move_dist + 5.0 ) * ( 1.0 - SP.ballDecay() ),
-                    std::max( max_one_step_speed,
-                              1.5 ) );
+    const double min_first_ball_speed
+        = std::min( ball_speed_max,
+                    std::max( ( ball_move_dist + 5.0 ) * ( 1.0 - SP.ballDecay() ),
+                              std::max( max_one_step_speed,
+                                        1.5 ) ) );
+
+    //
+    // The opponents' chance to reach the ball never increases when the
+    // first ball speed becomes faster. Then, the feasible speed range is
+    // [minimal feasible speed, ball_speed_max], and the minimal feasible
+    // speed can be found by bisection.
+    //
+
+    Course max_course = createCourse( target_point,
+                                      ball_speed_max,
+                                      ball_move_angle,
+                                      ball_move_dist );
+    if ( ! checkCourse( wm, max_course ) )
+    {
+#ifdef DEBUG_PRINT_FAILED_COURSE
+        dlog.addText( Logger::SHOOT,
+                      "%d: xxx shoot target=(%.2f %.2f)"
+                      " speed=%.3f angle=%.1f",
+                      M_total_count,
+                      target_point.x, target_point.y,
+                      ball_speed_max,
+                      ball_move_angle.degree() );
+        dlog.addRect( Logger::SHOOT,
+                      target_point.x - 0.1, target_point.y - 0.1,
+                      0.2, 0.2,
+                      "#ff0000" );
+        char num[8];
+        snprintf( num, 8, "%d", M_total_count );
+        dlog.addMessage( Logger::SHOOT,
+                         target_point, num, "#ffffff" );
+#endif
+        return;
+    }
 
-    bool over_max = false;
-    bool success = false;
-    while ( ! over_max )
+    Course best_course = max_course;
+
+    double lower_speed = min_first_ball_speed; // infeasible (or not checked)
+    double upper_speed = ball_speed_max; // feasible
+
+    if ( upper_speed - lower_speed > 0.001 )
     {
-        if ( first_ball_speed > ball_speed_max - 0.001 )
+        Course course = createCourse( target_point,
+                                      lower_speed,
+                                      ball_move_angle,
+                                      ball_move_dist );
+        if ( checkCourse( wm, course ) )
         {
-            over_max = true;
-            first_ball_speed = ball_speed_max;
+            best_course = course;
+            upper_speed = lower_speed;
         }
+    }
 
-        if ( createShoot( wm,
-                          target_point,
-                          first_ball_speed,
-                          ball_move_angle,
-                          ball_move_dist ) )
+    while ( upper_speed - lower_speed > SPEED_RESOLUTION )
+    {
+        const double speed = ( lower_speed + upper_speed ) * 0.5;
+        Course course = createCourse( target_point,
+                                      speed,
+                                      ball_move_angle,
+                                      ball_move_dist );
+        if ( checkCourse( wm, course ) )
         {
-            Course & course = M_courses.back();
-
-            if ( first_ball_speed <= max_one_step_speed + 0.001 )
-            {
-                course.kick_step_ = 1;
-            }
-
-#ifdef DEBUG_PRINT_SUCCESS_COURSE
-            dlog.addText( Logger::SHOOT,
-                          "%d: ok shoot target=(%.2f %.2f)"
-                          " speed=%.3f angle=%.1f",
-                          M_total_count,
-                          target_point.x, target_point.y,
-                          first_ball_speed,
-                          ball_move_angle.degree() );
-            dlog.addRect( Logger::SHOOT,
-                          target_point.x - 0.1, target_point.y - 0.1,
-                          0.2, 0.2,
-                          "#00ff00" );
-            char num[8];
-            snprintf( num, 8, "%d", M_total_count );
-            dlog.addMessage( Logger::SHOOT,
-                             target_point, num, "#ffffff" );
-#endif
-
-            success = true;
-#ifdef SEARCH_UNTIL_MAX_SPEED_AT_SAME_POINT
-            if ( course.goalie_never_reach_
-                 && course.opponent_never_reach_ )
-            {
-                return;
-            }
-            ++M_total_count;
-#else
-            return;
-#endif
+            best_course = course;
+            upper_speed = speed;
+        }
+        else
+        {
+            lower_speed = speed;
         }
-
-        first_ball_speed += 0.3;
     }
 
-#ifdef DEBUG_PRINT_FAILED_COURSE
-    if ( success )
+    if ( best_course.first_ball_speed_ <= max_one_step_speed + 0.001 )
     {
-        return;
+        best_course.kick_step_ = 1;
     }
 
+    M_courses.push_back( best_course );
+
+#ifdef DEBUG_PRINT_SUCCESS_COURSE
     dlog.addText( Logger::SHOOT,
-                  "%d: xxx shoot target=(%.2f %.2f)"
+                  "%d: ok shoot target=(%.2f %.2f)"
                   " speed=%.3f angle=%.1f",
                   M_total_count,
                   target_point.x, target_point.y,
-                  first_ball_speed,
+                  best_course.first_ball_speed_,
                   ball_move_angle.degree() );
     dlog.addRect( Logger::SHOOT,
                   target_point.x - 0.1, target_point.y - 0.1,
                   0.2, 0.2,
-                  "#ff0000" );
+                  "#00ff00" );
     char num[8];
     snprintf( num, 8, "%d", M_total_count );
     dlog.addMessage( Logger::SHOOT,
                      target_point, num, "#ffffff" );
 #endif
+
+#ifdef SEARCH_UNTIL_MAX_SPEED_AT_SAME_POINT
+    if ( ( best_course.goalie_never_reach_
+           && best_course.opponent_never_reach_ )
+         || best_course.first_ball_speed_ > ball_speed_max - 0.001 )
+    {
+        return;
+    }
+
+    if ( ! max_course.goalie_never_reach_
+         || ! max_course.opponent_never_reach_ )
+    {
+        // no safe course. the fastest ball is the best chance.
+        M_courses.push_back( max_course );
+        return;
+    }
+
+    //
+    // search the minimal speed that nobody can reach.
+    //
+
+    Course safe_course = max_course;
+    lower_speed = best_course.first_ball_speed_;
+    upper_speed = ball_speed_max;
+
+    while ( upper_speed - lower_speed > SPEED_RESOLUTION )
+    {
+        const double speed = ( lower_speed + upper_speed ) * 0.5;
+        Course course = createCourse( target_point,
+                                      speed,
+                                      ball_move_angle,
+                                      ball_move_dist );
+        if ( checkCourse( wm, course )
+             && course.goalie_never_reach_
+             && course.opponent_never_reach_ )
+        {
+            safe_course = course;
+            upper_speed = speed;
+        }
+        else
+        {
+            lower_speed = speed;
+        }
+    }
+
+    M_courses.push_back( safe_course );
+#endif
 }
 
 /*-------------------------------------------------------------------*/
 /*!
 
  */
-bool
-ShootGenerator::createShoot( const WorldModel & wm,
-                             const Vector2D & target_point,
-                             const double & first_ball_speed,
-                             const rcsc::AngleDeg & ball_move_angle,
-                             const double & ball_move_dist )
+ShootGenerator::Course
+ShootGenerator::createCourse( const Vector2D & target_point,
+                              const double & first_ball_speed,
+                              const AngleDeg & ball_move_angle,
+                              const double & ball_move_dist )
 {
-    const ServerParam & SP = ServerParam::i();
-
     const int ball_reach_step
         = static_cast< int >( std::ceil( calc_length_geom_series( first_ball_speed,
                                                                    ball_move_dist,
-                                                                   SP.ballDecay() ) ) );
+                                                                   ServerParam::i().ballDecay() ) ) );
+    return Course( M_total_count,
+                   target_point,
+                   first_ball_speed,
+                   ball_move_angle,
+                   ball_move_dist,
+                   ball_reach_step );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ShootGenerator::checkCourse( const WorldModel & wm,
+                             Course & course )
+{
+    const ServerParam & SP = ServerParam::i();
+
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::SHOOT,
                   "%d: target=(%.2f %.2f) speed=%.3f angle=%.1f"
                   " ball_reach_step=%d",
                   M_total_count,
-                  target_point.x, target_point.y,
-                  first_ball_speed,
-                  ball_move_angle.degree(),
-                  ball_reach_step );
+                  course.target_point_.x, course.target_point_.y,
+                  course.first_ball_speed_,
+                  course.ball_move_angle_.degree(),
+                  course.ball_reach_step_ );
 #endif
 
-    Course course( M_total_count,
-                   target_point,
-                   first_ball_speed,
-                   ball_move_angle,
-                   ball_move_dist,
-                   ball_reach_step );
-
-    if ( ball_reach_step <= 1 )
+    if ( course.ball_reach_step_ <= 1 )
     {
         course.ball_reach_step_ = 1;
-        M_courses.push_back( course );
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::SHOOT,
                       "%d: one step to the goal" );
@@ -369,9 +546,9 @@ ShootGenerator::createShoot( const WorldModel & wm,
         return true;
     }
 
-    // estimate opponent interception
+    const AngleDeg & ball_move_angle = course.ball_move_angle_;
 
-    const Vector2D first_ball_vel = Vector2D::from_polar( first_ball_speed, ball_move_angle );
+    // estimate opponent interception
 
     const double opponent_x_thr = SP.theirPenaltyAreaLineX() - 30.0;
     const double opponent_y_thr = SP.penaltyAreaHalfWidth();
@@ -422,9 +599,7 @@ ShootGenerator::createShoot( const WorldModel & wm,
         }
     }
 
-    M_courses.push_back( course );
     return true;
-
 }
 
 /*-------------------------------------------------------------------*/
@@ -442,6 +617,7 @@ ShootGenerator::maybeGoalieCatch( const PlayerObject * goalie,
     static const double CONTROL_AREA_BUF = 0.15;  // buffer for kick table
 
     const ServerParam & SP = ServerParam::i();
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
 
     const PlayerType * ptype = goalie->playerTypePtr();
 
@@ -472,10 +648,9 @@ ShootGenerator::maybeGoalieCatch( const PlayerObject * goalie,
 
     for ( int cycle = min_cycle; cycle < max_cycle; ++cycle )
     {
-        const Vector2D ball_pos = inertia_n_step_point( M_first_ball_pos,
-                                                        course.first_ball_vel_,
-                                                        cycle,
-                                                        SP.ballDecay() );
+        const Vector2D ball_pos = ball_kinematics.inertiaPoint( M_first_ball_pos,
+                                                                course.first_ball_vel_,
+                                                                cycle );
         if ( ball_pos.x > SP.pitchHalfLength() )
         {
 #ifdef DEBUG_PRINT
@@ -492,7 +667,12 @@ ShootGenerator::maybeGoalieCatch( const PlayerObject * goalie,
                                       ? SP.catchableArea()
                                       : ptype->kickableArea() );
 
-        Vector2D inertia_pos = goalie->inertiaPoint( cycle );
+        const bool use_envelope = ( goalie == M_goalie
+                                    && cycle < static_cast< int >( M_goalie_inertia_pos.size() ) );
+
+        Vector2D inertia_pos = ( use_envelope
+                                 ? M_goalie_inertia_pos[cycle]
+                                 : goalie->inertiaPoint( cycle ) );
         double target_dist = inertia_pos.dist( ball_pos );
 
         if ( in_penalty_area )
@@ -523,6 +703,14 @@ ShootGenerator::maybeGoalieCatch( const PlayerObject * goalie,
             dash_dist *= 0.999;
         }
 
+        if ( use_envelope
+             && dash_dist > M_goalie_reach_dist[cycle] )
+        {
+            // the goalie needs more dashes than the available cycles.
+            // no need to simulate the dash and turn.
+            continue;
+        }
+
         int n_dash = ptype->cyclesToReachDistance( dash_dist );
 
         if ( n_dash > cycle + goalie->posCount() )
@@ -610,6 +798,7 @@ ShootGenerator::opponentCanReach( const PlayerObject * opponent,
                                   Course & course )
 {
     const ServerParam & SP = ServerParam::i();
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
 
     const PlayerType * ptype = opponent->playerTypePtr();
     const double control_area = ptype->kickableArea();
@@ -639,10 +828,9 @@ ShootGenerator::opponentCanReach( const PlayerObject * opponent,
 
     for ( int cycle = min_cycle; cycle < max_cycle; ++cycle )
     {
-        Vector2D ball_pos = inertia_n_step_point( M_first_ball_pos,
-                                                  course.first_ball_vel_,
-                                                  cycle,
-                                                  SP.ballDecay() );
+        Vector2D ball_pos = ball_kinematics.inertiaPoint( M_first_ball_pos,
+                                                          course.first_ball_vel_,
+                                                          cycle );
 
         Vector2D inertia_pos = opponent->inertiaPoint( cycle );
         double target_dist = inertia_pos.dist( ball_pos );
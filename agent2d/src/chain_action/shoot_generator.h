@@ -32,6 +32,8 @@
 #ifndef SHOOT_GENERATOR_H
 #define SHOOT_GENERATOR_H
 
+#include "generator_budget.h"
+
 #include <rcsc/geom/vector_2d.h>
 #include <rcsc/game_time.h>
 
@@ -129,6 +131,16 @@ private:
     //! cached calculated shoot pathes
     Container M_courses;
 
+    //! goalie used for the reach envelope
+    const rcsc::PlayerObject * M_goalie;
+    //! goalie's inertia position for each cycle
+    std::vector< rcsc::Vector2D > M_goalie_inertia_pos;
+    //! goalie's reachable distance by ( cycle + posCount ) dashes for each cycle
+    std::vector< double > M_goalie_reach_dist;
+
+    //! search budget
+    GeneratorBudget M_budget;
+
     // private for singleton
     ShootGenerator();
 
@@ -153,18 +165,42 @@ public:
           return M_courses;
       }
 
+    /*!
+      \brief set the search budget.
+      \param max_msec time limit [ms]. a non positive value means unlimited.
+      \param max_count the maximum number of target points.
+     */
+    void setBudget( const double & max_msec,
+                    const int max_count )
+      {
+          M_budget.setLimits( max_msec, max_count );
+      }
+
+    /*!
+      \brief check if the last search was cut by the budget.
+      \return true if the generated courses are a partial result.
+     */
+    bool truncated() const
+      {
+          return M_budget.truncated();
+      }
+
 private:
 
     void clear();
 
+    void updateGoalieEnvelope( const rcsc::WorldModel & wm );
+
     void createShoot( const rcsc::WorldModel & wm,
                       const rcsc::Vector2D & target_point );
 
-    bool createShoot( const rcsc::WorldModel & wm,
-                      const rcsc::Vector2D & target_point,
-                      const double & first_ball_speed,
-                      const rcsc::AngleDeg & ball_move_angle,
-                      const double & ball_move_dist );
+    Course createCourse( const rcsc::Vector2D & target_point,
+                         const double & first_ball_speed,
+                         const rcsc::AngleDeg & ball_move_angle,
+                         const double & ball_move_dist );
+
+    bool checkCourse( const rcsc::WorldModel & wm,
+                      Course & course );
 
     bool maybeGoalieCatch( const rcsc::PlayerObject * goalie,
                            Course & course );
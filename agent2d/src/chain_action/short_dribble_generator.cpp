@@ -36,6 +36,8 @@
 #include "short_dribble_generator.h"
 
 #include "dribble.h"
+#include "ball_kinematics.h"
+#include "dash_trajectory_table.h"
 #include "field_analyzer.h"
 
 #include <rcsc/player/world_model.h>
@@ -174,6 +176,8 @@ ShortDribbleGenerator::generate( const WorldModel & wm )
     Timer timer;
 #endif
 
+    M_budget.start();
+
     createCourses( wm );
 
     std::sort( M_courses.begin(), M_courses.end(),
@@ -181,9 +185,10 @@ ShortDribbleGenerator::generate( const WorldModel & wm )
 
 #ifdef DEBUG_PROFILE
     dlog.addText( Logger::DRIBBLE,
-                  __FILE__": (generate) PROFILE size=%d/%d elapsed %.3f [ms]",
+                  __FILE__": (generate) PROFILE size=%d/%d%s elapsed %.3f [ms]",
                   (int)M_courses.size(),
                   M_total_count,
+                  ( M_budget.truncated() ? " (truncated)" : "" ),
                   timer.elapsedReal() );
 #endif
 }
@@ -217,11 +222,13 @@ ShortDribbleGenerator::createCourses( const WorldModel & wm )
     const double my_first_speed = wm.self().vel().r();
 
     //
-    // angle loop
+    // angle loop. the directions near the body angle need fewer turns
+    // and are tried first.
     //
 
-    for ( int a = 0; a < angle_div; ++a )
+    for ( int i = 0; i < angle_div; ++i )
     {
+        const int a = ( angle_div + GeneratorBudget::alternate_offset( i ) ) % angle_div;
         AngleDeg dash_angle = wm.self().body() + ( angle_step * a );
 
         //
@@ -293,6 +300,14 @@ ShortDribbleGenerator::createCourses( const WorldModel & wm )
             dash_angle += dir_diff;
         }
 
+        if ( ! M_budget.consume() )
+        {
+            dlog.addText( Logger::DRIBBLE,
+                          __FILE__": (createCourses) truncated by budget. count=%d elapsed %.3f [ms]",
+                          M_budget.count(), M_budget.elapsed() );
+            break;
+        }
+
         simulateKickTurnsDashes( wm, dash_angle, n_turn );
     }
 }
@@ -577,9 +592,7 @@ ShortDribbleGenerator::simulateKickTurnsDashes( const WorldModel & wm,
             continue;
         }
 
-        const double term
-            = ( 1.0 - std::pow( SP.ballDecay(), 1 + n_turn + n_dash ) )
-            / ( 1.0 - SP.ballDecay() );
+        const double term = BallKinematics::instance().moveRate( 1 + n_turn + n_dash );
         const Vector2D first_vel = ( ball_trap_pos - M_first_ball_pos ) / term;
         const Vector2D kick_accel = first_vel - M_first_ball_vel;
         const double kick_power = kick_accel.r() / wm.self().kickRate();
@@ -661,6 +674,40 @@ ShortDribbleGenerator::createSelfCache( const WorldModel & wm,
 
     self_cache.clear();
 
+    const double stamina_thr = SP.recoverDecThrValue() + 300.0;
+
+    const DashTrajectoryTable & table = DashTrajectoryTable::instance();
+    if ( table.hasTable( ptype, 1 + n_turn + n_dash )
+         && DashTrajectoryTable::is_full_stamina_band( ptype,
+                                                       wm.self().staminaModel(),
+                                                       stamina_thr,
+                                                       n_dash ) )
+    {
+        //
+        // rotate and translate the precomputed trajectory
+        //
+        const Vector2D first_pos = wm.self().pos();
+        const Vector2D first_vel = wm.self().vel();
+        const Vector2D dash_accel
+            = Vector2D::polar2vector( SP.maxDashPower() * ptype.dashPowerRate()
+                                      * wm.self().staminaModel().effort(),
+                                      dash_angle );
+
+        for ( int i = 0; i <= n_turn; ++i )
+        {
+            self_cache.push_back( first_pos + first_vel * table.inertiaRate( ptype, 1 + i ) );
+        }
+
+        for ( int i = 1; i <= n_dash; ++i )
+        {
+            self_cache.push_back( first_pos
+                                  + first_vel * table.inertiaRate( ptype, 1 + n_turn + i )
+                                  + dash_accel * table.dashRate( ptype, i ) );
+        }
+
+        return;
+    }
+
     StaminaModel stamina_model = wm.self().staminaModel();
 
     Vector2D my_pos = wm.self().pos();
@@ -685,7 +732,7 @@ ShortDribbleGenerator::createSelfCache( const WorldModel & wm,
     for ( int i = 0; i < n_dash; ++i )
     {
         double available_stamina = std::max( 0.0,
-                                             stamina_model.stamina() - SP.recoverDecThrValue() - 300.0 );
+                                             stamina_model.stamina() - stamina_thr );
         double dash_power = std::min( available_stamina, SP.maxDashPower() );
         Vector2D dash_accel = unit_vec.setLengthVector( dash_power * ptype.dashPowerRate() * stamina_model.effort() );
 
@@ -33,6 +33,7 @@
 #define SHORT_DRIBBLE_GENERATOR_H
 
 #include "cooperative_action.h"
+#include "generator_budget.h"
 
 #include <rcsc/player/abstract_player_object.h>
 #include <rcsc/geom/vector_2d.h>
@@ -59,6 +60,8 @@ private:
 
     std::vector< CooperativeAction::Ptr > M_courses;
 
+    GeneratorBudget M_budget;
+
     // private for singleton
     ShortDribbleGenerator();
 
@@ -81,6 +84,26 @@ public:
           return M_courses;
       }
 
+    /*!
+      \brief set the search budget.
+      \param max_msec time limit [ms]. a non positive value means unlimited.
+      \param max_count the maximum number of dash directions.
+     */
+    void setBudget( const double & max_msec,
+                    const int max_count )
+      {
+          M_budget.setLimits( max_msec, max_count );
+      }
+
+    /*!
+      \brief check if the last search was cut by the budget.
+      \return true if the generated courses are a partial result.
+     */
+    bool truncated() const
+      {
+          return M_budget.truncated();
+      }
+
 private:
 
     void clear();
@@ -31,6 +31,7 @@
 #include "simple_pass_checker.h"
 
 #include "predict_state.h"
+#include "player_state_fusion.h"
 
 #include <rcsc/player/world_model.h>
 #include <rcsc/common/server_param.h>
@@ -51,9 +52,9 @@ static const double PASS_SPEED_THRESHOLD = 1.5;
 static const double NEAR_PASS_DIST_THR = 4.0;
 static const double FAR_PASS_DIST_THR = 35.0;
 
-static const long VALID_TEAMMATE_ACCURACY = 8;
-static const long VALID_OPPONENT_ACCURACY = 20;
-static const double OPPONENT_DIST_THR2 = std::pow( 5.0, 2 );
+static const double VALID_TEAMMATE_RADIUS = 3.5;
+static const double VALID_OPPONENT_RADIUS = 5.0;
+static const double OPPONENT_DIST_THR = 5.0;
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -79,10 +80,12 @@ SimplePassChecker::operator()( const PredictState & state,
         return false;
     }
 
+    const PlayerStateFusion & fusion = PlayerStateFusion::i();
+
     if ( from.isGhost()
          || to.isGhost()
-         || from.posCount() > VALID_TEAMMATE_ACCURACY
-         || to.posCount() > VALID_TEAMMATE_ACCURACY )
+         || fusion.radius( from ) > VALID_TEAMMATE_RADIUS
+         || fusion.radius( to ) > VALID_TEAMMATE_RADIUS )
     {
         return false;
     }
@@ -197,17 +200,22 @@ SimplePassChecker::operator()( const PredictState & state,
           opp != o_end;
           ++opp )
     {
-        if ( (*opp)->posCount() > VALID_OPPONENT_ACCURACY )
+        // the opponent may be anywhere in the uncertainty radius
+        const double opp_radius = fusion.radius( **opp );
+        if ( opp_radius > VALID_OPPONENT_RADIUS )
         {
             continue;
         }
 
-        if ( ( (*opp)->pos() - receive_point ).r2() < OPPONENT_DIST_THR2 )
+        const Vector2D fused_pos = fusion.position( **opp );
+
+        if ( ( fused_pos - receive_point ).r2()
+             < std::pow( OPPONENT_DIST_THR + opp_radius, 2 ) )
         {
             return false;
         }
 
-        Vector2D opp_pos = (*opp)->inertiaFinalPoint();
+        Vector2D opp_pos = (*opp)->playerTypePtr()->inertiaFinalPoint( fused_pos, (*opp)->vel() );
 
         const double opp_dist2 = from_pos.dist2( opp_pos );
 
@@ -216,7 +224,7 @@ SimplePassChecker::operator()( const PredictState & state,
             continue;
         }
 
-        const double opp_move_dist = opp_pos.dist( receive_point );
+        const double opp_move_dist = std::max( 0.0, opp_pos.dist( receive_point ) - opp_radius );
 
         if ( opp_move_dist < receiver_move_dist * 0.85 )
         {
@@ -36,6 +36,7 @@
 #include "strict_check_pass_generator.h"
 
 #include "pass.h"
+#include "ball_kinematics.h"
 #include "field_analyzer.h"
 
 #include <rcsc/player/world_model.h>
@@ -94,6 +95,50 @@ debug_paint_failed_pass( const int count,
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the minimal x-coordinate of the through pass receive point.
+ */
+inline
+double
+through_pass_min_receive_x( const WorldModel & wm,
+                            const Vector2D & first_point )
+{
+    return std::min( std::min( std::max( 10.0, first_point.x + 10.0 ),
+                               wm.offsideLineX() - 10.0 ),
+                     ServerParam::i().theirPenaltyAreaLineX() - 5.0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief find the recent pass request from the receiver.
+  \return true if the receiver has requested the pass.
+ */
+bool
+find_pass_request( const WorldModel & wm,
+                   const int receiver_unum,
+                   const Vector2D & receiver_pos,
+                   AngleDeg * requested_move_angle )
+{
+    if ( wm.audioMemory().passRequestTime().cycle() <= wm.time().cycle() - 10 ) // Magic Number
+    {
+        return false;
+    }
+
+    for ( std::vector< AudioMemory::PassRequest >::const_iterator it = wm.audioMemory().passRequest().begin();
+          it != wm.audioMemory().passRequest().end();
+          ++it )
+    {
+        if ( it->sender_ == receiver_unum )
+        {
+            *requested_move_angle = ( it->pos_ - receiver_pos ).th();
+            return true;
+        }
+    }
+
+    return false;
+}
+
 }
 
 /*-------------------------------------------------------------------*/
@@ -137,11 +182,18 @@ StrictCheckPassGenerator::StrictCheckPassGenerator()
       M_total_count( 0 ),
       M_pass_type( '-' ),
       M_passer( static_cast< AbstractPlayerObject * >( 0 ) ),
-      M_start_time( -1, 0 )
+      M_start_time( -1, 0 ),
+      M_speculation_enabled( true ),
+      M_speculating( false ),
+      M_speculation_time( -1, 0 ),
+      M_speculative_passer_unum( Unum_Unknown ),
+      M_speculative_receivers( 0 ),
+      M_speculative_offside_line_x( 0.0 )
 {
     M_receiver_candidates.reserve( 11 );
     M_opponents.reserve( 16 );
     M_courses.reserve( 1024 );
+    M_speculative_courses.reserve( 256 );
 
     clear();
 }
@@ -221,7 +273,13 @@ StrictCheckPassGenerator::generate( const WorldModel & wm )
 
     updateOpponents( wm );
 
-    createCourses( wm );
+    M_budget.start();
+
+    const bool speculated = patchSpeculativeCourses( wm );
+    if ( ! speculated )
+    {
+        createCourses( wm );
+    }
 
     std::sort( M_courses.begin(), M_courses.end(),
                CooperativeAction::DistCompare( ServerParam::i().theirTeamGoalPos() ) );
@@ -230,25 +288,234 @@ StrictCheckPassGenerator::generate( const WorldModel & wm )
     if ( M_passer->unum() == wm.self().unum() )
     {
         dlog.addText( Logger::PASS,
-                      __FILE__" (generate) PROFILE passer=self size=%d/%d D=%d L=%d T=%d elapsed %f [ms]",
+                      __FILE__" (generate) PROFILE passer=self size=%d/%d D=%d L=%d T=%d%s%s elapsed %f [ms]",
                       (int)M_courses.size(),
                       M_total_count,
                       M_direct_size, M_leading_size, M_through_size,
+                      ( speculated ? " (speculated)" : "" ),
+                      ( M_budget.truncated() ? " (truncated)" : "" ),
                       timer.elapsedReal() );
     }
     else
     {
         dlog.addText( Logger::PASS,
-                      __FILE__" (update) PROFILE passer=%d size=%d/%d D=%d L=%d T=%d elapsed %f [ms]",
+                      __FILE__" (update) PROFILE passer=%d size=%d/%d D=%d L=%d T=%d%s%s elapsed %f [ms]",
                       M_passer->unum(),
                       (int)M_courses.size(),
                       M_total_count,
                       M_direct_size, M_leading_size, M_through_size,
+                      ( speculated ? " (speculated)" : "" ),
+                      ( M_budget.truncated() ? " (truncated)" : "" ),
                       timer.elapsedReal() );
     }
 #endif
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+StrictCheckPassGenerator::speculate( const WorldModel & wm )
+{
+    if ( ! M_speculation_enabled
+         || M_speculation_time == wm.time() )
+    {
+        return;
+    }
+    M_speculation_time = wm.time();
+    M_speculative_passer_unum = Unum_Unknown;
+    M_speculative_first_point.invalidate();
+    M_speculative_courses.clear();
+
+    if ( wm.gameMode().type() != GameMode::PlayOn
+         || wm.time().stopped() > 0
+         || wm.self().isKickable()
+         || wm.existKickableTeammate()
+         || wm.existKickableOpponent() )
+    {
+        return;
+    }
+
+    //
+    // speculate only if one of our players is about to receive the ball.
+    //
+    const int our_min = std::min( wm.interceptTable()->selfReachCycle(),
+                                  wm.interceptTable()->teammateReachCycle() );
+    if ( our_min < 1 || 3 < our_min )
+    {
+        return;
+    }
+
+#ifdef DEBUG_PROFILE
+    Timer timer;
+#endif
+
+    //
+    // the current results are discarded. they have been already used.
+    //
+    clear();
+    M_update_time.assign( -1, 0 );
+
+    updatePasser( wm );
+
+    if ( M_passer
+         && M_first_point.isValid() )
+    {
+        updateReceivers( wm );
+
+        if ( ! M_receiver_candidates.empty() )
+        {
+            updateOpponents( wm );
+
+            M_budget.start();
+
+            M_speculating = true;
+            createCourses( wm );
+            M_speculating = false;
+
+            M_speculative_passer_unum = M_passer->unum();
+            M_speculative_first_point = M_first_point;
+            M_speculative_receivers = getReceiverMask();
+            M_speculative_offside_line_x = wm.offsideLineX();
+        }
+    }
+
+#ifdef DEBUG_PROFILE
+    dlog.addText( Logger::PASS,
+                  __FILE__" (speculate) PROFILE passer=%d size=%d/%d%s elapsed %f [ms]",
+                  M_speculative_passer_unum,
+                  (int)M_speculative_courses.size(),
+                  M_total_count,
+                  ( M_budget.truncated() ? " (truncated)" : "" ),
+                  timer.elapsedReal() );
+#endif
+
+    clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+StrictCheckPassGenerator::patchSpeculativeCourses( const WorldModel & wm )
+{
+    static const double FIRST_POINT_TOLERANCE2 = std::pow( 0.3, 2 ); // Magic Number
+    static const double OFFSIDE_LINE_TOLERANCE = 0.5; // Magic Number
+
+    if ( M_speculative_courses.empty() )
+    {
+        return false;
+    }
+
+    //
+    // the speculation is valid only if the situation has not been changed.
+    //
+    if ( M_speculation_time.cycle() + 1 != wm.time().cycle()
+         || wm.gameMode().type() != GameMode::PlayOn
+         || M_speculative_passer_unum != M_passer->unum()
+         || ! M_speculative_first_point.isValid()
+         || M_speculative_first_point.dist2( M_first_point ) > FIRST_POINT_TOLERANCE2
+         || M_speculative_receivers != getReceiverMask()
+         || std::fabs( M_speculative_offside_line_x - wm.offsideLineX() ) > OFFSIDE_LINE_TOLERANCE )
+    {
+        dlog.addText( Logger::PASS,
+                      __FILE__" (patchSpeculativeCourses) situation changed." );
+        M_speculative_courses.clear();
+        return false;
+    }
+
+    //
+    // re-run the same checks as the full search for each speculated receive point.
+    // the courses on the same point are consecutive in the container.
+    //
+    const std::size_t speculated_size = M_speculative_courses.size();
+
+    std::vector< SpeculativeCourse >::const_iterator prev = M_speculative_courses.end();
+    for ( std::vector< SpeculativeCourse >::const_iterator c = M_speculative_courses.begin(),
+              end = M_speculative_courses.end();
+          c != end;
+          prev = c, ++c )
+    {
+        if ( prev != end
+             && prev->receiver_unum_ == c->receiver_unum_
+             && prev->pass_type_ == c->pass_type_
+             && prev->receive_point_.dist2( c->receive_point_ ) < 1.0e-6 )
+        {
+            continue;
+        }
+
+        const Receiver * receiver = getReceiver( c->receiver_unum_ );
+        if ( ! receiver )
+        {
+            continue;
+        }
+
+        M_pass_type = c->pass_type_;
+
+        switch ( M_pass_type ) {
+        case 'D':
+            // direct pass follows the latest receiver position
+            createDirectPass( wm, *receiver );
+            break;
+        case 'L':
+            createLeadingPassAt( wm, *receiver, c->receive_point_ );
+            break;
+        case 'T':
+            {
+                AngleDeg requested_move_angle = 0.0;
+                const bool pass_requested = find_pass_request( wm,
+                                                               receiver->player_->unum(),
+                                                               receiver->inertia_pos_,
+                                                               &requested_move_angle );
+                createThroughPassAt( wm, *receiver, c->receive_point_,
+                                     ( c->receive_point_ - receiver->inertia_pos_ ).th(),
+                                     pass_requested, requested_move_angle );
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // the speculation is used only once
+    M_speculative_courses.clear();
+
+    if ( M_courses.size() < speculated_size )
+    {
+        // some courses have been invalidated. try the full search.
+        dlog.addText( Logger::PASS,
+                      __FILE__" (patchSpeculativeCourses) invalidated %d/%d",
+                      (int)( speculated_size - M_courses.size() ), (int)speculated_size );
+        M_courses.clear();
+        M_total_count = 0;
+        M_direct_size = M_leading_size = M_through_size = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+StrictCheckPassGenerator::getReceiverMask() const
+{
+    int mask = 0;
+    for ( ReceiverCont::const_iterator p = M_receiver_candidates.begin(),
+              end = M_receiver_candidates.end();
+          p != end;
+          ++p )
+    {
+        mask |= ( 1 << p->player_->unum() );
+    }
+
+    return mask;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -286,7 +553,7 @@ StrictCheckPassGenerator::updatePasser( const WorldModel & wm )
         if ( s_min <= 2 )
         {
             M_passer = &wm.self();
-            M_first_point = wm.ball().inertiaPoint( s_min );
+            M_first_point = BallKinematics::instance().ballInertiaPoint( wm, s_min );
         }
     }
     else
@@ -294,7 +561,7 @@ StrictCheckPassGenerator::updatePasser( const WorldModel & wm )
         if ( t_min <= 2 )
         {
             M_passer = wm.interceptTable()->fastestTeammate();
-            M_first_point = wm.ball().inertiaPoint( t_min );
+            M_first_point = BallKinematics::instance().ballInertiaPoint( wm, t_min );
         }
     }
 
@@ -484,11 +751,17 @@ StrictCheckPassGenerator::updateOpponents( const WorldModel & wm )
 void
 StrictCheckPassGenerator::createCourses( const WorldModel & wm )
 {
+    //
+    // the receivers are sorted by the distance to the opponent goal,
+    // and the cheap pass types are tried first.
+    // if the budget runs out, the remaining candidates are skipped.
+    //
+
     const ReceiverCont::iterator end = M_receiver_candidates.end();
 
     M_pass_type = 'D';
     for ( ReceiverCont::iterator p = M_receiver_candidates.begin();
-          p != end;
+          p != end && ! M_budget.truncated();
           ++p )
     {
         createDirectPass( wm, *p );
@@ -496,7 +769,7 @@ StrictCheckPassGenerator::createCourses( const WorldModel & wm )
 
     M_pass_type = 'L';
     for ( ReceiverCont::iterator p = M_receiver_candidates.begin();
-          p != end;
+          p != end && ! M_budget.truncated();
           ++p )
     {
         createLeadingPass( wm, *p );
@@ -504,11 +777,18 @@ StrictCheckPassGenerator::createCourses( const WorldModel & wm )
 
     M_pass_type = 'T';
     for ( ReceiverCont::iterator p = M_receiver_candidates.begin();
-          p != end;
+          p != end && ! M_budget.truncated();
           ++p )
     {
         createThroughPass( wm, *p );
     }
+
+    if ( M_budget.truncated() )
+    {
+        dlog.addText( Logger::PASS,
+                      __FILE__" (createCourses) truncated by budget. count=%d elapsed %.3f [ms]",
+                      M_budget.count(), M_budget.elapsed() );
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -535,6 +815,11 @@ StrictCheckPassGenerator::createDirectPass( const WorldModel & wm,
 
     const ServerParam & SP = ServerParam::i();
 
+    if ( ! M_budget.consume() )
+    {
+        return;
+    }
+
     //
     // check receivable area
     //
@@ -656,6 +941,63 @@ StrictCheckPassGenerator::createDirectPass( const WorldModel & wm,
 void
 StrictCheckPassGenerator::createLeadingPass( const WorldModel & wm,
                                              const Receiver & receiver )
+{
+    static const int ANGLE_DIVS = 24;
+    static const double ANGLE_STEP = 360.0 / ANGLE_DIVS;
+    static const double DIST_DIVS = 4;
+    static const double DIST_STEP = 1.1;
+
+    //
+    // distance loop
+    //
+    for ( int d = 1; d <= DIST_DIVS; ++d )
+    {
+        const double player_move_dist = DIST_STEP * d;
+        const int a_step = ( player_move_dist * 2.0 * M_PI / ANGLE_DIVS < 0.6
+                             ? 2
+                             : 1 );
+        // const int move_dist_penalty_step
+        //     = static_cast< int >( std::floor( player_move_dist * 0.3 ) );
+
+        //
+        // angle loop. the angles near the receiver direction are tried first.
+        //
+        for ( int i = 0; i < ANGLE_DIVS / a_step; ++i )
+        {
+            if ( ! M_budget.consume() )
+            {
+                return;
+            }
+
+            const int a = a_step * GeneratorBudget::alternate_offset( i );
+
+            const AngleDeg angle = receiver.angle_from_ball_ + ANGLE_STEP*a;
+            const Vector2D receive_point
+                = receiver.inertia_pos_
+                + Vector2D::from_polar( player_move_dist, angle );
+
+            const PointResult result = createLeadingPassAt( wm, receiver, receive_point );
+            if ( result == POINT_STOP )
+            {
+                return;
+            }
+
+            if ( result == POINT_BREAK )
+            {
+                break;
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+StrictCheckPassGenerator::PointResult
+StrictCheckPassGenerator::createLeadingPassAt( const WorldModel & wm,
+                                               const Receiver & receiver,
+                                               const Vector2D & receive_point )
 {
     static const double OUR_GOAL_DIST_THR2 = std::pow( 16.0, 2 );
 
@@ -672,11 +1014,6 @@ StrictCheckPassGenerator::createLeadingPass( const WorldModel & wm,
         = ServerParam::i().ballSpeedMax()
         * std::pow( ServerParam::i().ballDecay(), MIN_RECEIVE_STEP );
 
-    static const int ANGLE_DIVS = 24;
-    static const double ANGLE_STEP = 360.0 / ANGLE_DIVS;
-    static const double DIST_DIVS = 4;
-    static const double DIST_STEP = 1.1;
-
     const ServerParam & SP = ServerParam::i();
     const PlayerType * ptype = receiver.player_->playerTypePtr();
 
@@ -694,177 +1031,144 @@ StrictCheckPassGenerator::createLeadingPass( const WorldModel & wm,
                                               * ptype->effortMax() ) * 1.5 );
     const double min_receive_ball_speed = 0.001;
 
-    const Vector2D our_goal = SP.ourTeamGoalPos();
-
-#ifdef DEBUG_PRINT_SUCCESS_PASS
-    std::vector< int > success_counts;
-    success_counts.reserve( 16 );
-#endif
+    ++M_total_count;
 
-    //
-    // distance loop
-    //
-    for ( int d = 1; d <= DIST_DIVS; ++d )
+    int move_dist_penalty_step = 0;
     {
-        const double player_move_dist = DIST_STEP * d;
-        const int a_step = ( player_move_dist * 2.0 * M_PI / ANGLE_DIVS < 0.6
-                             ? 2
-                             : 1 );
-        // const int move_dist_penalty_step
-        //     = static_cast< int >( std::floor( player_move_dist * 0.3 ) );
-
-        //
-        // angle loop
-        //
-        for ( int a = 0; a < ANGLE_DIVS; a += a_step )
-        {
-            ++M_total_count;
-
-            const AngleDeg angle = receiver.angle_from_ball_ + ANGLE_STEP*a;
-            const Vector2D receive_point
-                = receiver.inertia_pos_
-                + Vector2D::from_polar( player_move_dist, angle );
-
-            int move_dist_penalty_step = 0;
-            {
-                Line2D ball_move_line( M_first_point, receive_point );
-                double player_line_dist = ball_move_line.dist( receiver.pos_ );
+        Line2D ball_move_line( M_first_point, receive_point );
+        double player_line_dist = ball_move_line.dist( receiver.pos_ );
 
-                move_dist_penalty_step = static_cast< int >( std::floor( player_line_dist * 0.3 ) );
-            }
+        move_dist_penalty_step = static_cast< int >( std::floor( player_line_dist * 0.3 ) );
+    }
 
 #ifdef DEBUG_LEADING_PASS
-            dlog.addText( Logger::PASS,
-                          ">>>> (lead) unum=%d receivePoint=(%.1f %.1f)",
-                          receiver.player_->unum(),
-                          receive_point.x, receive_point.y );
+    dlog.addText( Logger::PASS,
+                  ">>>> (lead) unum=%d receivePoint=(%.1f %.1f)",
+                  receiver.player_->unum(),
+                  receive_point.x, receive_point.y );
 #endif
 
-            if ( receive_point.x > SP.pitchHalfLength() - 3.0
-                 || receive_point.x < -SP.pitchHalfLength() + 5.0
-                 || receive_point.absY() > SP.pitchHalfWidth() - 3.0 )
-            {
+    if ( receive_point.x > SP.pitchHalfLength() - 3.0
+         || receive_point.x < -SP.pitchHalfLength() + 5.0
+         || receive_point.absY() > SP.pitchHalfWidth() - 3.0 )
+    {
 #ifdef DEBUG_LEADING_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: xxx (lead) unum=%d outOfBounds pos=(%.2f %.2f)",
-                              M_total_count, receiver.player_->unum(),
-                              receive_point.x, receive_point.y );
-                debug_paint_failed_pass( M_total_count, receive_point );
+        dlog.addText( Logger::PASS,
+                      "%d: xxx (lead) unum=%d outOfBounds pos=(%.2f %.2f)",
+                      M_total_count, receiver.player_->unum(),
+                      receive_point.x, receive_point.y );
+        debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                continue;
-            }
+        return POINT_NEXT;
+    }
 
-            if ( receive_point.x < M_first_point.x
-                 && receive_point.dist2( our_goal ) < OUR_GOAL_DIST_THR2 )
-            {
+    if ( receive_point.x < M_first_point.x
+         && receive_point.dist2( SP.ourTeamGoalPos() ) < OUR_GOAL_DIST_THR2 )
+    {
 #ifdef DEBUG_LEADING_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: xxx (lead) unum=%d our goal is near pos=(%.2f %.2f)",
-                              M_total_count, receiver.player_->unum(),
-                              receive_point.x, receive_point.y );
-                debug_paint_failed_pass( M_total_count, receive_point );
+        dlog.addText( Logger::PASS,
+                      "%d: xxx (lead) unum=%d our goal is near pos=(%.2f %.2f)",
+                      M_total_count, receiver.player_->unum(),
+                      receive_point.x, receive_point.y );
+        debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                continue;
-            }
+        return POINT_NEXT;
+    }
 
-            if ( wm.gameMode().type() == GameMode::GoalKick_
-                 && receive_point.x < SP.ourPenaltyAreaLineX() + 1.0
-                 && receive_point.absY() < SP.penaltyAreaHalfWidth() + 1.0 )
-            {
+    if ( wm.gameMode().type() == GameMode::GoalKick_
+         && receive_point.x < SP.ourPenaltyAreaLineX() + 1.0
+         && receive_point.absY() < SP.penaltyAreaHalfWidth() + 1.0 )
+    {
 #ifdef DEBUG_LEADING_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: xxx (lead) unum=%d, goal_kick",
-                              M_total_count, receiver.player_->unum() );
+        dlog.addText( Logger::PASS,
+                      "%d: xxx (lead) unum=%d, goal_kick",
+                      M_total_count, receiver.player_->unum() );
 #endif
-                return;
-            }
+        return POINT_STOP;
+    }
 
-            const double ball_move_dist = M_first_point.dist( receive_point );
+    const double ball_move_dist = M_first_point.dist( receive_point );
 
-            if ( ball_move_dist < MIN_LEADING_PASS_DIST
-                 || MAX_LEADING_PASS_DIST < ball_move_dist )
-            {
+    if ( ball_move_dist < MIN_LEADING_PASS_DIST
+         || MAX_LEADING_PASS_DIST < ball_move_dist )
+    {
 #ifdef DEBUG_LEADING_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: xxx (lead) unum=%d overBallMoveDist=%.3f minDist=%.3f maxDist=%.3f",
-                              M_total_count, receiver.player_->unum(),
-                              ball_move_dist,
-                              MIN_LEADING_PASS_DIST, MAX_LEADING_PASS_DIST );
-                debug_paint_failed_pass( M_total_count, receive_point );
+        dlog.addText( Logger::PASS,
+                      "%d: xxx (lead) unum=%d overBallMoveDist=%.3f minDist=%.3f maxDist=%.3f",
+                      M_total_count, receiver.player_->unum(),
+                      ball_move_dist,
+                      MIN_LEADING_PASS_DIST, MAX_LEADING_PASS_DIST );
+        debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                continue;
-            }
+        return POINT_NEXT;
+    }
 
-            {
-                int nearest_receiver_unum = getNearestReceiverUnum( receive_point );
-                if ( nearest_receiver_unum != receiver.player_->unum() )
-                {
+    {
+        int nearest_receiver_unum = getNearestReceiverUnum( receive_point );
+        if ( nearest_receiver_unum != receiver.player_->unum() )
+        {
 #ifdef DEBUG_LEADING_PASS
-                    dlog.addText( Logger::PASS,
-                                  "%d: xxx (lead) unum=%d otherReceiver=%d pos=(%.2f %.2f)",
-                                  M_total_count, receiver.player_->unum(),
-                                  nearest_receiver_unum,
-                                  receive_point.x, receive_point.y );
-                    debug_paint_failed_pass( M_total_count, receive_point );
+            dlog.addText( Logger::PASS,
+                          "%d: xxx (lead) unum=%d otherReceiver=%d pos=(%.2f %.2f)",
+                          M_total_count, receiver.player_->unum(),
+                          nearest_receiver_unum,
+                          receive_point.x, receive_point.y );
+            debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                    break;
-                }
-            }
-
-            const int receiver_step = predictReceiverReachStep( receiver,
-                                                                receive_point,
-                                                                true )
-                + move_dist_penalty_step;
-            const AngleDeg ball_move_angle = ( receive_point - M_first_point ).th();
+            return POINT_BREAK;
+        }
+    }
 
-            const int min_ball_step = SP.ballMoveStep( SP.ballSpeedMax(), ball_move_dist );
+    const int receiver_step = predictReceiverReachStep( receiver,
+                                                        receive_point,
+                                                        true )
+        + move_dist_penalty_step;
+    const AngleDeg ball_move_angle = ( receive_point - M_first_point ).th();
 
-#ifdef DEBUG_PRINT_SUCCESS_PASS
-            success_counts.clear();
-#endif
+    const int min_ball_step = SP.ballMoveStep( SP.ballSpeedMax(), ball_move_dist );
 
-            const int start_step = std::max( std::max( MIN_RECEIVE_STEP,
-                                                       min_ball_step ),
-                                             receiver_step );
+    const int start_step = std::max( std::max( MIN_RECEIVE_STEP,
+                                               min_ball_step ),
+                                     receiver_step );
 
 // #ifdef DEBUG_LEADING_PASS
-//             dlog.addText( Logger::PASS,
-//                           "=== (lead) unum=%d MIN_RECEIVE_STEP=%d"
-//                           " min_ball_step=%d"
-//                           " receiver_step=%d",
-//                           receiver.player_->unum(),
-//                           MIN_RECEIVE_STEP, min_ball_step, receiver_step );
+//     dlog.addText( Logger::PASS,
+//                   "=== (lead) unum=%d MIN_RECEIVE_STEP=%d"
+//                   " min_ball_step=%d"
+//                   " receiver_step=%d",
+//                   receiver.player_->unum(),
+//                   MIN_RECEIVE_STEP, min_ball_step, receiver_step );
 // #endif
 
 #ifdef CREATE_SEVERAL_CANDIDATES_ON_SAME_POINT
-            const int max_step = std::max( MAX_RECEIVE_STEP, start_step + 3 );
+    const int max_step = std::max( MAX_RECEIVE_STEP, start_step + 3 );
 #else
-            const int max_step = start_step + 3;
+    const int max_step = start_step + 3;
 #endif
 
 #ifdef DEBUG_LEADING_PASS
-            dlog.addText( Logger::PASS,
-                          "=== (lead) receiver=%d"
-                          " receivePos=(%.1f %.1f)",
-                          receiver.player_->unum(),
-                          receive_point.x, receive_point.y );
-            dlog.addText( Logger::PASS,
-                          "__ ballMove=%.3f moveAngle=%.1f",
-                          ball_move_dist, ball_move_angle.degree() );
-            dlog.addText( Logger::PASS,
-                          "__ stepRange=[%d, %d] receiverStep=%d(penalty=%d)",
-                          start_step, max_step, receiver_step, move_dist_penalty_step );
+    dlog.addText( Logger::PASS,
+                  "=== (lead) receiver=%d"
+                  " receivePos=(%.1f %.1f)",
+                  receiver.player_->unum(),
+                  receive_point.x, receive_point.y );
+    dlog.addText( Logger::PASS,
+                  "__ ballMove=%.3f moveAngle=%.1f",
+                  ball_move_dist, ball_move_angle.degree() );
+    dlog.addText( Logger::PASS,
+                  "__ stepRange=[%d, %d] receiverStep=%d(penalty=%d)",
+                  start_step, max_step, receiver_step, move_dist_penalty_step );
 #endif
 
-            createPassCommon( wm,
-                              receiver, receive_point,
-                              start_step, max_step,
-                              min_ball_speed, max_ball_speed,
-                              min_receive_ball_speed, max_receive_ball_speed,
-                              ball_move_dist, ball_move_angle,
-                              "strictLead" );
-        }
-    }
+    createPassCommon( wm,
+                      receiver, receive_point,
+                      start_step, max_step,
+                      min_ball_speed, max_ball_speed,
+                      min_receive_ball_speed, max_receive_ball_speed,
+                      ball_move_dist, ball_move_angle,
+                      "strictLead" );
+
+    return POINT_NEXT;
 }
 
 /*-------------------------------------------------------------------*/
@@ -875,18 +1179,7 @@ void
 StrictCheckPassGenerator::createThroughPass( const WorldModel & wm,
                                              const Receiver & receiver )
 {
-    static const int MIN_RECEIVE_STEP = 6;
-#ifdef CREATE_SEVERAL_CANDIDATES_ON_SAME_POINT
-    static const int MAX_RECEIVE_STEP = 35;
-#endif
-
-    static const double MIN_THROUGH_PASS_DIST = 5.0;
-    static const double MAX_THROUGH_PASS_DIST
-        = 0.9 * inertia_final_distance( ServerParam::i().ballSpeedMax(),
-                                        ServerParam::i().ballDecay() );
-    static const double MAX_RECEIVE_BALL_SPEED
-        = ServerParam::i().ballSpeedMax()
-        * std::pow( ServerParam::i().ballDecay(), MIN_RECEIVE_STEP );
+    static const double MAX_MOVE_DIST = 30.0 + 0.001;
 
     static const int ANGLE_DIVS = 14;
     static const double MIN_ANGLE = -40.0;
@@ -894,16 +1187,9 @@ StrictCheckPassGenerator::createThroughPass( const WorldModel & wm,
     static const double ANGLE_STEP = ( MAX_ANGLE - MIN_ANGLE ) / ANGLE_DIVS;
 
     static const double MIN_MOVE_DIST = 6.0;
-    static const double MAX_MOVE_DIST = 30.0 + 0.001;
     static const double MOVE_DIST_STEP = 2.0;
 
-    const ServerParam & SP = ServerParam::i();
-    const PlayerType * ptype = receiver.player_->playerTypePtr();
-    const AngleDeg receiver_vel_angle = receiver.vel_.th();
-
-    const double min_receive_x = std::min( std::min( std::max( 10.0, M_first_point.x + 10.0 ),
-                                                     wm.offsideLineX() - 10.0 ),
-                                           SP.theirPenaltyAreaLineX() - 5.0 );
+    const double min_receive_x = through_pass_min_receive_x( wm, M_first_point );
 
     if ( receiver.pos_.x < min_receive_x - MAX_MOVE_DIST
          || receiver.pos_.x < 1.0 )
@@ -916,63 +1202,31 @@ StrictCheckPassGenerator::createThroughPass( const WorldModel & wm,
         return;
     }
 
-    //
-    // initialize ball speed range
-    //
-
-    const double max_ball_speed = ( wm.gameMode().type() == GameMode::PlayOn
-                                    ? SP.ballSpeedMax()
-                                    : wm.self().isKickable()
-                                    ? wm.self().kickRate() * SP.maxPower()
-                                    : SP.kickPowerRate() * SP.maxPower() );
-    const double min_ball_speed = 1.4; //SP.defaultPlayerSpeedMax();
-
-    const double max_receive_ball_speed
-        = std::min( MAX_RECEIVE_BALL_SPEED,
-                    ptype->kickableArea() + ( SP.maxDashPower()
-                                              * ptype->dashPowerRate()
-                                              * ptype->effortMax() ) * 1.5 );
-    const double min_receive_ball_speed = 0.001;
-
     //
     // check communication
     //
 
     bool pass_requested = false;
     AngleDeg requested_move_angle = 0.0;
-    if ( wm.audioMemory().passRequestTime().cycle() > wm.time().cycle() - 10 ) // Magic Number
+    if ( find_pass_request( wm,
+                            receiver.player_->unum(),
+                            receiver.inertia_pos_,
+                            &requested_move_angle ) )
     {
-        for ( std::vector< AudioMemory::PassRequest >::const_iterator it = wm.audioMemory().passRequest().begin();
-              it != wm.audioMemory().passRequest().end();
-              ++it )
-        {
-            if ( it->sender_ == receiver.player_->unum() )
-            {
-                pass_requested = true;
-                requested_move_angle = ( it->pos_ - receiver.inertia_pos_ ).th();
+        pass_requested = true;
 #ifdef DEBUG_THROUGH_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: (through) receiver=%d pass requested",
-                              M_total_count, receiver.player_->unum() );
+        dlog.addText( Logger::PASS,
+                      "%d: (through) receiver=%d pass requested",
+                      M_total_count, receiver.player_->unum() );
 #endif
-                break;
-            }
-        }
     }
 
     //
+    // angle loop. the angles near the center are tried first.
     //
-    //
-#ifdef DEBUG_PRINT_SUCCESS_PASS
-    std::vector< int > success_counts;
-    success_counts.reserve( 16 );
-#endif
-
-    //
-    // angle loop
-    //
-    for ( int a = 0; a <= ANGLE_DIVS; ++a )
+    for ( int i = 0; i <= ANGLE_DIVS; ++i )
     {
+        const int a = ANGLE_DIVS / 2 + GeneratorBudget::alternate_offset( i );
         const AngleDeg angle = MIN_ANGLE + ( ANGLE_STEP * a );
         const Vector2D unit_rvec = Vector2D::from_polar( 1.0, angle );
 
@@ -983,162 +1237,222 @@ StrictCheckPassGenerator::createThroughPass( const WorldModel & wm,
               move_dist < MAX_MOVE_DIST;
               move_dist += MOVE_DIST_STEP )
         {
-            ++M_total_count;
+            if ( ! M_budget.consume() )
+            {
+                return;
+            }
 
             const Vector2D receive_point
                 = receiver.inertia_pos_
                 + unit_rvec * move_dist;
 
+            if ( createThroughPassAt( wm, receiver, receive_point, angle,
+                                      pass_requested, requested_move_angle ) != POINT_NEXT )
+            {
+                break;
+            }
+        }
+
+    }
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+StrictCheckPassGenerator::PointResult
+StrictCheckPassGenerator::createThroughPassAt( const WorldModel & wm,
+                                               const Receiver & receiver,
+                                               const Vector2D & receive_point,
+                                               const AngleDeg & angle,
+                                               const bool pass_requested,
+                                               const AngleDeg & requested_move_angle )
+{
+    static const int MIN_RECEIVE_STEP = 6;
+#ifdef CREATE_SEVERAL_CANDIDATES_ON_SAME_POINT
+    static const int MAX_RECEIVE_STEP = 35;
+#endif
+
+    static const double MIN_THROUGH_PASS_DIST = 5.0;
+    static const double MAX_THROUGH_PASS_DIST
+        = 0.9 * inertia_final_distance( ServerParam::i().ballSpeedMax(),
+                                        ServerParam::i().ballDecay() );
+    static const double MAX_RECEIVE_BALL_SPEED
+        = ServerParam::i().ballSpeedMax()
+        * std::pow( ServerParam::i().ballDecay(), MIN_RECEIVE_STEP );
+
+    const ServerParam & SP = ServerParam::i();
+    const PlayerType * ptype = receiver.player_->playerTypePtr();
+    const AngleDeg receiver_vel_angle = receiver.vel_.th();
+
+    const double min_receive_x = through_pass_min_receive_x( wm, M_first_point );
+
+    //
+    // initialize ball speed range
+    //
+
+    const double max_ball_speed = ( wm.gameMode().type() == GameMode::PlayOn
+                                    ? SP.ballSpeedMax()
+                                    : wm.self().isKickable()
+                                    ? wm.self().kickRate() * SP.maxPower()
+                                    : SP.kickPowerRate() * SP.maxPower() );
+    const double min_ball_speed = 1.4; //SP.defaultPlayerSpeedMax();
+
+    const double max_receive_ball_speed
+        = std::min( MAX_RECEIVE_BALL_SPEED,
+                    ptype->kickableArea() + ( SP.maxDashPower()
+                                              * ptype->dashPowerRate()
+                                              * ptype->effortMax() ) * 1.5 );
+    const double min_receive_ball_speed = 0.001;
+
+    ++M_total_count;
+
 #ifdef DEBUG_THROUGH_PASS
-            dlog.addText( Logger::PASS,
-                          ">>>> (through) receiver=%d receivePoint=(%.1f %.1f)",
-                          receiver.player_->unum(),
-                          receive_point.x, receive_point.y );
+    dlog.addText( Logger::PASS,
+                  ">>>> (through) receiver=%d receivePoint=(%.1f %.1f)",
+                  receiver.player_->unum(),
+                  receive_point.x, receive_point.y );
 #endif
 
-            if ( receive_point.x < min_receive_x )
-            {
+    if ( receive_point.x < min_receive_x )
+    {
 #ifdef DEBUG_THROUGH_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: xxx (through) unum=%d tooSmallX pos=(%.2f %.2f)",
-                              M_total_count, receiver.player_->unum(),
-                              receive_point.x, receive_point.y );
-                debug_paint_failed_pass( M_total_count, receive_point );
+        dlog.addText( Logger::PASS,
+                      "%d: xxx (through) unum=%d tooSmallX pos=(%.2f %.2f)",
+                      M_total_count, receiver.player_->unum(),
+                      receive_point.x, receive_point.y );
+        debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                continue;
-            }
+        return POINT_NEXT;
+    }
 
-            if ( receive_point.x > SP.pitchHalfLength() - 1.5
-                 || receive_point.absY() > SP.pitchHalfWidth() - 1.5 )
-            {
+    if ( receive_point.x > SP.pitchHalfLength() - 1.5
+         || receive_point.absY() > SP.pitchHalfWidth() - 1.5 )
+    {
 #ifdef DEBUG_THROUGH_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: xxx (through) unum=%d outOfBounds pos=(%.2f %.2f)",
-                              M_total_count, receiver.player_->unum(),
-                              receive_point.x, receive_point.y );
-                debug_paint_failed_pass( M_total_count, receive_point );
+        dlog.addText( Logger::PASS,
+                      "%d: xxx (through) unum=%d outOfBounds pos=(%.2f %.2f)",
+                      M_total_count, receiver.player_->unum(),
+                      receive_point.x, receive_point.y );
+        debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                break;
-            }
+        return POINT_BREAK;
+    }
 
-            const double ball_move_dist = M_first_point.dist( receive_point );
+    const double ball_move_dist = M_first_point.dist( receive_point );
 
-            if ( ball_move_dist < MIN_THROUGH_PASS_DIST
-                 || MAX_THROUGH_PASS_DIST < ball_move_dist )
-            {
+    if ( ball_move_dist < MIN_THROUGH_PASS_DIST
+         || MAX_THROUGH_PASS_DIST < ball_move_dist )
+    {
 #ifdef DEBUG_THROUGH_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: xxx (through) unum=%d overBallMoveDist=%.3f minDist=%.3f maxDist=%.3f",
-                              M_total_count, receiver.player_->unum(),
-                              ball_move_dist,
-                              MIN_THROUGH_PASS_DIST, MAX_THROUGH_PASS_DIST );
-                debug_paint_failed_pass( M_total_count, receive_point );
+        dlog.addText( Logger::PASS,
+                      "%d: xxx (through) unum=%d overBallMoveDist=%.3f minDist=%.3f maxDist=%.3f",
+                      M_total_count, receiver.player_->unum(),
+                      ball_move_dist,
+                      MIN_THROUGH_PASS_DIST, MAX_THROUGH_PASS_DIST );
+        debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                continue;
-            }
+        return POINT_NEXT;
+    }
 
-            {
-                int nearest_receiver_unum = getNearestReceiverUnum( receive_point );
-                if ( nearest_receiver_unum != receiver.player_->unum() )
-                {
+    {
+        int nearest_receiver_unum = getNearestReceiverUnum( receive_point );
+        if ( nearest_receiver_unum != receiver.player_->unum() )
+        {
 #ifdef DEBUG_THROUGH_PASS
-                    dlog.addText( Logger::PASS,
-                                  "%d: xxx (through) unum=%d otherReceiver=%d pos=(%.2f %.2f)",
-                                  M_total_count, receiver.player_->unum(),
-                                  nearest_receiver_unum,
-                                  receive_point.x, receive_point.y );
-                    debug_paint_failed_pass( M_total_count, receive_point );
+            dlog.addText( Logger::PASS,
+                          "%d: xxx (through) unum=%d otherReceiver=%d pos=(%.2f %.2f)",
+                          M_total_count, receiver.player_->unum(),
+                          nearest_receiver_unum,
+                          receive_point.x, receive_point.y );
+            debug_paint_failed_pass( M_total_count, receive_point );
 #endif
-                    break;
-                }            }
-
+            return POINT_BREAK;
+        }
+    }
 
-            const int receiver_step = predictReceiverReachStep( receiver,
-                                                                receive_point,
-                                                                false );
-            const AngleDeg ball_move_angle = ( receive_point - M_first_point ).th();
 
-#ifdef DEBUG_PRINT_SUCCESS_PASS
-            success_counts.clear();
-#endif
+    const int receiver_step = predictReceiverReachStep( receiver,
+                                                        receive_point,
+                                                        false );
+    const AngleDeg ball_move_angle = ( receive_point - M_first_point ).th();
 
-            int start_step = receiver_step;
-            if ( pass_requested
-                 && ( requested_move_angle - angle ).abs() < 20.0 )
-            {
+    int start_step = receiver_step;
+    if ( pass_requested
+         && ( requested_move_angle - angle ).abs() < 20.0 )
+    {
 #ifdef DEBUG_THROUGH_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: matched with requested pass. angle=%.1f",
-                              M_total_count, angle.degree() );
+        dlog.addText( Logger::PASS,
+                      "%d: matched with requested pass. angle=%.1f",
+                      M_total_count, angle.degree() );
 #endif
-            }
-            // if ( receive_point.x > wm.offsideLineX() + 5.0
-            //      || ball_move_angle.abs() < 15.0 )
-            else if ( receiver.speed_ > 0.2
-                      && ( receiver_vel_angle - angle ).abs() < 15.0 )
-            {
+    }
+    // if ( receive_point.x > wm.offsideLineX() + 5.0
+    //      || ball_move_angle.abs() < 15.0 )
+    else if ( receiver.speed_ > 0.2
+              && ( receiver_vel_angle - angle ).abs() < 15.0 )
+    {
 #ifdef DEBUG_THROUGH_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: matched with receiver velocity. angle=%.1f",
-                              M_total_count, angle.degree() );
+        dlog.addText( Logger::PASS,
+                      "%d: matched with receiver velocity. angle=%.1f",
+                      M_total_count, angle.degree() );
 #endif
-            }
-            else
-            {
+    }
+    else
+    {
 #ifdef DEBUG_THROUGH_PASS
-                dlog.addText( Logger::PASS,
-                              "%d: receiver step. one step penalty",
-                              M_total_count );
-#endif
-                start_step += 1;
-                if ( ( receive_point.x > SP.pitchHalfLength() - 5.0
-                       || receive_point.absY() > SP.pitchHalfWidth() - 5.0 )
-                     && ball_move_angle.abs() > 30.0
-                     && start_step >= 10 )
-                {
-                    start_step += 1;
-                }
-            }
+        dlog.addText( Logger::PASS,
+                      "%d: receiver step. one step penalty",
+                      M_total_count );
+#endif
+        start_step += 1;
+        if ( ( receive_point.x > SP.pitchHalfLength() - 5.0
+               || receive_point.absY() > SP.pitchHalfWidth() - 5.0 )
+             && ball_move_angle.abs() > 30.0
+             && start_step >= 10 )
+        {
+            start_step += 1;
+        }
+    }
 
-            const int min_ball_step = SP.ballMoveStep( SP.ballSpeedMax(), ball_move_dist );
+    const int min_ball_step = SP.ballMoveStep( SP.ballSpeedMax(), ball_move_dist );
 
-            start_step = std::max( std::max( MIN_RECEIVE_STEP,
-                                             min_ball_step ),
-                                   start_step );
+    start_step = std::max( std::max( MIN_RECEIVE_STEP,
+                                     min_ball_step ),
+                           start_step );
 
 #ifdef CREATE_SEVERAL_CANDIDATES_ON_SAME_POINT
-            const int max_step = std::max( MAX_RECEIVE_STEP, start_step + 3 );
+    const int max_step = std::max( MAX_RECEIVE_STEP, start_step + 3 );
 #else
-            const int max_step = start_step + 3;
+    const int max_step = start_step + 3;
 #endif
 
 #ifdef DEBUG_THROUGH_PASS
-            dlog.addText( Logger::PASS,
-                          "== (through) receiver=%d"
-                          " ballPos=(%.1f %.1f) receivePos=(%.1f %.1f)",
-                          receiver.player_->unum(),
-                          M_first_point.x, M_first_point.y,
-                          receive_point.x, receive_point.y );
-            dlog.addText( Logger::PASS,
-                          "== ballMove=%.3f moveAngle=%.1f",
-                          ball_move_dist, ball_move_angle.degree() );
-            dlog.addText( Logger::PASS,
-                          "== stepRange=[%d, %d] receiverMove=%.3f receiverStep=%d",
-                          start_step, max_step,
-                          receiver.inertia_pos_.dist( receive_point ), receiver_step );
-#endif
-
-            createPassCommon( wm,
-                              receiver, receive_point,
-                              start_step, max_step,
-                              min_ball_speed, max_ball_speed,
-                              min_receive_ball_speed, max_receive_ball_speed,
-                              ball_move_dist, ball_move_angle,
-                              "strictThrough" );
-        }
+    dlog.addText( Logger::PASS,
+                  "== (through) receiver=%d"
+                  " ballPos=(%.1f %.1f) receivePos=(%.1f %.1f)",
+                  receiver.player_->unum(),
+                  M_first_point.x, M_first_point.y,
+                  receive_point.x, receive_point.y );
+    dlog.addText( Logger::PASS,
+                  "== ballMove=%.3f moveAngle=%.1f",
+                  ball_move_dist, ball_move_angle.degree() );
+    dlog.addText( Logger::PASS,
+                  "== stepRange=[%d, %d] receiverMove=%.3f receiverStep=%d",
+                  start_step, max_step,
+                  receiver.inertia_pos_.dist( receive_point ), receiver_step );
+#endif
 
-    }
+    createPassCommon( wm,
+                      receiver, receive_point,
+                      start_step, max_step,
+                      min_ball_speed, max_ball_speed,
+                      min_receive_ball_speed, max_receive_ball_speed,
+                      ball_move_dist, ball_move_angle,
+                      "strictThrough" );
 
+    return POINT_NEXT;
 }
 
 /*-------------------------------------------------------------------*/
@@ -1160,6 +1474,7 @@ StrictCheckPassGenerator::createPassCommon( const WorldModel & wm,
                                             const char * description )
 {
     const ServerParam & SP = ServerParam::i();
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
 
     int success_count = 0;
 #ifdef DEBUG_PRINT_SUCCESS_PASS
@@ -1171,9 +1486,7 @@ StrictCheckPassGenerator::createPassCommon( const WorldModel & wm,
     {
         ++M_total_count;
 
-        double first_ball_speed = calc_first_term_geom_series( ball_move_dist,
-                                                               SP.ballDecay(),
-                                                               step );
+        double first_ball_speed = ball_kinematics.firstSpeed( ball_move_dist, step );
 
 #if (defined DEBUG_PRINT_DIRECT_PASS) || (defined DEBUG_PRINT_LEADING_PASS) || (defined DEBUG_PRINT_THROUGH_PASS) || (defined DEBUG_PRINT_FAILED_PASS)
         dlog.addText( Logger::PASS,
@@ -1216,7 +1529,7 @@ StrictCheckPassGenerator::createPassCommon( const WorldModel & wm,
             continue;
         }
 
-        double receive_ball_speed = first_ball_speed * std::pow( SP.ballDecay(), step );
+        double receive_ball_speed = ball_kinematics.speedAfter( first_ball_speed, step );
         if ( receive_ball_speed < min_receive_ball_speed )
         {
 #ifdef DEBUG_PRINT_FAILED_PASS
@@ -1317,6 +1630,13 @@ StrictCheckPassGenerator::createPassCommon( const WorldModel & wm,
             break;
         }
 
+        if ( M_speculating )
+        {
+            M_speculative_courses.push_back( SpeculativeCourse( receiver.player_->unum(),
+                                                                receive_point,
+                                                                M_pass_type ) );
+        }
+
         CooperativeAction::Ptr pass( new Pass( M_passer->unum(),
                                                receiver.player_->unum(),
                                                receive_point,
@@ -1453,6 +1773,26 @@ StrictCheckPassGenerator::getNearestReceiverUnum( const Vector2D & pos )
     return unum;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const StrictCheckPassGenerator::Receiver *
+StrictCheckPassGenerator::getReceiver( const int unum ) const
+{
+    for ( ReceiverCont::const_iterator p = M_receiver_candidates.begin();
+          p != M_receiver_candidates.end();
+          ++p )
+    {
+        if ( p->player_->unum() == unum )
+        {
+            return &(*p);
+        }
+    }
+
+    return static_cast< const Receiver * >( 0 );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1610,6 +1950,7 @@ StrictCheckPassGenerator::predictOpponentReachStep( const WorldModel & wm,
     static const double CONTROL_AREA_BUF = 0.15;
 
     const ServerParam & SP = ServerParam::i();
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
 
     const PlayerType * ptype = opponent.player_->playerTypePtr();
     const int min_cycle = FieldAnalyzer::estimate_min_reach_cycle( opponent.pos_,
@@ -1637,10 +1978,9 @@ StrictCheckPassGenerator::predictOpponentReachStep( const WorldModel & wm,
 
     for ( int cycle = std::max( 1, min_cycle ); cycle <= max_cycle; ++cycle )
     {
-        const Vector2D ball_pos = inertia_n_step_point( first_ball_pos,
-                                                        first_ball_vel,
-                                                        cycle,
-                                                        SP.ballDecay() );
+        const Vector2D ball_pos = ball_kinematics.inertiaPoint( first_ball_pos,
+                                                                first_ball_vel,
+                                                                cycle );
         const double control_area = ( opponent.player_->goalie()
                                       && penalty_area.contains( ball_pos )
                                       ? SP.catchableArea()
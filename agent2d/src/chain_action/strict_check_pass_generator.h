@@ -33,6 +33,7 @@
 #define STRICT_CHECK_PASS_GENERATOR_H
 
 #include "cooperative_action.h"
+#include "generator_budget.h"
 
 #include <rcsc/player/abstract_player_object.h>
 #include <rcsc/geom/vector_2d.h>
@@ -84,6 +85,33 @@ public:
 
     typedef std::vector< Opponent > OpponentCont;
 
+    /*!
+      \brief pass course precomputed in the idle time of the previous cycle.
+      The receive point is checked again in the next cycle.
+     */
+    struct SpeculativeCourse {
+        int receiver_unum_;
+        rcsc::Vector2D receive_point_;
+        char pass_type_;
+
+        SpeculativeCourse( const int receiver_unum,
+                           const rcsc::Vector2D & receive_point,
+                           const char pass_type )
+            : receiver_unum_( receiver_unum ),
+              receive_point_( receive_point ),
+              pass_type_( pass_type )
+          { }
+    };
+
+    /*!
+      \brief result of the check for one receive point.
+     */
+    enum PointResult {
+        POINT_NEXT, //!< try the next receive point
+        POINT_BREAK, //!< skip the rest of the current loop
+        POINT_STOP //!< skip the rest of the receiver
+    };
+
 private:
 
     rcsc::GameTime M_update_time;
@@ -102,6 +130,20 @@ private:
     int M_through_size;
     std::vector< CooperativeAction::Ptr > M_courses;
 
+    GeneratorBudget M_budget;
+
+    //
+    // speculative generation
+    //
+    bool M_speculation_enabled;
+    bool M_speculating; //!< true while speculate() is running
+    rcsc::GameTime M_speculation_time; //!< time when the speculation was done
+    int M_speculative_passer_unum; //!< predicted passer
+    rcsc::Vector2D M_speculative_first_point; //!< predicted first ball point
+    int M_speculative_receivers; //!< bit flags of the receiver's uniform number
+    double M_speculative_offside_line_x; //!< offside line used by the speculation
+    std::vector< SpeculativeCourse > M_speculative_courses;
+
 
     // private for singleton
     StrictCheckPassGenerator();
@@ -123,6 +165,40 @@ public:
           return M_courses;
       }
 
+    /*!
+      \brief set the search budget.
+      \param max_msec time limit [ms]. a non positive value means unlimited.
+      \param max_count the maximum number of receive points.
+     */
+    void setBudget( const double & max_msec,
+                    const int max_count )
+      {
+          M_budget.setLimits( max_msec, max_count );
+      }
+
+    /*!
+      \brief check if the last search was cut by the budget.
+      \return true if the generated courses are a partial result.
+     */
+    bool truncated() const
+      {
+          return M_budget.truncated();
+      }
+
+    void setSpeculationEnabled( const bool on )
+      {
+          M_speculation_enabled = on;
+      }
+
+    /*!
+      \brief precompute the pass courses for the predicted next passer.
+      This method is expected to be called in the idle time after the
+      command has been sent. The result is validated and patched by
+      generate() in the next cycle.
+      \param wm world model reference
+     */
+    void speculate( const rcsc::WorldModel & wm );
+
 private:
 
     void clear();
@@ -138,13 +214,31 @@ private:
 
     void createCourses( const rcsc::WorldModel & wm );
 
+    /*!
+      \brief validate the speculative courses with the current world model.
+      All speculated receive points are checked again by the same code
+      as the full search.
+      \param wm world model reference
+      \return true if all speculative courses are still valid.
+     */
+    bool patchSpeculativeCourses( const rcsc::WorldModel & wm );
+
     void createDirectPass( const rcsc::WorldModel & wm ,
                            const Receiver & receiver );
     void createLeadingPass( const rcsc::WorldModel & wm ,
                             const Receiver & receiver );
+    PointResult createLeadingPassAt( const rcsc::WorldModel & wm,
+                                     const Receiver & receiver,
+                                     const rcsc::Vector2D & receive_point );
 
     void createThroughPass( const rcsc::WorldModel & wm ,
                             const Receiver & receiver );
+    PointResult createThroughPassAt( const rcsc::WorldModel & wm,
+                                     const Receiver & receiver,
+                                     const rcsc::Vector2D & receive_point,
+                                     const rcsc::AngleDeg & angle,
+                                     const bool pass_requested,
+                                     const rcsc::AngleDeg & requested_move_angle );
 
     void createPassCommon( const rcsc::WorldModel & wm,
                            const Receiver & receiver,
@@ -160,6 +254,8 @@ private:
                            const char * description );
 
     int getNearestReceiverUnum( const rcsc::Vector2D & pos );
+    const Receiver * getReceiver( const int unum ) const;
+    int getReceiverMask() const;
 
     int predictReceiverReachStep( const Receiver & receiver,
                                   const rcsc::Vector2D & pos,
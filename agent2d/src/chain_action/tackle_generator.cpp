@@ -35,6 +35,7 @@
 
 #include "tackle_generator.h"
 
+#include "ball_kinematics.h"
 #include "field_analyzer.h"
 
 #include <rcsc/player/player_agent.h>
@@ -45,7 +46,9 @@
 #include <rcsc/math_util.h>
 #include <rcsc/timer.h>
 
+#include <algorithm>
 #include <limits>
+#include <cmath>
 
 #define ASUUME_OPPONENT_KICK
 
@@ -174,6 +177,10 @@ TackleGenerator::TackleResult::clear()
 TackleGenerator::TackleGenerator()
 {
     M_candidates.reserve( ANGLE_DIVS );
+    M_reach_candidates.reserve( ANGLE_DIVS );
+    M_first_min_step.reserve( ANGLE_DIVS );
+    M_min_step.reserve( ANGLE_DIVS );
+    M_opponent_min_cycle.reserve( ANGLE_DIVS );
     clear();
 }
 
@@ -197,6 +204,8 @@ TackleGenerator::clear()
 {
     M_best_result = TackleResult();
     M_candidates.clear();
+    M_reach_candidates.clear();
+    M_max_cycle = 0;
 }
 
 /*-------------------------------------------------------------------*/
@@ -342,6 +351,11 @@ TackleGenerator::calculate( const WorldModel & wm )
     }
 
 
+    //
+    // score all candidates at once
+    //
+    evaluate( wm );
+
     M_best_result.clear();
 
     const Container::iterator end = M_candidates.end();
@@ -349,8 +363,6 @@ TackleGenerator::calculate( const WorldModel & wm )
           it != end;
           ++it )
     {
-        it->score_ = evaluate( wm, *it );
-
 #ifdef DEBUG_PRINT
         Vector2D ball_end_point = inertia_final_point( wm.ball().pos(),
                                                        it->ball_vel_,
@@ -396,9 +408,52 @@ TackleGenerator::calculate( const WorldModel & wm )
 /*!
 
  */
-double
-TackleGenerator::evaluate( const WorldModel & wm,
-                           const TackleResult & result )
+void
+TackleGenerator::evaluate( const WorldModel & wm )
+{
+    //
+    // shoot or own goal
+    //
+    M_reach_candidates.clear();
+
+    const int size = M_candidates.size();
+    for ( int i = 0; i < size; ++i )
+    {
+        if ( ! evaluateGoalCourse( wm, M_candidates[i] ) )
+        {
+            M_reach_candidates.push_back( i );
+        }
+    }
+
+    if ( M_reach_candidates.empty() )
+    {
+        return;
+    }
+
+    //
+    // opponent reach step for all other candidates
+    //
+    createBallTrajectories( wm );
+    predictOpponentsReachStep( wm );
+
+    const int reach_size = M_reach_candidates.size();
+    for ( int i = 0; i < reach_size; ++i )
+    {
+        const int opponent_reach_step = ( M_min_step[i] == M_first_min_step[i]
+                                          ? 1000
+                                          : M_min_step[i] );
+        TackleResult & result = M_candidates[M_reach_candidates[i]];
+        result.score_ = evaluateNormalCourse( wm, result, opponent_reach_step );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+TackleGenerator::evaluateGoalCourse( const WorldModel & wm,
+                                     TackleResult & result )
 {
     const ServerParam & SP = ServerParam::i();
 
@@ -407,14 +462,13 @@ TackleGenerator::evaluate( const WorldModel & wm,
                                                          SP.ballDecay() );
     const Segment2D ball_line( wm.ball().pos(), ball_end_point );
     const double ball_speed = result.ball_speed_;
-    const AngleDeg ball_move_angle = result.ball_move_angle_;
 
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::CLEAR,
                   "(evaluate) angle=%.1f speed=%.2f move_angle=%.1f end_point=(%.2f %.2f)",
                   result.tackle_angle_.degree(),
                   ball_speed,
-                  ball_move_angle.degree(),
+                  result.ball_move_angle_.degree(),
                   ball_end_point.x, ball_end_point.y );
 #endif
 
@@ -442,7 +496,8 @@ TackleGenerator::evaluate( const WorldModel & wm,
                           "__ shoot %f (speed_rate=%f y_rate=%f)",
                           shoot_score, speed_rate, y_rate );
 #endif
-            return shoot_score;
+            result.score_ = shoot_score;
+            return true;
         }
     }
 
@@ -470,22 +525,30 @@ TackleGenerator::evaluate( const WorldModel & wm,
                           "__ in our goal %f (y_pealty=%f speed_bonus=%f)",
                           shoot_score, y_penalty, speed_bonus );
 #endif
-            return shoot_score;
+            result.score_ = shoot_score;
+            return true;
         }
     }
 
-    //
-    // normal evaluation
-    //
+    return false;
+}
 
-    int opponent_reach_step = predictOpponentsReachStep( wm,
-                                                         wm.ball().pos(),
-                                                         result.ball_vel_,
-                                                         ball_move_angle );
-    Vector2D final_point = inertia_n_step_point( wm.ball().pos(),
-                                                 result.ball_vel_,
-                                                 opponent_reach_step,
-                                                 SP.ballDecay() );
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+TackleGenerator::evaluateNormalCourse( const WorldModel & wm,
+                                       const TackleResult & result,
+                                       const int opponent_reach_step )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    const AngleDeg ball_move_angle = result.ball_move_angle_;
+
+    Vector2D final_point = BallKinematics::instance().inertiaPoint( wm.ball().pos(),
+                                                                    result.ball_vel_,
+                                                                    opponent_reach_step );
     {
         Segment2D final_segment( wm.ball().pos(), final_point );
         Rect2D pitch = Rect2D::from_center( 0.0, 0.0, SP.pitchLength(), SP.pitchWidth() );
@@ -599,62 +662,171 @@ TackleGenerator::evaluate( const WorldModel & wm,
 /*!
 
  */
-int
-TackleGenerator::predictOpponentsReachStep( const WorldModel & wm,
-                                            const Vector2D & first_ball_pos,
-                                            const Vector2D & first_ball_vel,
-                                            const AngleDeg & ball_move_angle )
+void
+TackleGenerator::createBallTrajectories( const WorldModel & wm )
 {
-    int first_min_step = 50;
-
-#if 1
     const ServerParam & SP = ServerParam::i();
-    const Vector2D ball_end_point = inertia_final_point( first_ball_pos,
-                                                         first_ball_vel,
-                                                         SP.ballDecay() );
-    if ( ball_end_point.absX() > SP.pitchHalfLength()
-         || ball_end_point.absY() > SP.pitchHalfWidth() )
+    const Vector2D first_ball_pos = wm.ball().pos();
+    const int size = M_reach_candidates.size();
+
+    //
+    // initial reach step of each candidate
+    //
+    M_first_min_step.resize( size );
+    M_max_cycle = 0;
+
+    for ( int i = 0; i < size; ++i )
     {
-        Rect2D pitch = Rect2D::from_center( 0.0, 0.0, SP.pitchLength(), SP.pitchWidth() );
-        Ray2D ball_ray( first_ball_pos, ball_move_angle );
-        Vector2D sol1, sol2;
-        int n_sol = pitch.intersection( ball_ray, &sol1, &sol2 );
-        if ( n_sol == 1 )
+        const TackleResult & result = M_candidates[M_reach_candidates[i]];
+
+        int first_min_step = 50;
+
+#if 1
+        const Vector2D ball_end_point = inertia_final_point( first_ball_pos,
+                                                             result.ball_vel_,
+                                                             SP.ballDecay() );
+        if ( ball_end_point.absX() > SP.pitchHalfLength()
+             || ball_end_point.absY() > SP.pitchHalfWidth() )
         {
-            first_min_step = SP.ballMoveStep( first_ball_vel.r(), first_ball_pos.dist( sol1 ) );
+            Rect2D pitch = Rect2D::from_center( 0.0, 0.0, SP.pitchLength(), SP.pitchWidth() );
+            Ray2D ball_ray( first_ball_pos, result.ball_move_angle_ );
+            Vector2D sol1, sol2;
+            int n_sol = pitch.intersection( ball_ray, &sol1, &sol2 );
+            if ( n_sol == 1 )
+            {
+                first_min_step = SP.ballMoveStep( result.ball_speed_, first_ball_pos.dist( sol1 ) );
 #ifdef DEBUG_PRINT
-            dlog.addText( Logger::CLEAR,
-                          "(predictOpponent) ball will be out. step=%d reach_point=(%.2f %.2f)",
-                          first_min_step,
-                          sol1.x, sol1.y );
+                dlog.addText( Logger::CLEAR,
+                              "(createBallTrajectories) ball will be out. step=%d reach_point=(%.2f %.2f)",
+                              first_min_step,
+                              sol1.x, sol1.y );
+#endif
+            }
+        }
 #endif
+
+        M_first_min_step[i] = first_min_step;
+        M_max_cycle = std::max( M_max_cycle, first_min_step );
+    }
+
+    M_min_step = M_first_min_step;
+
+    //
+    // ball positions of all candidates for each cycle.
+    // the inner loop has no dependency between candidates.
+    //
+    M_ball_x.resize( std::max( 1, M_max_cycle ) * size );
+    M_ball_y.resize( std::max( 1, M_max_cycle ) * size );
+    M_dist.resize( std::max( 1, M_max_cycle ) * size );
+
+    const BallKinematics & ball_kinematics = BallKinematics::instance();
+    for ( int cycle = 0; cycle < M_max_cycle; ++cycle )
+    {
+        const double move_rate = ball_kinematics.moveRate( cycle );
+        double * x = &M_ball_x[cycle * size];
+        double * y = &M_ball_y[cycle * size];
+
+        for ( int i = 0; i < size; ++i )
+        {
+            const Vector2D & vel = M_candidates[M_reach_candidates[i]].ball_vel_;
+            x[i] = first_ball_pos.x + vel.x * move_rate;
+            y[i] = first_ball_pos.y + vel.y * move_rate;
         }
     }
-#endif
+}
 
-    int min_step = first_min_step;
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TackleGenerator::predictOpponentsReachStep( const WorldModel & wm )
+{
     for ( AbstractPlayerCont::const_iterator
               o = wm.theirPlayers().begin(),
               end = wm.theirPlayers().end();
           o != end;
           ++o )
     {
-        int step = predictOpponentReachStep( *o,
-                                             first_ball_pos,
-                                             first_ball_vel,
-                                             ball_move_angle,
-                                             min_step );
-        if ( step < min_step )
+        predictOpponentReachStep( *o, wm.ball().pos() );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TackleGenerator::predictOpponentReachStep( const AbstractPlayerObject * opponent,
+                                           const Vector2D & first_ball_pos )
+{
+    const PlayerType * ptype = opponent->playerTypePtr();
+    const int size = M_reach_candidates.size();
+
+    //
+    // estimate the min reach cycle for each candidate
+    //
+    M_opponent_min_cycle.resize( size );
+
+    int first_cycle = M_max_cycle;
+    int last_cycle = -1;
+    for ( int i = 0; i < size; ++i )
+    {
+        int min_cycle = FieldAnalyzer::estimate_min_reach_cycle( opponent->pos(),
+                                                                 ptype->realSpeedMax(),
+                                                                 first_ball_pos,
+                                                                 M_candidates[M_reach_candidates[i]].ball_move_angle_ );
+        if ( min_cycle < 0 )
+        {
+            min_cycle = 10;
+        }
+        M_opponent_min_cycle[i] = min_cycle;
+
+        if ( min_cycle < M_min_step[i] )
         {
-            min_step = step;
+            first_cycle = std::min( first_cycle, min_cycle );
+            last_cycle = std::max( last_cycle, M_min_step[i] - 1 );
         }
     }
 
-    return ( min_step == first_min_step
-             ? 1000
-             : min_step );
-}
+    if ( first_cycle > last_cycle )
+    {
+        return;
+    }
+
+    //
+    // opponent distance to the ball for all candidates
+    //
+    M_opponent_inertia_pos.resize( M_max_cycle );
+    for ( int cycle = first_cycle; cycle <= last_cycle; ++cycle )
+    {
+        const Vector2D inertia_pos = opponent->inertiaPoint( cycle );
+        M_opponent_inertia_pos[cycle] = inertia_pos;
+
+        const double * x = &M_ball_x[cycle * size];
+        const double * y = &M_ball_y[cycle * size];
+        double * dist = &M_dist[cycle * size];
 
+        for ( int i = 0; i < size; ++i )
+        {
+            const double dx = x[i] - inertia_pos.x;
+            const double dy = y[i] - inertia_pos.y;
+            dist[i] = std::sqrt( dx * dx + dy * dy );
+        }
+    }
+
+    //
+    // update the reach step of each candidate
+    //
+    for ( int i = 0; i < size; ++i )
+    {
+        int step = predictOpponentReachStep( opponent, i, M_min_step[i] );
+        if ( step < M_min_step[i] )
+        {
+            M_min_step[i] = step;
+        }
+    }
+}
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -662,31 +834,21 @@ TackleGenerator::predictOpponentsReachStep( const WorldModel & wm,
  */
 int
 TackleGenerator::predictOpponentReachStep( const AbstractPlayerObject * opponent,
-                                           const Vector2D & first_ball_pos,
-                                           const Vector2D & first_ball_vel,
-                                           const AngleDeg & ball_move_angle,
+                                           const int candidate,
                                            const int max_cycle )
 {
     const ServerParam & SP = ServerParam::i();
 
     const PlayerType * ptype = opponent->playerTypePtr();
     const double opponent_speed = opponent->vel().r();
+    const int size = M_reach_candidates.size();
 
-    int min_cycle = FieldAnalyzer::estimate_min_reach_cycle( opponent->pos(),
-                                                             ptype->realSpeedMax(),
-                                                             first_ball_pos,
-                                                             ball_move_angle );
-    if ( min_cycle < 0 )
-    {
-        min_cycle = 10;
-    }
+    const int min_cycle = M_opponent_min_cycle[candidate];
 
     for ( int cycle = min_cycle; cycle < max_cycle; ++cycle )
     {
-        Vector2D ball_pos = inertia_n_step_point( first_ball_pos,
-                                                  first_ball_vel,
-                                                  cycle,
-                                                  SP.ballDecay() );
+        const Vector2D ball_pos( M_ball_x[cycle * size + candidate],
+                                 M_ball_y[cycle * size + candidate] );
 
         if ( ball_pos.absX() > SP.pitchHalfLength()
              || ball_pos.absY() > SP.pitchHalfWidth() )
@@ -701,8 +863,8 @@ TackleGenerator::predictOpponentReachStep( const AbstractPlayerObject * opponent
             return 1000;
         }
 
-        Vector2D inertia_pos = opponent->inertiaPoint( cycle );
-        double target_dist = inertia_pos.dist( ball_pos );
+        const Vector2D & inertia_pos = M_opponent_inertia_pos[cycle];
+        const double target_dist = M_dist[cycle * size + candidate];
 
         if ( target_dist - ptype->kickableArea() < 0.001 )
         {
@@ -73,6 +73,27 @@ private:
     //! best tackle result
     TackleResult M_best_result;
 
+    //
+    // candidates evaluated by the opponent reach step (structure of arrays)
+    //
+    std::vector< int > M_reach_candidates; //!< index of M_candidates
+    std::vector< int > M_first_min_step; //!< initial reach step (ball out of pitch)
+    std::vector< int > M_min_step; //!< opponent reach step for each candidate
+    int M_max_cycle; //!< row size of the trajectory table
+
+    //
+    // ball trajectories and opponent distances. index = cycle * size + candidate
+    //
+    std::vector< double > M_ball_x;
+    std::vector< double > M_ball_y;
+    std::vector< double > M_dist;
+
+    //
+    // work area for each opponent
+    //
+    std::vector< int > M_opponent_min_cycle; //!< estimated min reach cycle for each candidate
+    std::vector< rcsc::Vector2D > M_opponent_inertia_pos; //!< inertia position for each cycle
+
     // private for singleton
     TackleGenerator();
 
@@ -104,17 +125,20 @@ private:
     void clear();
 
     void calculate( const rcsc::WorldModel & wm );
-    double evaluate( const rcsc::WorldModel & wm,
-                     const TackleResult & result );
 
-    int predictOpponentsReachStep( const rcsc::WorldModel & wm,
-                                   const rcsc::Vector2D & first_ball_pos,
-                                   const rcsc::Vector2D & first_ball_vel,
-                                   const rcsc::AngleDeg & ball_move_angle );
+    void evaluate( const rcsc::WorldModel & wm );
+    bool evaluateGoalCourse( const rcsc::WorldModel & wm,
+                             TackleResult & result );
+    double evaluateNormalCourse( const rcsc::WorldModel & wm,
+                                 const TackleResult & result,
+                                 const int opponent_reach_step );
+
+    void createBallTrajectories( const rcsc::WorldModel & wm );
+    void predictOpponentsReachStep( const rcsc::WorldModel & wm );
+    void predictOpponentReachStep( const rcsc::AbstractPlayerObject * opponent,
+                                   const rcsc::Vector2D & first_ball_pos );
     int predictOpponentReachStep( const rcsc::AbstractPlayerObject * opponent,
-                                  const rcsc::Vector2D & first_ball_pos,
-                                  const rcsc::Vector2D & first_ball_vel,
-                                  const rcsc::AngleDeg & ball_move_angle,
+                                  const int candidate,
                                   const int max_cycle );
 
 };
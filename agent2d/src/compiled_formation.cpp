@@ -0,0 +1,1024 @@
+// -*-c++-*-
+
+/*!
+  \file compiled_formation.cpp
+  \brief precompiled binary formation data Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "compiled_formation.h"
+
+#include <rcsc/formation/formation.h>
+#include <rcsc/formation/formation_dt.h>
+
+#include <boost/static_assert.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace rcsc;
+
+const std::string CompiledFormation::CACHE_SUFFIX = ".bin";
+
+namespace {
+
+const char MAGIC[8] = { 'A', '2', 'D', 'F', 'O', 'R', 'M', '\0' };
+const boost::uint32_t BYTE_ORDER_MARK = 0x01020304;
+const boost::uint32_t FORMAT_VERSION = 1;
+
+//! the number of the point location buckets along each axis
+const int GRID_DIVS = 16;
+
+//! tolerance of the barycentric coordinates
+const double WEIGHT_EPS = 1.0e-9;
+
+//! area of the baked grid. the focus point is clamped into this area.
+const double BAKE_HALF_LENGTH = 57.5;
+const double BAKE_HALF_WIDTH = 39.0;
+
+BOOST_STATIC_ASSERT( sizeof( CompiledFormation::Header ) % 8 == 0 );
+BOOST_STATIC_ASSERT( sizeof( CompiledFormation::Triangle ) == 64 );
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+boost::uint64_t
+align8( const boost::uint64_t size )
+{
+    return ( size + 7 ) & ~static_cast< boost::uint64_t >( 7 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+bool
+in_range( const boost::uint64_t offset,
+          const boost::uint64_t length,
+          const boost::uint64_t size )
+{
+    return ( offset % 8 == 0
+             && offset <= size
+             && length <= size - offset );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CompiledFormation::CompiledFormation()
+    : M_map_addr( static_cast< void * >( 0 ) ),
+      M_map_size( 0 ),
+      M_data( static_cast< const char * >( 0 ) ),
+      M_header( static_cast< const Header * >( 0 ) ),
+      M_ball( static_cast< const double * >( 0 ) ),
+      M_player( static_cast< const double * >( 0 ) ),
+      M_triangles( static_cast< const Triangle * >( 0 ) ),
+      M_cell_begin( static_cast< const boost::int32_t * >( 0 ) ),
+      M_cell_triangles( static_cast< const boost::int32_t * >( 0 ) ),
+      M_baked( static_cast< const float * >( 0 ) ),
+      M_baked_cols( 0 ),
+      M_baked_rows( 0 ),
+      M_baked_min_x( 0.0 ),
+      M_baked_min_y( 0.0 ),
+      M_baked_step( 0.0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CompiledFormation::~CompiledFormation()
+{
+    if ( M_map_addr )
+    {
+        ::munmap( M_map_addr, M_map_size );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CompiledFormation::Ptr
+CompiledFormation::compile( const Formation & formation,
+                            const boost::uint64_t source_checksum )
+{
+    //
+    // collect the samples and the triangulation
+    //
+    std::vector< Vector2D > balls;
+    std::vector< Vector2D > players;
+    std::vector< boost::int32_t > vertices;
+
+    const FormationDT * dt = dynamic_cast< const FormationDT * >( &formation );
+    if ( dt )
+    {
+        const SampleDataSet::DataCont & samples = dt->samples()->dataCont();
+        for ( SampleDataSet::DataCont::const_iterator d = samples.begin();
+              d != samples.end();
+              ++d )
+        {
+            if ( d->players_.size() != 11 )
+            {
+                std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                          << " ***ERROR*** illegal sample size "
+                          << d->players_.size() << std::endl;
+                return Ptr();
+            }
+
+            balls.push_back( d->ball_ );
+            players.insert( players.end(), d->players_.begin(), d->players_.end() );
+        }
+
+        const DelaunayTriangulation::TriangleCont & triangles = dt->triangulation().triangles();
+        for ( DelaunayTriangulation::TriangleCont::const_iterator t = triangles.begin();
+              t != triangles.end();
+              ++t )
+        {
+            for ( int i = 0; i < 3; ++i )
+            {
+                vertices.push_back( t->second->vertex( i )->id() );
+            }
+        }
+    }
+    else
+    {
+        // static formation. the positions do not depend on the focus point.
+        std::vector< Vector2D > positions;
+        formation.getPositions( Vector2D( 0.0, 0.0 ), positions );
+        if ( positions.size() != 11 )
+        {
+            return Ptr();
+        }
+
+        balls.push_back( Vector2D( 0.0, 0.0 ) );
+        players = positions;
+    }
+
+    if ( balls.empty() )
+    {
+        return Ptr();
+    }
+
+    const int sample_size = balls.size();
+    const int triangle_size = vertices.size() / 3;
+
+    for ( std::vector< boost::int32_t >::const_iterator v = vertices.begin();
+          v != vertices.end();
+          ++v )
+    {
+        if ( *v < 0 || sample_size <= *v )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                      << " ***ERROR*** illegal vertex id " << *v << std::endl;
+            return Ptr();
+        }
+    }
+
+    //
+    // point location buckets
+    //
+    const int grid_cols = ( triangle_size > 0 ? GRID_DIVS : 0 );
+    const int grid_rows = ( triangle_size > 0 ? GRID_DIVS : 0 );
+
+    double min_x = std::numeric_limits< double >::max();
+    double min_y = std::numeric_limits< double >::max();
+    double max_x = -std::numeric_limits< double >::max();
+    double max_y = -std::numeric_limits< double >::max();
+    for ( std::vector< Vector2D >::const_iterator b = balls.begin(); b != balls.end(); ++b )
+    {
+        min_x = std::min( min_x, b->x );
+        min_y = std::min( min_y, b->y );
+        max_x = std::max( max_x, b->x );
+        max_y = std::max( max_y, b->y );
+    }
+
+    const double cell_width = std::max( 1.0e-3, ( max_x - min_x ) / GRID_DIVS );
+    const double cell_height = std::max( 1.0e-3, ( max_y - min_y ) / GRID_DIVS );
+
+    std::vector< std::vector< boost::int32_t > > cells( grid_cols * grid_rows );
+    for ( int t = 0; t < triangle_size; ++t )
+    {
+        double tmin_x = std::numeric_limits< double >::max();
+        double tmin_y = std::numeric_limits< double >::max();
+        double tmax_x = -std::numeric_limits< double >::max();
+        double tmax_y = -std::numeric_limits< double >::max();
+        for ( int i = 0; i < 3; ++i )
+        {
+            const Vector2D & p = balls[vertices[t * 3 + i]];
+            tmin_x = std::min( tmin_x, p.x );
+            tmin_y = std::min( tmin_y, p.y );
+            tmax_x = std::max( tmax_x, p.x );
+            tmax_y = std::max( tmax_y, p.y );
+        }
+
+        const int cx0 = std::max( 0, static_cast< int >( ( tmin_x - min_x ) / cell_width ) );
+        const int cy0 = std::max( 0, static_cast< int >( ( tmin_y - min_y ) / cell_height ) );
+        const int cx1 = std::min( grid_cols - 1, static_cast< int >( ( tmax_x - min_x ) / cell_width ) );
+        const int cy1 = std::min( grid_rows - 1, static_cast< int >( ( tmax_y - min_y ) / cell_height ) );
+
+        for ( int cy = cy0; cy <= cy1; ++cy )
+        {
+            for ( int cx = cx0; cx <= cx1; ++cx )
+            {
+                cells[cy * grid_cols + cx].push_back( t );
+            }
+        }
+    }
+
+    std::size_t cell_triangle_size = 0;
+    for ( std::size_t c = 0; c < cells.size(); ++c )
+    {
+        cell_triangle_size += cells[c].size();
+    }
+
+    //
+    // layout
+    //
+    const boost::uint64_t ball_offset = align8( sizeof( Header ) );
+    const boost::uint64_t player_offset = align8( ball_offset + sizeof( double ) * 2 * sample_size );
+    const boost::uint64_t triangle_offset = align8( player_offset + sizeof( double ) * 22 * sample_size );
+    const boost::uint64_t cell_begin_offset = align8( triangle_offset + sizeof( Triangle ) * triangle_size );
+    const boost::uint64_t cell_triangle_offset = align8( cell_begin_offset
+                                                         + sizeof( boost::int32_t ) * ( cells.size() + 1 ) );
+    const boost::uint64_t data_size = align8( cell_triangle_offset
+                                              + sizeof( boost::int32_t ) * cell_triangle_size );
+
+    Ptr ptr( new CompiledFormation() );
+    std::vector< char > & buf = ptr->M_buffer;
+    buf.assign( data_size, 0 );
+
+    //
+    // header
+    //
+    Header header;
+    std::memset( &header, 0, sizeof( Header ) );
+    std::memcpy( header.magic_, MAGIC, sizeof( MAGIC ) );
+    header.byte_order_ = BYTE_ORDER_MARK;
+    header.version_ = FORMAT_VERSION;
+    header.source_checksum_ = source_checksum;
+    header.data_size_ = data_size;
+    header.sample_size_ = sample_size;
+    header.triangle_size_ = triangle_size;
+    header.grid_cols_ = grid_cols;
+    header.grid_rows_ = grid_rows;
+    header.grid_min_x_ = min_x;
+    header.grid_min_y_ = min_y;
+    header.grid_cell_width_ = cell_width;
+    header.grid_cell_height_ = cell_height;
+
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        header.position_type_[unum - 1] = ( formation.isSideType( unum ) ? -1
+                                            : formation.isSymmetryType( unum ) ? 1
+                                            : 0 );
+
+        const std::string role_name = formation.getRoleName( unum );
+        if ( role_name.length() >= static_cast< std::size_t >( ROLE_NAME_SIZE ) )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                      << " ***ERROR*** too long role name [" << role_name << "]"
+                      << std::endl;
+            return Ptr();
+        }
+        std::strncpy( header.role_name_[unum - 1], role_name.c_str(), ROLE_NAME_SIZE - 1 );
+    }
+
+    header.ball_offset_ = ball_offset;
+    header.player_offset_ = player_offset;
+    header.triangle_offset_ = triangle_offset;
+    header.cell_begin_offset_ = cell_begin_offset;
+    header.cell_triangle_offset_ = cell_triangle_offset;
+
+    std::memcpy( &buf[0], &header, sizeof( Header ) );
+
+    //
+    // samples
+    //
+    double * ball = reinterpret_cast< double * >( &buf[ball_offset] );
+    for ( int i = 0; i < sample_size; ++i )
+    {
+        ball[i * 2] = balls[i].x;
+        ball[i * 2 + 1] = balls[i].y;
+    }
+
+    double * player = reinterpret_cast< double * >( &buf[player_offset] );
+    for ( std::size_t i = 0; i < players.size(); ++i )
+    {
+        player[i * 2] = players[i].x;
+        player[i * 2 + 1] = players[i].y;
+    }
+
+    //
+    // triangles
+    //
+    Triangle * tri = reinterpret_cast< Triangle * >( &buf[triangle_offset] );
+    for ( int t = 0; t < triangle_size; ++t )
+    {
+        const Vector2D & p0 = balls[vertices[t * 3]];
+        const Vector2D & p1 = balls[vertices[t * 3 + 1]];
+        const Vector2D & p2 = balls[vertices[t * 3 + 2]];
+
+        const double a = p1.x - p0.x;
+        const double b = p2.x - p0.x;
+        const double c = p1.y - p0.y;
+        const double d = p2.y - p0.y;
+        const double det = a * d - b * c;
+
+        tri[t].vertex_[0] = vertices[t * 3];
+        tri[t].vertex_[1] = vertices[t * 3 + 1];
+        tri[t].vertex_[2] = vertices[t * 3 + 2];
+        tri[t].origin_x_ = p0.x;
+        tri[t].origin_y_ = p0.y;
+
+        if ( std::fabs( det ) < 1.0e-12 )
+        {
+            tri[t].valid_ = 0;
+            continue;
+        }
+
+        tri[t].valid_ = 1;
+        tri[t].inverse_[0] = d / det;
+        tri[t].inverse_[1] = -b / det;
+        tri[t].inverse_[2] = -c / det;
+        tri[t].inverse_[3] = a / det;
+    }
+
+    //
+    // buckets
+    //
+    boost::int32_t * cell_begin = reinterpret_cast< boost::int32_t * >( &buf[cell_begin_offset] );
+    boost::int32_t * cell_triangles = reinterpret_cast< boost::int32_t * >( &buf[cell_triangle_offset] );
+    boost::int32_t n = 0;
+    for ( std::size_t c = 0; c < cells.size(); ++c )
+    {
+        cell_begin[c] = n;
+        for ( std::size_t i = 0; i < cells[c].size(); ++i )
+        {
+            cell_triangles[n++] = cells[c][i];
+        }
+    }
+    cell_begin[cells.size()] = n;
+
+    if ( ! ptr->attach( &buf[0], buf.size() ) )
+    {
+        return Ptr();
+    }
+
+    return ptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CompiledFormation::Ptr
+CompiledFormation::load( const std::string & filepath,
+                         const boost::uint64_t source_checksum )
+{
+    const int fd = ::open( filepath.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+        return Ptr();
+    }
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) != 0
+         || st.st_size < static_cast< off_t >( sizeof( Header ) ) )
+    {
+        ::close( fd );
+        return Ptr();
+    }
+
+    const std::size_t size = static_cast< std::size_t >( st.st_size );
+    void * addr = ::mmap( 0, size, PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+
+    if ( addr == MAP_FAILED )
+    {
+        return Ptr();
+    }
+
+    Ptr ptr( new CompiledFormation() );
+    ptr->M_map_addr = addr;
+    ptr->M_map_size = size;
+
+    if ( ! ptr->attach( static_cast< const char * >( addr ), size ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " broken formation cache [" << filepath << "]"
+                  << std::endl;
+        return Ptr();
+    }
+
+    if ( ptr->sourceChecksum() != source_checksum )
+    {
+        std::cerr << "formation cache [" << filepath << "] is out of date."
+                  << std::endl;
+        return Ptr();
+    }
+
+    return ptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CompiledFormation::Ptr
+CompiledFormation::attach_memory( const char * data,
+                                  const std::size_t size,
+                                  const boost::uint64_t source_checksum )
+{
+    Ptr ptr( new CompiledFormation() );
+
+    if ( ! ptr->attach( data, size )
+         || ptr->sourceChecksum() != source_checksum )
+    {
+        return Ptr();
+    }
+
+    return ptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CompiledFormation::save( const std::string & filepath ) const
+{
+    // write to the temporary file and rename it, so that the other
+    // processes never map a partially written file.
+    char pid[32];
+    std::snprintf( pid, 32, ".%d", static_cast< int >( ::getpid() ) );
+    const std::string tmp_path = filepath + pid;
+
+    {
+        std::ofstream fout( tmp_path.c_str(), std::ios_base::binary );
+        if ( ! fout.is_open() )
+        {
+            return false;
+        }
+
+        fout.write( M_data, dataSize() );
+        fout.flush();
+        if ( ! fout.good() )
+        {
+            fout.close();
+            std::remove( tmp_path.c_str() );
+            return false;
+        }
+    }
+
+    if ( std::rename( tmp_path.c_str(), filepath.c_str() ) != 0 )
+    {
+        std::remove( tmp_path.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CompiledFormation::checksum_file( const std::string & filepath,
+                                  boost::uint64_t * result )
+{
+    std::ifstream fin( filepath.c_str(), std::ios_base::binary );
+    if ( ! fin.is_open() )
+    {
+        return false;
+    }
+
+    boost::uint64_t hash = 14695981039346656037ULL;
+
+    char buf[8192];
+    while ( fin.good() )
+    {
+        fin.read( buf, sizeof( buf ) );
+        const std::streamsize n = fin.gcount();
+        for ( std::streamsize i = 0; i < n; ++i )
+        {
+            hash ^= static_cast< unsigned char >( buf[i] );
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    if ( fin.bad() )
+    {
+        return false;
+    }
+
+    *result = hash;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CompiledFormation::attach( const char * data,
+                           const std::size_t size )
+{
+    if ( size < sizeof( Header ) )
+    {
+        return false;
+    }
+
+    const Header * h = reinterpret_cast< const Header * >( data );
+
+    if ( std::memcmp( h->magic_, MAGIC, sizeof( MAGIC ) ) != 0
+         || h->byte_order_ != BYTE_ORDER_MARK
+         || h->version_ != FORMAT_VERSION
+         || h->data_size_ != size
+         || h->sample_size_ <= 0
+         || h->triangle_size_ < 0
+         || h->grid_cols_ < 0
+         || h->grid_rows_ < 0
+         || ( h->triangle_size_ > 0
+              && ( h->grid_cols_ == 0 || h->grid_rows_ == 0 ) ) )
+    {
+        return false;
+    }
+
+    const boost::uint64_t cell_size = static_cast< boost::uint64_t >( h->grid_cols_ ) * h->grid_rows_;
+
+    if ( ! in_range( h->ball_offset_, sizeof( double ) * 2 * h->sample_size_, size )
+         || ! in_range( h->player_offset_, sizeof( double ) * 22 * h->sample_size_, size )
+         || ! in_range( h->triangle_offset_, sizeof( Triangle ) * h->triangle_size_, size )
+         || ! in_range( h->cell_begin_offset_, sizeof( boost::int32_t ) * ( cell_size + 1 ), size ) )
+    {
+        return false;
+    }
+
+    const boost::int32_t * cell_begin = reinterpret_cast< const boost::int32_t * >( data + h->cell_begin_offset_ );
+    for ( boost::uint64_t c = 0; c < cell_size; ++c )
+    {
+        if ( cell_begin[c] < 0
+             || cell_begin[c] > cell_begin[c + 1] )
+        {
+            return false;
+        }
+    }
+
+    if ( cell_begin[0] != 0
+         || ! in_range( h->cell_triangle_offset_,
+                        sizeof( boost::int32_t ) * cell_begin[cell_size],
+                        size ) )
+    {
+        return false;
+    }
+
+    const Triangle * triangles = reinterpret_cast< const Triangle * >( data + h->triangle_offset_ );
+    for ( int t = 0; t < h->triangle_size_; ++t )
+    {
+        for ( int i = 0; i < 3; ++i )
+        {
+            if ( triangles[t].vertex_[i] < 0
+                 || h->sample_size_ <= triangles[t].vertex_[i] )
+            {
+                return false;
+            }
+        }
+    }
+
+    const boost::int32_t * cell_triangles = reinterpret_cast< const boost::int32_t * >( data + h->cell_triangle_offset_ );
+    for ( boost::int32_t i = 0; i < cell_begin[cell_size]; ++i )
+    {
+        if ( cell_triangles[i] < 0
+             || h->triangle_size_ <= cell_triangles[i] )
+        {
+            return false;
+        }
+    }
+
+    for ( int unum = 0; unum < 11; ++unum )
+    {
+        if ( std::memchr( h->role_name_[unum], '\0', ROLE_NAME_SIZE ) == 0 )
+        {
+            return false;
+        }
+    }
+
+    M_data = data;
+    M_header = h;
+    M_ball = reinterpret_cast< const double * >( data + h->ball_offset_ );
+    M_player = reinterpret_cast< const double * >( data + h->player_offset_ );
+    M_triangles = triangles;
+    M_cell_begin = cell_begin;
+    M_cell_triangles = cell_triangles;
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::string
+CompiledFormation::getRoleName( const int unum ) const
+{
+    if ( unum < 1 || 11 < unum )
+    {
+        return std::string();
+    }
+
+    return std::string( M_header->role_name_[unum - 1] );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+CompiledFormation::findTriangleContains( const Vector2D & point,
+                                         double * weight ) const
+{
+    const Header & h = *M_header;
+
+    if ( h.triangle_size_ == 0 )
+    {
+        return -1;
+    }
+
+    const double fx = ( point.x - h.grid_min_x_ ) / h.grid_cell_width_;
+    const double fy = ( point.y - h.grid_min_y_ ) / h.grid_cell_height_;
+
+    // all triangles are in the bounding box of the samples
+    if ( fx < -WEIGHT_EPS || h.grid_cols_ + WEIGHT_EPS < fx
+         || fy < -WEIGHT_EPS || h.grid_rows_ + WEIGHT_EPS < fy )
+    {
+        return -1;
+    }
+
+    const int cx = std::min( std::max( static_cast< int >( fx ), 0 ), h.grid_cols_ - 1 );
+    const int cy = std::min( std::max( static_cast< int >( fy ), 0 ), h.grid_rows_ - 1 );
+    const int cell = cy * h.grid_cols_ + cx;
+
+    for ( boost::int32_t i = M_cell_begin[cell]; i < M_cell_begin[cell + 1]; ++i )
+    {
+        const Triangle & t = M_triangles[M_cell_triangles[i]];
+        if ( ! t.valid_ ) continue;
+
+        const double dx = point.x - t.origin_x_;
+        const double dy = point.y - t.origin_y_;
+        const double w1 = t.inverse_[0] * dx + t.inverse_[1] * dy;
+        const double w2 = t.inverse_[2] * dx + t.inverse_[3] * dy;
+        const double w0 = 1.0 - w1 - w2;
+
+        if ( w0 >= -WEIGHT_EPS
+             && w1 >= -WEIGHT_EPS
+             && w2 >= -WEIGHT_EPS )
+        {
+            weight[0] = w0;
+            weight[1] = w1;
+            weight[2] = w2;
+            return M_cell_triangles[i];
+        }
+    }
+
+    return -1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+CompiledFormation::findNearestSample( const Vector2D & point ) const
+{
+    int result = 0;
+    double min_d2 = std::numeric_limits< double >::max();
+
+    for ( int i = 0; i < M_header->sample_size_; ++i )
+    {
+        const double dx = M_ball[i * 2] - point.x;
+        const double dy = M_ball[i * 2 + 1] - point.y;
+        const double d2 = dx * dx + dy * dy;
+        if ( d2 < min_d2 )
+        {
+            min_d2 = d2;
+            result = i;
+        }
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CompiledFormation::getWeights( const Vector2D & focus_point,
+                               int * index,
+                               double * weight ) const
+{
+    const int t = findTriangleContains( focus_point, weight );
+    if ( t >= 0 )
+    {
+        index[0] = M_triangles[t].vertex_[0];
+        index[1] = M_triangles[t].vertex_[1];
+        index[2] = M_triangles[t].vertex_[2];
+        return;
+    }
+
+    index[0] = index[1] = index[2] = findNearestSample( focus_point );
+    weight[0] = 1.0;
+    weight[1] = weight[2] = 0.0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2D
+CompiledFormation::getPosition( const int unum,
+                                const Vector2D & focus_point ) const
+{
+    if ( unum < 1 || 11 < unum )
+    {
+        return Vector2D::INVALIDATED;
+    }
+
+    int index[3];
+    double weight[3];
+    getWeights( focus_point, index, weight );
+
+    Vector2D result( 0.0, 0.0 );
+    for ( int i = 0; i < 3; ++i )
+    {
+        const double * p = M_player + ( index[i] * 11 + unum - 1 ) * 2;
+        result.x += weight[i] * p[0];
+        result.y += weight[i] * p[1];
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CompiledFormation::getPositions( const Vector2D & focus_point,
+                                 std::vector< Vector2D > & positions ) const
+{
+    if ( M_baked )
+    {
+        getBakedPositions( focus_point, positions );
+    }
+    else
+    {
+        getExactPositions( focus_point, positions );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CompiledFormation::getExactPositions( const Vector2D & focus_point,
+                                      std::vector< Vector2D > & positions ) const
+{
+    int index[3];
+    double weight[3];
+    getWeights( focus_point, index, weight );
+
+    const double * p0 = M_player + index[0] * 22;
+    const double * p1 = M_player + index[1] * 22;
+    const double * p2 = M_player + index[2] * 22;
+
+    positions.clear();
+    positions.reserve( 11 );
+    for ( int i = 0; i < 22; i += 2 )
+    {
+        positions.push_back( Vector2D( weight[0] * p0[i] + weight[1] * p1[i] + weight[2] * p2[i],
+                                       weight[0] * p0[i + 1] + weight[1] * p1[i + 1] + weight[2] * p2[i + 1] ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CompiledFormation::bake( const double & step )
+{
+    std::vector< float >().swap( M_baked_buffer );
+    M_baked = static_cast< const float * >( 0 );
+    M_baked_cols = M_baked_rows = 0;
+    M_baked_step = 0.0;
+
+    // a static formation does not depend on the focus point
+    if ( step <= 0.0
+         || M_header->triangle_size_ == 0 )
+    {
+        return false;
+    }
+
+    const int cols = static_cast< int >( std::ceil( BAKE_HALF_LENGTH * 2.0 / step ) ) + 1;
+    const int rows = static_cast< int >( std::ceil( BAKE_HALF_WIDTH * 2.0 / step ) ) + 1;
+
+    std::vector< float > baked;
+    baked.reserve( cols * rows * 22 );
+
+    std::vector< Vector2D > positions;
+    for ( int r = 0; r < rows; ++r )
+    {
+        for ( int c = 0; c < cols; ++c )
+        {
+            getExactPositions( Vector2D( -BAKE_HALF_LENGTH + c * step,
+                                         -BAKE_HALF_WIDTH + r * step ),
+                               positions );
+            for ( int i = 0; i < 11; ++i )
+            {
+                baked.push_back( static_cast< float >( positions[i].x ) );
+                baked.push_back( static_cast< float >( positions[i].y ) );
+            }
+        }
+    }
+
+    M_baked_buffer.swap( baked );
+    M_baked = &M_baked_buffer[0];
+    M_baked_cols = cols;
+    M_baked_rows = rows;
+    M_baked_min_x = -BAKE_HALF_LENGTH;
+    M_baked_min_y = -BAKE_HALF_WIDTH;
+    M_baked_step = step;
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CompiledFormation::attachBaked( const float * data,
+                                const std::size_t count,
+                                const double & step )
+{
+    if ( step <= 0.0
+         || M_header->triangle_size_ == 0 )
+    {
+        return false;
+    }
+
+    const int cols = static_cast< int >( std::ceil( BAKE_HALF_LENGTH * 2.0 / step ) ) + 1;
+    const int rows = static_cast< int >( std::ceil( BAKE_HALF_WIDTH * 2.0 / step ) ) + 1;
+
+    if ( count != static_cast< std::size_t >( cols * rows * 22 ) )
+    {
+        return false;
+    }
+
+    std::vector< float >().swap( M_baked_buffer );
+    M_baked = data;
+    M_baked_cols = cols;
+    M_baked_rows = rows;
+    M_baked_min_x = -BAKE_HALF_LENGTH;
+    M_baked_min_y = -BAKE_HALF_WIDTH;
+    M_baked_step = step;
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CompiledFormation::getBakedPositions( const Vector2D & focus_point,
+                                      std::vector< Vector2D > & positions ) const
+{
+    double fx = ( focus_point.x - M_baked_min_x ) / M_baked_step;
+    double fy = ( focus_point.y - M_baked_min_y ) / M_baked_step;
+    fx = std::min( std::max( fx, 0.0 ), static_cast< double >( M_baked_cols - 1 ) );
+    fy = std::min( std::max( fy, 0.0 ), static_cast< double >( M_baked_rows - 1 ) );
+
+    const int c = std::min( static_cast< int >( fx ), M_baked_cols - 2 );
+    const int r = std::min( static_cast< int >( fy ), M_baked_rows - 2 );
+    const double tx = fx - c;
+    const double ty = fy - r;
+
+    const double w00 = ( 1.0 - tx ) * ( 1.0 - ty );
+    const double w10 = tx * ( 1.0 - ty );
+    const double w01 = ( 1.0 - tx ) * ty;
+    const double w11 = tx * ty;
+
+    const float * p00 = &M_baked[( r * M_baked_cols + c ) * 22];
+    const float * p10 = p00 + 22;
+    const float * p01 = p00 + M_baked_cols * 22;
+    const float * p11 = p01 + 22;
+
+    positions.clear();
+    positions.reserve( 11 );
+    for ( int i = 0; i < 22; i += 2 )
+    {
+        positions.push_back( Vector2D( w00 * p00[i] + w10 * p10[i] + w01 * p01[i] + w11 * p11[i],
+                                       w00 * p00[i + 1] + w10 * p10[i + 1] + w01 * p01[i + 1] + w11 * p11[i + 1] ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+CompiledFormation::checkBakeError( double * mean_error ) const
+{
+    double max_error = 0.0;
+    double sum_error = 0.0;
+    long count = 0;
+
+    if ( M_baked )
+    {
+        std::vector< Vector2D > exact;
+        std::vector< Vector2D > baked;
+
+        for ( int r = 0; r < M_baked_rows - 1; ++r )
+        {
+            for ( int c = 0; c < M_baked_cols - 1; ++c )
+            {
+                for ( int sy = 1; sy <= 3; ++sy )
+                {
+                    for ( int sx = 1; sx <= 3; ++sx )
+                    {
+                        const Vector2D focus( M_baked_min_x + ( c + sx * 0.25 ) * M_baked_step,
+                                              M_baked_min_y + ( r + sy * 0.25 ) * M_baked_step );
+                        getExactPositions( focus, exact );
+                        getBakedPositions( focus, baked );
+
+                        for ( int i = 0; i < 11; ++i )
+                        {
+                            const double err = exact[i].dist( baked[i] );
+                            max_error = std::max( max_error, err );
+                            sum_error += err;
+                            ++count;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if ( mean_error )
+    {
+        *mean_error = ( count > 0 ? sum_error / count : 0.0 );
+    }
+
+    return max_error;
+}
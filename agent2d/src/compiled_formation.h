@@ -0,0 +1,358 @@
+// -*-c++-*-
+
+/*!
+  \file compiled_formation.h
+  \brief precompiled binary formation data Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef COMPILED_FORMATION_H
+#define COMPILED_FORMATION_H
+
+#include <rcsc/geom/vector_2d.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <string>
+
+namespace rcsc {
+class Formation;
+}
+
+/*!
+  \class CompiledFormation
+  \brief read-only formation data in a flat binary layout.
+
+  The sample table of a formation, its triangulation and a bucket grid
+  for the point location are stored in one contiguous block. The block
+  contains no pointers, only offsets from its head, so it can be written
+  to a cache file as is and mapped back with mmap() without any parsing.
+
+  The block is created from a formation read by librcsc. The home
+  positions are the same as rcsc::FormationDT::getPositions(): a linear
+  interpolation in the triangle that contains the focus point, or the
+  nearest sample if no triangle contains it. A static formation is
+  stored as one sample without triangles.
+
+  The cache file keeps the checksum of the source text file. A cache
+  whose checksum does not match the current text file is rejected, and
+  the caller falls back to the text file.
+
+  Optionally, the home positions can be baked into a regular grid of the
+  focus point by bake(). Then getPositions() is a bilinear interpolation
+  of the four surrounding grid points instead of the point location.
+  checkBakeError() reports the difference from the exact interpolation.
+
+  Both the block and the baked grid can also refer to the memory owned by
+  someone else (e.g. SharedTableSegment) by attach_memory() and
+  attachBaked(). The memory has to outlive this object.
+ */
+class CompiledFormation {
+public:
+
+    typedef boost::shared_ptr< CompiledFormation > Ptr;
+    typedef boost::shared_ptr< const CompiledFormation > ConstPtr;
+
+    //! file name suffix of the cache file
+    static const std::string CACHE_SUFFIX;
+
+    //! max length of the role name (including the terminating null)
+    static const int ROLE_NAME_SIZE = 32;
+
+    /*!
+      \brief file header. all offsets are from the head of the block.
+     */
+    struct Header {
+        char magic_[8];
+        boost::uint32_t byte_order_; //!< 0x01020304 in the host byte order
+        boost::uint32_t version_;
+        boost::uint64_t source_checksum_; //!< checksum of the source text file
+        boost::uint64_t data_size_; //!< total block size including this header
+        boost::int32_t sample_size_;
+        boost::int32_t triangle_size_;
+        boost::int32_t grid_cols_;
+        boost::int32_t grid_rows_;
+        double grid_min_x_;
+        double grid_min_y_;
+        double grid_cell_width_;
+        double grid_cell_height_;
+        boost::int32_t position_type_[11]; //!< -1: side, 0: center, 1: symmetry
+        boost::int32_t padding_;
+        char role_name_[11][ROLE_NAME_SIZE];
+        boost::uint64_t ball_offset_; //!< double[sample_size][2]
+        boost::uint64_t player_offset_; //!< double[sample_size][11][2]
+        boost::uint64_t triangle_offset_; //!< Triangle[triangle_size]
+        boost::uint64_t cell_begin_offset_; //!< int32[cols * rows + 1]
+        boost::uint64_t cell_triangle_offset_; //!< int32[cell_begin[cols * rows]]
+    };
+
+    /*!
+      \brief triangle with the precomputed barycentric transform.
+     */
+    struct Triangle {
+        boost::int32_t vertex_[3]; //!< sample indices
+        boost::int32_t valid_; //!< 0 if degenerated
+        double origin_x_;
+        double origin_y_;
+        double inverse_[4]; //!< inverse of [ v1-v0, v2-v0 ] (row major)
+    };
+
+private:
+
+    std::vector< char > M_buffer; //!< owned block (compiled in memory)
+    void * M_map_addr; //!< mapped block (loaded from the cache file)
+    std::size_t M_map_size;
+
+    const char * M_data; //!< head of the block (owned or external)
+    const Header * M_header;
+    const double * M_ball;
+    const double * M_player;
+    const Triangle * M_triangles;
+    const boost::int32_t * M_cell_begin;
+    const boost::int32_t * M_cell_triangles;
+
+    //
+    // baked home positions (not stored in the cache file)
+    //
+    std::vector< float > M_baked_buffer; //!< owned grid
+    const float * M_baked; //!< [row][col][11][2], M_baked_buffer or external memory
+    int M_baked_cols;
+    int M_baked_rows;
+    double M_baked_min_x;
+    double M_baked_min_y;
+    double M_baked_step;
+
+    CompiledFormation();
+
+    // not used
+    CompiledFormation( const CompiledFormation & );
+    CompiledFormation & operator=( const CompiledFormation & );
+
+public:
+
+    ~CompiledFormation();
+
+    /*!
+      \brief create the block from the formation read by librcsc.
+      \param formation source formation
+      \param source_checksum checksum of the source text file
+      \return compiled formation or NULL
+     */
+    static
+    Ptr compile( const rcsc::Formation & formation,
+                 const boost::uint64_t source_checksum );
+
+    /*!
+      \brief map the cache file.
+      \param filepath cache file path
+      \param source_checksum expected checksum of the source text file
+      \return compiled formation or NULL if the file is missing, broken or stale.
+     */
+    static
+    Ptr load( const std::string & filepath,
+              const boost::uint64_t source_checksum );
+
+    /*!
+      \brief refer to the block in the memory owned by the caller.
+      \param data head of the block. it has to outlive the returned object.
+      \param size block size
+      \param source_checksum expected checksum of the source text file
+      \return compiled formation or NULL if the block is broken or stale.
+     */
+    static
+    Ptr attach_memory( const char * data,
+                       const std::size_t size,
+                       const boost::uint64_t source_checksum );
+
+    /*!
+      \brief write the block to the cache file.
+      \param filepath cache file path
+      \return result status
+     */
+    bool save( const std::string & filepath ) const;
+
+    /*!
+      \brief compute the checksum of the text file (64 bit FNV-1a).
+      \param filepath text file path
+      \param result variable to store the checksum
+      \return false if the file could not be read
+     */
+    static
+    bool checksum_file( const std::string & filepath,
+                        boost::uint64_t * result );
+
+    //
+    // accessors
+    //
+
+    const char * data() const
+      {
+          return M_data;
+      }
+
+    std::size_t dataSize() const
+      {
+          return static_cast< std::size_t >( M_header->data_size_ );
+      }
+
+    boost::uint64_t sourceChecksum() const
+      {
+          return M_header->source_checksum_;
+      }
+
+    int sampleSize() const
+      {
+          return M_header->sample_size_;
+      }
+
+    int triangleSize() const
+      {
+          return M_header->triangle_size_;
+      }
+
+    std::string getRoleName( const int unum ) const;
+
+    bool isSideType( const int unum ) const
+      {
+          return ( 1 <= unum && unum <= 11
+                   && M_header->position_type_[unum - 1] < 0 );
+      }
+
+    bool isSymmetryType( const int unum ) const
+      {
+          return ( 1 <= unum && unum <= 11
+                   && M_header->position_type_[unum - 1] > 0 );
+      }
+
+    bool isCenterType( const int unum ) const
+      {
+          return ( 1 <= unum && unum <= 11
+                   && M_header->position_type_[unum - 1] == 0 );
+      }
+
+    /*!
+      \brief bake the home positions into a regular grid.
+      \param step grid interval of the focus point. 0 removes the grid.
+      \return false if the grid is not created
+     */
+    bool bake( const double & step );
+
+    /*!
+      \brief refer to the grid created by bake() in the memory owned by the caller.
+      \param data head of the grid. it has to outlive this object.
+      \param count the number of the values
+      \param step grid interval used to create the grid
+      \return false if the size does not match the step
+     */
+    bool attachBaked( const float * data,
+                      const std::size_t count,
+                      const double & step );
+
+    bool isBaked() const
+      {
+          return M_baked != static_cast< const float * >( 0 );
+      }
+
+    double bakedStep() const
+      {
+          return M_baked_step;
+      }
+
+    const float * bakedData() const
+      {
+          return M_baked;
+      }
+
+    std::size_t bakedDataCount() const
+      {
+          return static_cast< std::size_t >( M_baked_cols * M_baked_rows * 22 );
+      }
+
+    /*!
+      \brief compare the baked grid with the exact interpolation at the
+      3x3 points inside every grid cell.
+      \param mean_error variable to store the mean error (may be NULL)
+      \return the max position error
+     */
+    double checkBakeError( double * mean_error ) const;
+
+    /*!
+      \brief get the home position of the player by the exact interpolation.
+      \param unum uniform number
+      \param focus_point ball position
+      \return home position
+     */
+    rcsc::Vector2D getPosition( const int unum,
+                                const rcsc::Vector2D & focus_point ) const;
+
+    /*!
+      \brief get the home positions of all players. the baked grid is used if exists.
+      \param focus_point ball position
+      \param positions container to store the result (cleared)
+     */
+    void getPositions( const rcsc::Vector2D & focus_point,
+                       std::vector< rcsc::Vector2D > & positions ) const;
+
+    /*!
+      \brief get the home positions by the exact interpolation in the triangle.
+      \param focus_point ball position
+      \param positions container to store the result (cleared)
+     */
+    void getExactPositions( const rcsc::Vector2D & focus_point,
+                            std::vector< rcsc::Vector2D > & positions ) const;
+
+private:
+
+    void getBakedPositions( const rcsc::Vector2D & focus_point,
+                            std::vector< rcsc::Vector2D > & positions ) const;
+
+    /*!
+      \brief set the section pointers and validate the block.
+      \param data head of the block
+      \param size block size
+      \return false if the block is broken
+     */
+    bool attach( const char * data,
+                 const std::size_t size );
+
+    /*!
+      \brief get the interpolation weights of the focus point.
+      \param focus_point ball position
+      \param index array to store 3 sample indices
+      \param weight array to store 3 weights
+     */
+    void getWeights( const rcsc::Vector2D & focus_point,
+                     int * index,
+                     double * weight ) const;
+
+    int findTriangleContains( const rcsc::Vector2D & point,
+                              double * weight ) const;
+    int findNearestSample( const rcsc::Vector2D & point ) const;
+};
+
+#endif
@@ -0,0 +1,225 @@
+// -*-c++-*-
+
+/*!
+  \file formation_compiler.cpp
+  \brief formation cache compiler Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "compiled_formation.h"
+
+#include <rcsc/formation/formation_static.h>
+#include <rcsc/formation/formation_dt.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cstdlib> // exit, atof
+
+/*
+  usage: formation_compiler [-f] [-g <step>] <formation.conf>...
+
+  creates <formation.conf>.bin for each formation file. the cache file
+  is skipped if it is up to date, unless -f is given.
+
+  -g <step> bakes each formation into the grid of the given interval
+  and reports the error against the exact interpolation. use it to
+  choose the formation_grid_step option of the player.
+*/
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+rcsc::Formation::Ptr
+read_formation( const std::string & filepath )
+{
+    rcsc::Formation::Ptr f;
+
+    std::ifstream fin( filepath.c_str() );
+    if ( ! fin.is_open() )
+    {
+        std::cerr << filepath << ": failed to open." << std::endl;
+        return f;
+    }
+
+    std::string temp, type;
+    fin >> temp >> type; // read training method type name
+    fin.seekg( 0 );
+
+    if ( type == rcsc::FormationStatic::name() )
+    {
+        f = rcsc::FormationStatic::create();
+    }
+    else if ( type == rcsc::FormationDT::name() )
+    {
+        f = rcsc::FormationDT::create();
+    }
+    else
+    {
+        std::cerr << filepath << ": unsupported formation type ["
+                  << type << "]" << std::endl;
+        return f;
+    }
+
+    if ( ! f->read( fin ) )
+    {
+        std::cerr << filepath << ": failed to read." << std::endl;
+        f.reset();
+    }
+
+    return f;
+}
+
+/*-------------------------------------------------------------------*/
+void
+report_bake_error( const std::string & filepath,
+                   CompiledFormation & compiled,
+                   const double & step )
+{
+    if ( ! compiled.bake( step ) )
+    {
+        std::cout << filepath << ": grid " << step
+                  << ": not baked (static formation)" << std::endl;
+        return;
+    }
+
+    double mean_error = 0.0;
+    const double max_error = compiled.checkBakeError( &mean_error );
+
+    std::cout << filepath << ": grid " << step
+              << ": max error " << max_error
+              << ", mean error " << mean_error << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+bool
+compile( const std::string & filepath,
+         const bool force,
+         const double & grid_step )
+{
+    boost::uint64_t checksum = 0;
+    if ( ! CompiledFormation::checksum_file( filepath, &checksum ) )
+    {
+        std::cerr << filepath << ": failed to open." << std::endl;
+        return false;
+    }
+
+    const std::string cache_path = filepath + CompiledFormation::CACHE_SUFFIX;
+
+    if ( ! force )
+    {
+        CompiledFormation::Ptr cache = CompiledFormation::load( cache_path, checksum );
+        if ( cache )
+        {
+            std::cout << cache_path << ": up to date." << std::endl;
+            if ( grid_step > 0.0 )
+            {
+                report_bake_error( filepath, *cache, grid_step );
+            }
+            return true;
+        }
+    }
+
+    rcsc::Formation::Ptr f = read_formation( filepath );
+    if ( ! f )
+    {
+        return false;
+    }
+
+    CompiledFormation::Ptr compiled = CompiledFormation::compile( *f, checksum );
+    if ( ! compiled )
+    {
+        std::cerr << filepath << ": failed to compile." << std::endl;
+        return false;
+    }
+
+    if ( ! compiled->save( cache_path ) )
+    {
+        std::cerr << cache_path << ": failed to write." << std::endl;
+        return false;
+    }
+
+    std::cout << cache_path << ": "
+              << compiled->sampleSize() << " samples, "
+              << compiled->triangleSize() << " triangles, "
+              << compiled->dataSize() << " bytes" << std::endl;
+
+    if ( grid_step > 0.0 )
+    {
+        report_bake_error( filepath, *compiled, grid_step );
+    }
+
+    return true;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+int
+main( int argc, char ** argv )
+{
+    bool force = false;
+    double grid_step = 0.0;
+    int count = 0;
+    bool result = true;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        if ( arg == "-f" )
+        {
+            force = true;
+            continue;
+        }
+
+        if ( arg == "-g" )
+        {
+            if ( i + 1 >= argc
+                 || ( grid_step = std::atof( argv[i + 1] ) ) <= 0.0 )
+            {
+                std::cerr << "-g requires a positive grid step." << std::endl;
+                return EXIT_FAILURE;
+            }
+            ++i;
+            continue;
+        }
+
+        result &= compile( arg, force, grid_step );
+        ++count;
+    }
+
+    if ( count == 0 )
+    {
+        std::cerr << "usage: " << argv[0] << " [-f] [-g <step>] <formation.conf>..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return ( result ? EXIT_SUCCESS : EXIT_FAILURE );
+}
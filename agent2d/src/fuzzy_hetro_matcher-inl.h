@@ -70,15 +70,15 @@ public:
 			                                                 double sideDefense,
 			                                                 double centerAttack,
 			                                                 double sideAttack,
-			                                                 double throughPass,
-			                                                 double discretization = 8) {
-		Instance().hetroWeights.fuzzify(aim,
-				                        centerDefense,
-				                        sideDefense,
-				                        centerAttack,
-				                        sideAttack,
-				                        throughPass,
-				                        std::numeric_limits<double>::max());
+			                                                 double throughPass) {
+		const double input[6] = { aim,
+								  centerDefense,
+								  sideDefense,
+								  centerAttack,
+								  sideAttack,
+								  throughPass };
+
+		Instance().hetroWeights.fuzzify(input, 6);
 
 		std::vector<std::vector<double> > result;
 
@@ -96,8 +96,7 @@ public:
 			{
 				result[i][j] = Instance().hetroWeights.defuzzifyCentroid(outputIndex,
 						                                                 kMinWeight,
-						                                                 kMaxWeight,
-						                                                 discretization);
+						                                                 kMaxWeight);
 				outputIndex += 1;
 			}
 		}
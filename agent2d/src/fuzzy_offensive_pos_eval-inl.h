@@ -6,6 +6,11 @@
 #endif
 
 #include "util/FuzzyController-inl.h"
+#include "util/FuzzyLookupTable-inl.h"
+#include "shared_table_segment.h"
+
+#include <string>
+#include <vector>
 
 const double kMinDist            =  0.0;
 const double kMaxDistBallPos     = 15.0;
@@ -25,14 +30,16 @@ const double kMaxEval = 20.0;
 
 const int kEvalOutputIndex = 1;
 
+const int kPosEvalSamples = 11;
+const double kPosEvalTolerance = 0.25;
+
 class FuzzyOffensivePosEval {
 public:
 	static double getOffensivePosEval(double distBallPos,
 			                          double distOppPos,
 			                          double distBallLineOpp,
 			                          double distCurrPos,
-			                          double distOppGoalPos,
-			                          double discretization = 8) {
+			                          double distOppGoalPos) {
 		fuzzy::trimNumeric(&distBallPos,
 				           &kMinDist,
 				           &kMaxDistBallPos);
@@ -49,25 +56,49 @@ public:
 				           &kMinDist,
 				           &kMaxDistOppGoalPos);
 
-		Instance().posEval.fuzzify(distBallPos,
-				                   distOppPos,
-				                   distBallLineOpp,
-				                   distCurrPos,
-				                   distOppGoalPos,
-				                   std::numeric_limits<double>::max() );
-
-		return Instance().posEval.defuzzifyCentroid(kEvalOutputIndex,
-				                                    kMinEval,
-				                                    kMaxEval,
-				                                    discretization);
+		const double input[5] = { distBallPos,
+								  distOppPos,
+								  distBallLineOpp,
+								  distCurrPos,
+								  distOppGoalPos };
+
+		if (Instance().posEvalTable.isValid()) {
+			return Instance().posEvalTable.lookup(input);
+		}
+
+		return Instance().evaluate(input);
+	}
+
+	/**
+	 * @brief
+	 * Creating the singleton compiles the lookup table, so this function
+	 *   should be called once at startup.
+	 * @return true if the lookup table passed the accuracy check
+	 */
+	static bool isLookupTableEnabled() {
+		return Instance().posEvalTable.isValid();
+	}
+
+	static double getLookupTableError() {
+		return Instance().posEvalTable.getMaxError();
 	}
 
 private:
 	FuzzyOffensivePosEval() {
 		this->initMembershipFunctions();
 		this->initRuleBase();
+		this->initLookupTable();
 	}
 
+	// the live controller used to compile and check the lookup table
+	struct LiveController {
+		FuzzyOffensivePosEval* controller;
+
+		double operator()(const double* input) const {
+			return controller->evaluate(input);
+		}
+	};
+
 	// prevent copy-construction
 	FuzzyOffensivePosEval(const FuzzyOffensivePosEval&);
 
@@ -221,7 +252,61 @@ private:
 						fuzzy::kRuleEnd());
 	}
 
+	void initLookupTable() {
+		posEvalTable.addAxis(kMinDist + 1, kMaxDistBallPos - 1, kPosEvalSamples);
+		posEvalTable.addAxis(kMinDist + 1, kMaxDistOppPos - 1, kPosEvalSamples);
+		posEvalTable.addAxis(kMinDist + 1, kMaxDistBallLineOpp - 1, kPosEvalSamples);
+		posEvalTable.addAxis(kMinDist + 1, kMaxDistCurrPos - 1, kPosEvalSamples);
+		posEvalTable.addAxis(kMinDist + 1, kMaxDistOppGoalPos - 1, kPosEvalSamples);
+
+		// the table checked by the owner of the shared segment is used as is.
+		//   the block holds the grid values followed by the max error.
+		SharedTableSegment& segment = SharedTableSegment::instance();
+		const std::string key = SharedTableSegment::make_key("fuzzy_offensive_pos_eval",
+		                                                     kPosEvalSamples);
+		std::size_t blockSize = 0;
+		const double* block = static_cast<const double*>(segment.find(key, &blockSize));
+		if (block != 0
+		    && blockSize >= sizeof(double)
+		    && posEvalTable.attach(block,
+		                           blockSize / sizeof(double) - 1,
+		                           block[blockSize / sizeof(double) - 1])) {
+			return;
+		}
+
+		LiveController live;
+		live.controller = this;
+
+		posEvalTable.compile(live);
+		posEvalTable.check(live, kPosEvalTolerance);
+
+		if (segment.isOwner()
+		    && posEvalTable.isValid()) {
+			std::vector<double> values(posEvalTable.data(),
+			                           posEvalTable.data() + posEvalTable.size());
+			values.push_back(posEvalTable.getMaxError());
+
+			const double* shared = static_cast<const double*>(segment.publish(key,
+			                                                                  &values[0],
+			                                                                  values.size() * sizeof(double)));
+			if (shared != 0) {
+				posEvalTable.attach(shared,
+				                    values.size() - 1,
+				                    values.back());
+			}
+		}
+	}
+
+	double evaluate(const double* input) {
+		posEval.fuzzify(input, 5);
+
+		return posEval.defuzzifyCentroid(kEvalOutputIndex,
+										 kMinEval,
+										 kMaxEval);
+	}
+
 	fuzzy::FuzzyController<double> posEval;
+	fuzzy::FuzzyLookupTable<double> posEvalTable;
 };
 
 #endif
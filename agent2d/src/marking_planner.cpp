@@ -0,0 +1,371 @@
+// -*-c++-*-
+
+/*!
+  \file marking_planner.cpp
+  \brief team consistent marking assignment Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "marking_planner.h"
+
+#include "strategy.h"
+#include "field_analyzer.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/common/logger.h>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// #define DEBUG_PRINT
+
+using namespace rcsc;
+
+namespace {
+
+//! cost of the forbidden pairs
+const double FORBIDDEN_COST = 1.0e6;
+//! cost reduction for the pair assigned in the previous cycle
+const double KEEP_BONUS = 0.5; // Magic Number
+//! max move of the previous target whose uniform number is unknown
+const double KEEP_POS_TOLERANCE = 1.5; // Magic Number
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief deterministic order of the opponents.
+  known uniform numbers first, then the position.
+ */
+struct OpponentSorter {
+    bool operator()( const PlayerObject * lhs,
+                     const PlayerObject * rhs ) const
+      {
+          const int lu = ( lhs->unum() == Unum_Unknown ? 12 : lhs->unum() );
+          const int ru = ( rhs->unum() == Unum_Unknown ? 12 : rhs->unum() );
+          if ( lu != ru ) return lu < ru;
+          if ( lhs->pos().x != rhs->pos().x ) return lhs->pos().x < rhs->pos().x;
+          return lhs->pos().y < rhs->pos().y;
+      }
+};
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MarkingPlanner::MarkingPlanner()
+    : M_update_time( -1, 0 )
+{
+    std::fill( M_mark_target, M_mark_target + 12,
+               static_cast< const PlayerObject * >( 0 ) );
+    std::fill( M_prev_mark_unum, M_prev_mark_unum + 12, 0 );
+
+    M_markers.reserve( 11 );
+    M_opponents.reserve( 11 );
+    M_cost.reserve( 11 * 22 );
+    M_row_to_col.reserve( 11 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MarkingPlanner &
+MarkingPlanner::instance()
+{
+    static MarkingPlanner s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MarkingPlanner::is_planned_role( const int unum )
+{
+    return ( Strategy::i().isMarkerType( unum )
+             || Strategy::i().isMidfielderType( unum ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+MarkingPlanner::get_mark_dist_thr( const int unum,
+                                   const Vector2D & home_pos )
+{
+    if ( Strategy::i().isMarkerType( unum )
+         && home_pos.x > -30.0 )
+    {
+        return 5.0; // Magic Number
+    }
+
+    return 7.0; // Magic Number
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MarkingPlanner::update( const WorldModel & wm )
+{
+    if ( M_update_time == wm.time() )
+    {
+        return;
+    }
+    M_update_time = wm.time();
+
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        if ( M_mark_target[unum] )
+        {
+            M_prev_mark_unum[unum] = M_mark_target[unum]->unum();
+            M_prev_mark_pos[unum] = M_mark_target[unum]->pos();
+        }
+        else
+        {
+            M_prev_mark_unum[unum] = 0;
+        }
+    }
+
+    std::fill( M_mark_target, M_mark_target + 12,
+               static_cast< const PlayerObject * >( 0 ) );
+
+    createCostMatrix();
+
+    const int rows = M_markers.size();
+    const int cols = M_opponents.size() + rows;
+
+    if ( rows == 0
+         || M_opponents.empty() )
+    {
+        return;
+    }
+
+    solve( rows, cols );
+
+    for ( int r = 0; r < rows; ++r )
+    {
+        const int c = M_row_to_col[r];
+        if ( c < static_cast< int >( M_opponents.size() )
+             && M_cost[r * cols + c] < FORBIDDEN_COST )
+        {
+            M_mark_target[M_markers[r]] = M_opponents[c];
+        }
+
+#ifdef DEBUG_PRINT
+        if ( M_mark_target[M_markers[r]] )
+        {
+            dlog.addText( Logger::TEAM,
+                          __FILE__": (update) %d -> opponent (%.1f %.1f)",
+                          M_markers[r],
+                          M_mark_target[M_markers[r]]->pos().x,
+                          M_mark_target[M_markers[r]]->pos().y );
+        }
+#endif
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MarkingPlanner::isPrevMarkTarget( const int unum,
+                                  const PlayerObject * opponent ) const
+{
+    const int prev_unum = M_prev_mark_unum[unum];
+
+    if ( prev_unum == 0
+         || opponent->unum() != prev_unum )
+    {
+        return false;
+    }
+
+    if ( prev_unum == Unum_Unknown )
+    {
+        return opponent->pos().dist2( M_prev_mark_pos[unum] )
+            < std::pow( KEEP_POS_TOLERANCE, 2 );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MarkingPlanner::createCostMatrix()
+{
+    M_markers.clear();
+    M_opponents.clear();
+
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        if ( is_planned_role( unum ) )
+        {
+            M_markers.push_back( unum );
+        }
+    }
+
+    const std::vector< PlayerGrid::Entry > & entries = FieldAnalyzer::i().opponentGrid().entries();
+    for ( std::vector< PlayerGrid::Entry >::const_iterator e = entries.begin();
+          e != entries.end();
+          ++e )
+    {
+        if ( e->pos_count_ <= COUNT_THR )
+        {
+            M_opponents.push_back( e->player_ );
+        }
+    }
+
+    std::sort( M_opponents.begin(), M_opponents.end(), OpponentSorter() );
+
+    const int rows = M_markers.size();
+    const int opps = M_opponents.size();
+    const int cols = opps + rows;
+
+    M_cost.assign( rows * cols, FORBIDDEN_COST );
+
+    for ( int r = 0; r < rows; ++r )
+    {
+        const int unum = M_markers[r];
+        const Vector2D home_pos = Strategy::i().getPosition( unum );
+        const double dist_thr = get_mark_dist_thr( unum, home_pos );
+
+        double * row = &M_cost[r * cols];
+
+        for ( int c = 0; c < opps; ++c )
+        {
+            const double d = home_pos.dist( M_opponents[c]->pos() );
+            if ( d < dist_thr )
+            {
+                row[c] = ( isPrevMarkTarget( unum, M_opponents[c] )
+                           ? std::max( 0.0, d - KEEP_BONUS )
+                           : d );
+            }
+        }
+
+        // no mark
+        for ( int c = opps; c < cols; ++c )
+        {
+            row[c] = dist_thr;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  Hungarian method with the potentials, O(rows^2 * cols).
+ */
+void
+MarkingPlanner::solve( const int rows,
+                       const int cols )
+{
+    const double INF = std::numeric_limits< double >::max();
+
+    // 1-based indices, column 0 is a virtual column
+    std::vector< double > u( rows + 1, 0.0 );
+    std::vector< double > v( cols + 1, 0.0 );
+    std::vector< int > p( cols + 1, 0 ); // row assigned to the column
+    std::vector< int > way( cols + 1, 0 );
+    std::vector< double > minv( cols + 1 );
+    std::vector< char > used( cols + 1 );
+
+    for ( int i = 1; i <= rows; ++i )
+    {
+        p[0] = i;
+        int j0 = 0;
+        std::fill( minv.begin(), minv.end(), INF );
+        std::fill( used.begin(), used.end(), 0 );
+
+        do
+        {
+            used[j0] = 1;
+            const int i0 = p[j0];
+            const double * row = &M_cost[( i0 - 1 ) * cols];
+            double delta = INF;
+            int j1 = 0;
+
+            for ( int j = 1; j <= cols; ++j )
+            {
+                if ( used[j] ) continue;
+
+                const double cur = row[j - 1] - u[i0] - v[j];
+                if ( cur < minv[j] )
+                {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if ( minv[j] < delta )
+                {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+
+            for ( int j = 0; j <= cols; ++j )
+            {
+                if ( used[j] )
+                {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                }
+                else
+                {
+                    minv[j] -= delta;
+                }
+            }
+
+            j0 = j1;
+        } while ( p[j0] != 0 );
+
+        do
+        {
+            const int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while ( j0 != 0 );
+    }
+
+    M_row_to_col.assign( rows, -1 );
+    for ( int j = 1; j <= cols; ++j )
+    {
+        if ( p[j] != 0 )
+        {
+            M_row_to_col[p[j] - 1] = j - 1;
+        }
+    }
+}
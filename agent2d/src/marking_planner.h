@@ -0,0 +1,163 @@
+// -*-c++-*-
+
+/*!
+  \file marking_planner.h
+  \brief team consistent marking assignment Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef MARKING_PLANNER_H
+#define MARKING_PLANNER_H
+
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/game_time.h>
+
+#include <vector>
+
+namespace rcsc {
+class PlayerObject;
+class WorldModel;
+}
+
+/*!
+  \class MarkingPlanner
+  \brief assignment of the marking players to the opponents.
+
+  Once per cycle, the marking players (marker and midfielder types) are
+  assigned to the opponents by the Hungarian method. The cost of a pair
+  is the distance between the player's strategic position and the
+  opponent. Pairs farther than the player's mark distance threshold are
+  not allowed. Every player solves the same problem in the same order,
+  so the plan is consistent within the team as long as the world models
+  agree. Each player only reads its own slot. Keeping the previous
+  cycle's pair gets a small bonus to avoid oscillation.
+ */
+class MarkingPlanner {
+public:
+
+    //! accuracy count threshold of the marked opponents
+    static const int COUNT_THR = 4;
+
+private:
+
+    rcsc::GameTime M_update_time;
+
+    //! marked opponent indexed by the uniform number
+    const rcsc::PlayerObject * M_mark_target[12];
+
+    //
+    // result of the previous cycle. the opponent objects are not kept
+    // across cycles, so the target is identified by its uniform number,
+    // or by its position if the uniform number is unknown.
+    //
+    int M_prev_mark_unum[12]; //!< 0 means no target
+    rcsc::Vector2D M_prev_mark_pos[12];
+
+    //
+    // work area of the assignment solver
+    //
+    std::vector< int > M_markers; //!< uniform numbers of the rows
+    std::vector< const rcsc::PlayerObject * > M_opponents; //!< opponents of the columns
+    std::vector< double > M_cost; //!< row major cost matrix
+    std::vector< int > M_row_to_col; //!< assignment result
+
+    // private for singleton
+    MarkingPlanner();
+
+    // not used
+    MarkingPlanner( const MarkingPlanner & );
+    MarkingPlanner & operator=( const MarkingPlanner & );
+
+public:
+
+    static
+    MarkingPlanner & instance();
+
+    static
+    const MarkingPlanner & i()
+      {
+          return instance();
+      }
+
+    /*!
+      \brief update the assignment. Strategy and FieldAnalyzer have to
+      be updated before this method.
+      \param wm world model reference
+     */
+    void update( const rcsc::WorldModel & wm );
+
+    /*!
+      \brief get the opponent assigned to the player.
+      \param unum uniform number of the marking player
+      \return opponent pointer or NULL
+     */
+    const rcsc::PlayerObject * markTarget( const int unum ) const
+      {
+          return ( 1 <= unum && unum <= 11
+                   ? M_mark_target[unum]
+                   : static_cast< const rcsc::PlayerObject * >( 0 ) );
+      }
+
+    /*!
+      \brief check if the player's role is assigned by this planner.
+      \param unum uniform number of the player
+      \return true if the player is a marker or midfielder type
+     */
+    static
+    bool is_planned_role( const int unum );
+
+    /*!
+      \brief get the max distance between the strategic position and the
+      marked opponent.
+      \param unum uniform number of the marking player
+      \param home_pos strategic position of the player
+      \return distance threshold
+     */
+    static
+    double get_mark_dist_thr( const int unum,
+                              const rcsc::Vector2D & home_pos );
+
+private:
+
+    /*!
+      \brief check if the opponent was marked by the player in the
+      previous cycle.
+     */
+    bool isPrevMarkTarget( const int unum,
+                           const rcsc::PlayerObject * opponent ) const;
+
+    void createCostMatrix();
+
+    /*!
+      \brief solve the assignment problem on M_cost.
+      \param rows the number of rows
+      \param cols the number of columns (>= rows)
+     */
+    void solve( const int rows,
+                const int cols );
+};
+
+#endif
@@ -36,6 +36,8 @@
 #include "neck_offensive_intercept_neck.h"
 
 #include "shoot_generator.h"
+#include "ball_kinematics.h"
+#include "field_analyzer.h"
 
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
@@ -100,9 +102,10 @@ Neck_OffensiveInterceptNeck::execute( PlayerAgent * agent )
         }
         else
         {
-            const PlayerObject * nearest_opp = wm.getOpponentNearestTo( next_ball_pos,
-                                                                        10,
-                                                                        NULL );
+            const PlayerObject * nearest_opp
+                = FieldAnalyzer::i().opponentGrid().nearest( next_ball_pos,
+                                                             10,
+                                                             NULL );
             if ( nearest_opp
                  && next_ball_pos.dist( nearest_opp->pos() + nearest_opp->vel() )
                  < nearest_opp->playerTypePtr()->kickableArea() + 0.3 )
@@ -118,7 +121,7 @@ Neck_OffensiveInterceptNeck::execute( PlayerAgent * agent )
 
     ViewAction * view = static_cast< ViewAction * >( 0 );
 
-    const double trap_ball_speed = wm.ball().vel().r() * std::pow( ServerParam::i().ballDecay(), 5 );
+    const double trap_ball_speed = BallKinematics::instance().speedAfter( wm.ball().vel().r(), 5 );
 
     if ( self_min == 4 && opp_min >= 3 )
     {
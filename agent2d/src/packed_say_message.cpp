@@ -0,0 +1,479 @@
+// -*-c++-*-
+
+/*!
+  \file packed_say_message.cpp
+  \brief bit-packed say message of the ball and players Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "packed_say_message.h"
+
+#include <rcsc/common/audio_memory.h>
+#include <rcsc/common/logger.h>
+#include <rcsc/game_time.h>
+#include <rcsc/math_util.h>
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+// #define DEBUG_PRINT
+
+using namespace rcsc;
+
+namespace {
+
+//! characters available to the say command
+const std::string CHAR_SET = "0123456789"
+                             "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                             "abcdefghijklmnopqrstuvwxyz"
+                             "().+-*/?<>_";
+const boost::uint64_t CHAR_SIZE = 73;
+
+//! max number of the characters whose values fit in 64 bit
+const int MAX_CHARS = 10;
+
+//! object code: 0 is the end mark, 1 + number for the objects
+const boost::uint64_t NUMBER_RADIX = 24;
+
+// quantization range. the decoder has to use the same values.
+const double MIN_X = -54.0; // Magic Number
+const double MAX_X = +54.0; // Magic Number
+const double MIN_Y = -35.0; // Magic Number
+const double MAX_Y = +35.0; // Magic Number
+const double MAX_VEL = 3.0; // Magic Number
+
+const double POS_STEP[PackedObjectMessage::STEP_LEVEL_SIZE] = { 0.25, 0.5, 1.0, 2.0 }; // Magic Number
+const double VEL_STEP[PackedObjectMessage::STEP_LEVEL_SIZE] = { 0.05, 0.1, 0.2, 0.4 }; // Magic Number
+
+//! step level and time of the last heard player, indexed by the object number
+int g_heard_level[23];
+GameTime g_heard_time[23];
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief a digit of the mixed radix integer.
+ */
+struct Digit {
+    boost::uint64_t value_;
+    boost::uint64_t radix_;
+
+    Digit( const boost::uint64_t value,
+           const boost::uint64_t radix )
+        : value_( value ),
+          radix_( radix )
+      { }
+};
+
+inline
+boost::uint64_t
+get_radix( const double & min_val,
+           const double & max_val,
+           const double & step )
+{
+    return static_cast< boost::uint64_t >( std::ceil( ( max_val - min_val ) / step - 1.0e-6 ) ) + 1;
+}
+
+inline
+Digit
+quantize( const double & val,
+          const double & min_val,
+          const double & max_val,
+          const double & step )
+{
+    const boost::uint64_t radix = get_radix( min_val, max_val, step );
+    const double index = std::floor( ( val - min_val ) / step + 0.5 );
+
+    return Digit( static_cast< boost::uint64_t >( bound( 0.0, index, double( radix - 1 ) ) ),
+                  radix );
+}
+
+inline
+double
+restore( const boost::uint64_t index,
+         const double & min_val,
+         const double & step )
+{
+    return min_val + step * index;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief pop the least significant digit.
+ */
+inline
+boost::uint64_t
+pop_digit( boost::uint64_t * value,
+           const boost::uint64_t radix )
+{
+    const boost::uint64_t digit = *value % radix;
+    *value /= radix;
+    return digit;
+}
+
+inline
+boost::uint64_t
+pop_digit( boost::uint64_t * value,
+           const double & min_val,
+           const double & max_val,
+           const double & step )
+{
+    return pop_digit( value, get_radix( min_val, max_val, step ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the digits of the object, from the least significant one.
+ */
+void
+create_digits( const PackedObjectMessage::Object & obj,
+               std::vector< Digit > & digits )
+{
+    const int level = PackedObjectMessage::get_step_level( obj.error_ );
+    const double pos_step = POS_STEP[level];
+
+    digits.clear();
+    digits.push_back( Digit( obj.number_ + 1, NUMBER_RADIX ) );
+    digits.push_back( Digit( level, PackedObjectMessage::STEP_LEVEL_SIZE ) );
+    digits.push_back( quantize( obj.pos_.x, MIN_X, MAX_X, pos_step ) );
+    digits.push_back( quantize( obj.pos_.y, MIN_Y, MAX_Y, pos_step ) );
+
+    if ( obj.number_ == 0 )
+    {
+        const double vel_step = VEL_STEP[level];
+        digits.push_back( quantize( obj.vel_.x, -MAX_VEL, MAX_VEL, vel_step ) );
+        digits.push_back( quantize( obj.vel_.y, -MAX_VEL, MAX_VEL, vel_step ) );
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+PackedObjectMessage::PackedObjectMessage( const std::vector< Object > & objects,
+                                          const int max_length )
+{
+    const int max_chars = std::min( max_length - 1, MAX_CHARS );
+    if ( max_chars <= 0 )
+    {
+        return;
+    }
+
+    boost::uint64_t limit = 1;
+    for ( int i = 0; i < max_chars; ++i )
+    {
+        limit *= CHAR_SIZE;
+    }
+
+    //
+    // select the objects while the product of the radixes fits in the limit
+    //
+
+    std::vector< Digit > digits;
+    std::vector< Digit > object_digits;
+    boost::uint64_t product = 1;
+    bool packed[23];
+    std::fill( packed, packed + 23, false );
+
+    for ( std::vector< Object >::const_iterator o = objects.begin(), end = objects.end();
+          o != end;
+          ++o )
+    {
+        if ( o->number_ < 0 || 22 < o->number_
+             || packed[o->number_] )
+        {
+            continue;
+        }
+
+        create_digits( *o, object_digits );
+
+        boost::uint64_t p = product;
+        for ( std::vector< Digit >::const_iterator d = object_digits.begin(), d_end = object_digits.end();
+              d != d_end;
+              ++d )
+        {
+            if ( p > limit / d->radix_ )
+            {
+                p = 0;
+                break;
+            }
+            p *= d->radix_;
+        }
+
+        if ( p == 0 )
+        {
+            // a coarser object may still fit
+            continue;
+        }
+
+        product = p;
+        digits.insert( digits.end(), object_digits.begin(), object_digits.end() );
+        packed[o->number_] = true;
+        M_numbers.push_back( o->number_ );
+    }
+
+    if ( M_numbers.empty() )
+    {
+        return;
+    }
+
+    //
+    // the first digit is the least significant one.
+    // the end mark is implicitly placed above the most significant digit.
+    //
+
+    boost::uint64_t value = 0;
+    for ( std::vector< Digit >::const_reverse_iterator d = digits.rbegin(), end = digits.rend();
+          d != end;
+          ++d )
+    {
+        value = value * d->radix_ + d->value_;
+    }
+
+    do
+    {
+        M_message += CHAR_SET[value % CHAR_SIZE];
+        value /= CHAR_SIZE;
+    }
+    while ( value > 0 );
+
+    std::reverse( M_message.begin(), M_message.end() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+PackedObjectMessage::get_step_level( const double & error )
+{
+    // select the coarsest step whose rounding error does not exceed the
+    // expected error of the object
+    for ( int level = STEP_LEVEL_SIZE - 1; level > 0; --level )
+    {
+        if ( POS_STEP[level] * 0.5 <= error )
+        {
+            return level;
+        }
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PackedObjectMessage::get_pos_step( const int level )
+{
+    return POS_STEP[bound( 0, level, STEP_LEVEL_SIZE - 1 )];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PackedObjectMessage::get_vel_step( const int level )
+{
+    return VEL_STEP[bound( 0, level, STEP_LEVEL_SIZE - 1 )];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+PackedObjectMessage::appendTo( std::string & to ) const
+{
+    if ( M_message.empty() )
+    {
+        return false;
+    }
+
+    to += header();
+    to += M_message;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+PackedObjectMessage::printDebug( std::ostream & os ) const
+{
+    os << "[Packed:";
+    for ( std::vector< int >::const_iterator n = M_numbers.begin(), end = M_numbers.end();
+          n != end;
+          ++n )
+    {
+        if ( *n == 0 ) os << 'B';
+        else if ( *n <= 11 ) os << 'T' << *n;
+        else os << 'O' << *n - 11;
+    }
+    os << ']';
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+PackedObjectMessageParser::PackedObjectMessageParser( boost::shared_ptr< AudioMemory > memory )
+    : M_memory( memory )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+PackedObjectMessageParser::parse( const int sender,
+                                  const double & ,
+                                  const char * msg,
+                                  const GameTime & current )
+{
+    if ( *msg != sheader() )
+    {
+        return 0;
+    }
+
+    //
+    // the message continues until the end of the say message
+    //
+
+    boost::uint64_t value = 0;
+    int len = 0;
+    for ( const char * c = msg + 1; *c != '\0'; ++c )
+    {
+        const std::string::size_type index = CHAR_SET.find( *c );
+        if ( index == std::string::npos )
+        {
+            break;
+        }
+
+        if ( len >= MAX_CHARS )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " ***ERROR*** PackedObjectMessageParser::parse()"
+                      << " Illegal message length [" << msg << ']'
+                      << std::endl;
+            dlog.addText( Logger::SENSOR,
+                          __FILE__": (PackedObjectMessageParser) illegal length [%s]",
+                          msg );
+            return -1;
+        }
+
+        value = value * CHAR_SIZE + index;
+        ++len;
+    }
+
+    if ( len == 0 )
+    {
+        dlog.addText( Logger::SENSOR,
+                      __FILE__": (PackedObjectMessageParser) empty message [%s]",
+                      msg );
+        return -1;
+    }
+
+    for ( int count = 0; count < 23; ++count )
+    {
+        const boost::uint64_t code = pop_digit( &value, NUMBER_RADIX );
+        if ( code == 0 )
+        {
+            break;
+        }
+
+        const int number = static_cast< int >( code ) - 1;
+        const int level = static_cast< int >( pop_digit( &value, PackedObjectMessage::STEP_LEVEL_SIZE ) );
+        const double pos_step = POS_STEP[level];
+
+        // the digits have to be popped in the order of the encoder
+        Vector2D pos;
+        pos.x = restore( pop_digit( &value, MIN_X, MAX_X, pos_step ), MIN_X, pos_step );
+        pos.y = restore( pop_digit( &value, MIN_Y, MAX_Y, pos_step ), MIN_Y, pos_step );
+
+        if ( number == 0 )
+        {
+            const double vel_step = VEL_STEP[level];
+            Vector2D vel;
+            vel.x = restore( pop_digit( &value, -MAX_VEL, MAX_VEL, vel_step ), -MAX_VEL, vel_step );
+            vel.y = restore( pop_digit( &value, -MAX_VEL, MAX_VEL, vel_step ), -MAX_VEL, vel_step );
+
+            M_memory->setBall( sender, pos, vel, current );
+#ifdef DEBUG_PRINT
+            dlog.addText( Logger::SENSOR,
+                          __FILE__": (PackedObjectMessageParser) ball pos=(%.2f %.2f) vel=(%.2f %.2f) step=%.2f",
+                          pos.x, pos.y, vel.x, vel.y, pos_step );
+#endif
+        }
+        else
+        {
+            M_memory->setPlayer( sender, number, pos, current );
+            g_heard_level[number] = level;
+            g_heard_time[number] = current;
+#ifdef DEBUG_PRINT
+            dlog.addText( Logger::SENSOR,
+                          __FILE__": (PackedObjectMessageParser) %s %d pos=(%.2f %.2f) step=%.2f",
+                          ( number <= 11 ? "teammate" : "opponent" ),
+                          ( number <= 11 ? number : number - 11 ),
+                          pos.x, pos.y, pos_step );
+#endif
+        }
+    }
+
+    return 1 + len;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PackedObjectMessageParser::heard_pos_step( const int number,
+                                           const GameTime & time )
+{
+    if ( 1 <= number && number <= 22
+         && g_heard_time[number] == time )
+    {
+        return POS_STEP[g_heard_level[number]];
+    }
+
+    return POS_STEP[PackedObjectMessage::STEP_LEVEL_SIZE - 1];
+}
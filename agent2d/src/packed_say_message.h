@@ -0,0 +1,221 @@
+// -*-c++-*-
+
+/*!
+  \file packed_say_message.h
+  \brief bit-packed say message of the ball and players Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifndef PACKED_SAY_MESSAGE_H
+#define PACKED_SAY_MESSAGE_H
+
+#include <rcsc/player/say_message_builder.h>
+#include <rcsc/common/say_message_parser.h>
+#include <rcsc/geom/vector_2d.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+#include <string>
+
+namespace rcsc {
+class AudioMemory;
+class GameTime;
+}
+
+/*!
+  \class PackedObjectMessage
+  \brief say message that packs a variable number of the ball and
+  players for our own team.
+
+  Each object is quantized with the grid step selected from its expected
+  position error, so an object observed with a large error does not
+  waste the audio channel. The fields of all objects are packed into one
+  mixed radix integer without any padding between the fields, and the
+  integer is written with all characters available to the say command.
+  The number of the objects is not fixed. The decoder reads the objects
+  until the end mark (the object code 0) that needs no character when it
+  is the most significant digit.
+
+  The message length is not encoded, so this message has to be the last
+  message in the say command, and the parser consumes the rest of it.
+ */
+class PackedObjectMessage
+    : public rcsc::SayMessage {
+public:
+
+    //! the number of the quantization step levels
+    static const int STEP_LEVEL_SIZE = 4;
+
+    /*!
+      \struct Object
+      \brief an object to be packed.
+     */
+    struct Object {
+        int number_; //!< 0: ball, 1-11: teammate, 12-22: opponent
+        rcsc::Vector2D pos_; //!< position
+        rcsc::Vector2D vel_; //!< velocity (only for the ball)
+        double error_; //!< expected position error of the sender
+
+        Object( const int number,
+                const rcsc::Vector2D & pos,
+                const rcsc::Vector2D & vel,
+                const double & error )
+            : number_( number ),
+              pos_( pos ),
+              vel_( vel ),
+              error_( error )
+          { }
+    };
+
+private:
+
+    std::string M_message; //!< encoded message without the header
+    std::vector< int > M_numbers; //!< packed objects
+
+public:
+
+    /*!
+      \brief pack the objects in the given order. the objects that do not
+      fit in the remaining space are skipped.
+      \param objects candidate objects ordered by priority
+      \param max_length max message length including the header
+     */
+    PackedObjectMessage( const std::vector< Object > & objects,
+                         const int max_length );
+
+    static
+    char sheader()
+      {
+          return 'X';
+      }
+
+    //! length of the shortest message that can contain one player
+    //! quantized with the coarsest step
+    static
+    int min_length()
+      {
+          return 4;
+      }
+
+    /*!
+      \brief select the quantization step level from the expected error.
+      \param error expected position error
+      \return step level
+     */
+    static
+    int get_step_level( const double & error );
+
+    /*!
+      \brief get the quantization step of the position.
+      \param level step level
+      \return grid step
+     */
+    static
+    double get_pos_step( const int level );
+
+    /*!
+      \brief get the quantization step of the ball velocity.
+      \param level step level
+      \return grid step
+     */
+    static
+    double get_vel_step( const int level );
+
+    virtual
+    char header() const
+      {
+          return sheader();
+      }
+
+    virtual
+    int length() const
+      {
+          return ( M_message.empty()
+                   ? 0
+                   : static_cast< int >( M_message.length() ) + 1 );
+      }
+
+    //! numbers of the packed objects
+    const std::vector< int > & numbers() const
+      {
+          return M_numbers;
+      }
+
+    virtual
+    bool appendTo( std::string & to ) const;
+
+    virtual
+    std::ostream & printDebug( std::ostream & os ) const;
+};
+
+/*!
+  \class PackedObjectMessageParser
+  \brief decoder of PackedObjectMessage.
+ */
+class PackedObjectMessageParser
+    : public rcsc::SayMessageParser {
+private:
+
+    boost::shared_ptr< rcsc::AudioMemory > M_memory;
+
+public:
+
+    explicit
+    PackedObjectMessageParser( boost::shared_ptr< rcsc::AudioMemory > memory );
+
+    static
+    char sheader()
+      {
+          return PackedObjectMessage::sheader();
+      }
+
+    virtual
+    char header() const
+      {
+          return sheader();
+      }
+
+    virtual
+    int parse( const int sender,
+               const double & dir,
+               const char * msg,
+               const rcsc::GameTime & current );
+
+    /*!
+      \brief get the quantization step of the heard player position.
+      \param number 1-11: teammate, 12-22: opponent
+      \param time heard time
+      \return grid step of the last packed message heard at the time, or
+      the coarsest step if the player was not heard by this message.
+     */
+    static
+    double heard_pos_step( const int number,
+                           const rcsc::GameTime & time );
+};
+
+#endif
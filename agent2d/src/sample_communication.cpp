@@ -36,6 +36,7 @@
 #include "sample_communication.h"
 
 #include "strategy.h"
+#include "packed_say_message.h"
 
 #include <rcsc/formation/formation.h>
 #include <rcsc/player/player_agent.h>
@@ -49,6 +50,8 @@
 #include <rcsc/common/audio_memory.h>
 #include <rcsc/common/say_message_parser.h>
 
+#include <algorithm>
+#include <sstream>
 #include <cmath>
 
 // #define DEBUG_PRINT
@@ -137,6 +140,21 @@ distance_rate( const double & val,
 
 }
 
+/*!
+  \brief snap the position to the center of its grid cell.
+  the players see slightly different positions, so the schedule is
+  computed from the coarse positions that they agree on.
+ */
+inline
+Vector2D
+quantize_position( const Vector2D & pos )
+{
+    static const double cell_size = 10.0; // Magic Number
+
+    return Vector2D( ( std::floor( pos.x / cell_size ) + 0.5 ) * cell_size,
+                     ( std::floor( pos.y / cell_size ) + 0.5 ) * cell_size );
+}
+
 inline
 double
 distance_from_ball( const AbstractPlayerObject * p,
@@ -149,6 +167,48 @@ distance_from_ball( const AbstractPlayerObject * p,
                       + std::pow( ( p->pos().y - ball_pos.y ) * y_rate, 2 ) ); // Magic Number
 }
 
+/*!
+  \brief select the objects with the largest gains.
+  \param gain gain of each object
+  \param size the number of the objects
+  \param max_count max number of the selected objects
+  \param total variable to store the total gain of the selected objects
+  \return bit set of the selected objects
+ */
+int
+select_objects( const double * gain,
+                const int size,
+                const int max_count,
+                double * total )
+{
+    int selected = 0;
+    *total = 0.0;
+
+    for ( int n = 0; n < max_count; ++n )
+    {
+        int best = -1;
+        for ( int i = 0; i < size; ++i )
+        {
+            if ( ( selected & ( 1 << i ) ) == 0
+                 && gain[i] > 0.0
+                 && ( best < 0 || gain[i] > gain[best] ) )
+            {
+                best = i;
+            }
+        }
+
+        if ( best < 0 )
+        {
+            break;
+        }
+
+        selected |= ( 1 << best );
+        *total += gain[best];
+    }
+
+    return selected;
+}
+
 }
 
 /*-------------------------------------------------------------------*/
@@ -158,8 +218,15 @@ distance_from_ball( const AbstractPlayerObject * p,
 SampleCommunication::SampleCommunication()
     : M_current_sender_unum( Unum_Unknown ),
       M_next_sender_unum( Unum_Unknown ),
+      M_current_objects( 0 ),
       M_ball_send_time( 0, 0 )
 {
+    for ( int i = 0; i < SCHEDULE_SIZE; ++i )
+    {
+        M_schedule_sender[i] = Unum_Unknown;
+        M_schedule_objects[i] = 0;
+    }
+
     for ( int i = 0; i < 12; ++i )
     {
         M_teammate_send_time[i].assign( 0, 0 );
@@ -227,8 +294,10 @@ SampleCommunication::execute( PlayerAgent * agent )
 #endif
 
 #if 1
-    sayBallAndPlayers( agent );
+    // PackedObjectMessage consumes the rest of the say message.
+    // the stamina is appended before it.
     sayStamina( agent );
+    sayBallAndPlayers( agent );
 #else
     sayBall( agent );
     sayGoalie( agent );
@@ -249,6 +318,8 @@ SampleCommunication::updateCurrentSender( const PlayerAgent * agent )
 {
     const WorldModel & wm = agent->world();
 
+    M_current_objects = 0;
+
     if ( agent->effector().getSayMessageLength() > 0 )
     {
         M_current_sender_unum = wm.self().unum();
@@ -304,24 +375,163 @@ SampleCommunication::updateCurrentSender( const PlayerAgent * agent )
                 ? wm.time().cycle() + wm.time().stopped()
                 : wm.time().cycle() );
 
-    int current = val % candidate_unum.size();
-    int next = ( val + 1 ) % candidate_unum.size();
+    const int block = val / SCHEDULE_SIZE;
+    const int slot = val % SCHEDULE_SIZE;
+
+    createSchedule( wm, candidate_unum, block,
+                    M_schedule_sender, M_schedule_objects );
 
-    M_current_sender_unum = candidate_unum[current];
-    M_next_sender_unum = candidate_unum[next];
+    M_current_sender_unum = M_schedule_sender[slot];
+    M_current_objects = M_schedule_objects[slot];
+
+    if ( slot + 1 < SCHEDULE_SIZE )
+    {
+        M_next_sender_unum = M_schedule_sender[slot + 1];
+    }
+    else
+    {
+        int senders[SCHEDULE_SIZE];
+        int objects[SCHEDULE_SIZE];
+        createSchedule( wm, candidate_unum, block + 1,
+                        senders, objects );
+        M_next_sender_unum = senders[0];
+    }
 
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::COMMUNICATION,
-                  __FILE__": (updateCurrentSender) time=%d size=%d index=%d current=%d next=%d",
+                  __FILE__": (updateCurrentSender) time=%d size=%d slot=%d current=%d objects=%x next=%d",
                   wm.time().cycle(),
                   candidate_unum.size(),
-                  current,
+                  slot,
                   M_current_sender_unum,
+                  M_current_objects,
                   M_next_sender_unum );
 #endif
 
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+  The objects are the ball and the home positions of the teammates, that
+  are known to all players. Their positions are snapped to a 10m grid,
+  because each player sees a slightly different ball. The accuracy of a sender for an object
+  decreases with the distance between them, and the importance of an
+  object decreases with the distance from the ball. Each cycle is given
+  to the sender that can report the largest sum of
+  importance * accuracy * staleness over its best objects, and the
+  reported objects become fresh. The previous block is also planned as a
+  warm-up, so that the staleness is carried over to this block.
+ */
+void
+SampleCommunication::createSchedule( const WorldModel & wm,
+                                     const std::vector< int > & candidate_unum,
+                                     const int block,
+                                     int * senders,
+                                     int * objects ) const
+{
+    static const double accuracy_variance = 20.0; // Magic Number
+    static const double importance_variance = 30.0; // Magic Number
+    static const double ball_importance = 2.0; // Magic Number
+    static const int max_objects = 3; // Magic Number
+
+    const int size = static_cast< int >( candidate_unum.size() );
+
+    for ( int slot = 0; slot < SCHEDULE_SIZE; ++slot )
+    {
+        senders[slot] = Unum_Unknown;
+        objects[slot] = 0;
+    }
+
+    if ( size == 0 )
+    {
+        return;
+    }
+
+    //
+    // object 0: ball, 1-11: teammates
+    // all positions are quantized, so that every teammate makes the same
+    // plan even if their world models differ a little.
+    //
+    const Vector2D ball_pos = quantize_position( wm.ball().pos() );
+
+    Vector2D object_pos[12];
+    double importance[12];
+
+    object_pos[0] = ball_pos;
+    importance[0] = ball_importance;
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        object_pos[unum] = quantize_position( Strategy::i().getPosition( unum ) );
+        importance[unum] = distance_rate( object_pos[unum].dist( ball_pos ),
+                                          importance_variance );
+    }
+
+    std::vector< double > accuracy( size * 12 );
+    for ( int i = 0; i < size; ++i )
+    {
+        const int unum = candidate_unum[i];
+        for ( int o = 0; o < 12; ++o )
+        {
+            accuracy[i * 12 + o] = ( o == unum
+                                     ? 1.0
+                                     : distance_rate( object_pos[unum].dist( object_pos[o] ),
+                                                      accuracy_variance ) );
+        }
+    }
+
+    double staleness[12];
+    std::fill( staleness, staleness + 12, 1.0 );
+
+    double gain[12];
+
+    for ( int b = std::max( 0, block - 1 ); b <= block; ++b )
+    {
+        for ( int slot = 0; slot < SCHEDULE_SIZE; ++slot )
+        {
+            int best_index = -1;
+            int best_objects = 0;
+            double best_value = -1.0;
+
+            // rotate the start index to break the ties in turn
+            const int offset = ( b * SCHEDULE_SIZE + slot ) % size;
+
+            for ( int k = 0; k < size; ++k )
+            {
+                const int i = ( k + offset ) % size;
+                for ( int o = 0; o < 12; ++o )
+                {
+                    gain[o] = importance[o] * accuracy[i * 12 + o] * staleness[o];
+                }
+
+                double value = 0.0;
+                const int selected = select_objects( gain, 12, max_objects, &value );
+
+                if ( value > best_value )
+                {
+                    best_index = i;
+                    best_objects = selected;
+                    best_value = value;
+                }
+            }
+
+            for ( int o = 0; o < 12; ++o )
+            {
+                if ( best_objects & ( 1 << o ) )
+                {
+                    staleness[o] = 0.0;
+                }
+                staleness[o] += 1.0;
+            }
+
+            if ( b == block )
+            {
+                senders[slot] = candidate_unum[best_index];
+                objects[slot] = best_objects;
+            }
+        }
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -771,6 +981,23 @@ SampleCommunication::sayBallAndPlayers( PlayerAgent * agent )
         }
     }
 
+    //
+    // objects assigned to this player by the team schedule
+    //
+    if ( currentSenderUnum() == wm.self().unum() )
+    {
+        const double scheduled_rate = 4.0; // Magic Number
+
+        for ( int i = 0; i <= 11; ++i )
+        {
+            if ( isScheduledObject( i )
+                 && objects[i].score_ > 0.0 )
+            {
+                objects[i].score_ *= scheduled_rate;
+            }
+        }
+    }
+
     //
     // erase illegal(unseen) objects
     //
@@ -858,6 +1085,94 @@ SampleCommunication::sayBallAndPlayers( PlayerAgent * agent )
         ball_vel.assign( 0.0, 0.0 );
     }
 
+    //
+    // send the packed message of our team.
+    // the ball and opponent goalie message is used to send the goalie body.
+    //
+    if ( ! ( send_ball_and_player && should_say_goalie )
+         && available_len >= PackedObjectMessage::min_length() )
+    {
+        const double dist_error_rate = 0.05; // Magic Number
+        const double count_error_rate = 0.4; // Magic Number
+
+        const double ball_error = ( wm.self().isKickable()
+                                    ? 0.0
+                                    : ( wm.ball().distFromSelf() * dist_error_rate
+                                        + wm.ball().posCount() * count_error_rate ) );
+
+        std::vector< PackedObjectMessage::Object > packed_objects;
+        packed_objects.reserve( objects.size() + 1 );
+
+        if ( should_say_ball )
+        {
+            packed_objects.push_back( PackedObjectMessage::Object( 0,
+                                                                   agent->effector().queuedNextBallPos(),
+                                                                   ball_vel,
+                                                                   ball_error ) );
+        }
+
+        for ( std::vector< ObjectScore >::const_iterator it = objects.begin();
+              it != objects.end();
+              ++it )
+        {
+            if ( it->number_ == 0 )
+            {
+                packed_objects.push_back( PackedObjectMessage::Object( 0,
+                                                                       agent->effector().queuedNextBallPos(),
+                                                                       ball_vel,
+                                                                       ball_error ) );
+            }
+            else if ( it->number_ == wm.self().unum() )
+            {
+                packed_objects.push_back( PackedObjectMessage::Object( it->number_,
+                                                                       agent->effector().queuedNextSelfPos(),
+                                                                       Vector2D( 0.0, 0.0 ),
+                                                                       0.0 ) );
+            }
+            else
+            {
+                const AbstractPlayerObject * p = it->player_;
+                packed_objects.push_back( PackedObjectMessage::Object( it->number_,
+                                                                       p->pos() + p->vel(),
+                                                                       Vector2D( 0.0, 0.0 ),
+                                                                       p->distFromSelf() * dist_error_rate
+                                                                       + p->posCount() * count_error_rate ) );
+            }
+        }
+
+        PackedObjectMessage * msg = new PackedObjectMessage( packed_objects, available_len );
+        if ( msg->length() > 0 )
+        {
+            for ( std::vector< int >::const_iterator n = msg->numbers().begin();
+                  n != msg->numbers().end();
+                  ++n )
+            {
+                if ( *n == 0 )
+                {
+                    M_ball_send_time = wm.time();
+                }
+                else
+                {
+                    updatePlayerSendTime( wm,
+                                          ( *n <= 11 ? wm.ourSide() : wm.theirSide() ),
+                                          ( *n <= 11 ? *n : *n - 11 ) );
+                }
+            }
+
+#ifdef DEBUG_PRINT
+            std::ostringstream os;
+            msg->printDebug( os );
+            dlog.addText( Logger::COMMUNICATION,
+                          __FILE__": (sayBallAndPlayers) packed %s",
+                          os.str().c_str() );
+#endif
+            agent->addSayMessage( msg );
+            return true;
+        }
+
+        delete msg;
+    }
+
     //
     // send ball only
     //
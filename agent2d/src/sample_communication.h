@@ -37,16 +37,32 @@
 #include <rcsc/game_time.h>
 #include <rcsc/types.h>
 
+#include <vector>
+
 namespace rcsc {
 class WorldModel;
 }
 
 class SampleCommunication
     : public Communication {
+public:
+
+    //! the number of the cycles planned by one team schedule
+    static const int SCHEDULE_SIZE = 4;
+
 private:
 
     int M_current_sender_unum;
     int M_next_sender_unum;
+
+    //
+    // team schedule of the current cycles.
+    // every player creates the same schedule from the formation.
+    //
+    int M_schedule_sender[SCHEDULE_SIZE]; //!< sender of each cycle
+    int M_schedule_objects[SCHEDULE_SIZE]; //!< bit set of the assigned objects (0: ball, 1-11: teammates)
+    int M_current_objects; //!< objects assigned to the current sender
+
     rcsc::GameTime M_ball_send_time;
     rcsc::GameTime M_teammate_send_time[12];
     rcsc::GameTime M_opponent_send_time[12];
@@ -63,9 +79,33 @@ public:
 
     int nextSenderUnum() const { return M_next_sender_unum; }
 
+    /*!
+      \brief check if the object is assigned to the current sender.
+      \param number 0: ball, 1-11: teammate
+     */
+    bool isScheduledObject( const int number ) const
+      {
+          return ( 0 <= number && number <= 11
+                   && ( M_current_objects & ( 1 << number ) ) != 0 );
+      }
+
 private:
     void updateCurrentSender( const rcsc::PlayerAgent * agent );
 
+    /*!
+      \brief plan the senders and their objects of SCHEDULE_SIZE cycles.
+      \param wm world model
+      \param candidate_unum sender candidates
+      \param block index of the planned cycles (cycle / SCHEDULE_SIZE)
+      \param senders array to store the senders
+      \param objects array to store the bit sets of the assigned objects
+     */
+    void createSchedule( const rcsc::WorldModel & wm,
+                         const std::vector< int > & candidate_unum,
+                         const int block,
+                         int * senders,
+                         int * objects ) const;
+
     void updatePlayerSendTime( const rcsc::WorldModel & wm,
                                const rcsc::SideID side,
                                const int unum );
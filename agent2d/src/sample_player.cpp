@@ -32,14 +32,30 @@
 
 #include "strategy.h"
 #include "field_analyzer.h"
+#include "marking_planner.h"
+#include "shared_table_segment.h"
 
 #include "action_chain_holder.h"
 #include "sample_field_evaluator.h"
+#include "strict_check_pass_generator.h"
+#include "cross_generator.h"
+#include "shoot_generator.h"
+#include "short_dribble_generator.h"
+#include "self_pass_generator.h"
+#include "clear_generator.h"
+#include "dash_trajectory_table.h"
+#include "ball_kinematics.h"
+#include "opponent_reach_table.h"
+#include "player_state_fusion.h"
+#include "course_pregenerator.h"
+#include "actgen_direct_pass_speed-inl.h"
+#include "fuzzy_offensive_pos_eval-inl.h"
 
 #include "soccer_role.h"
 
 #include "sample_communication.h"
 #include "keepaway_communication.h"
+#include "packed_say_message.h"
 
 #include "bhv_penalty_kick.h"
 #include "bhv_set_play.h"
@@ -79,6 +95,7 @@
 
 #include <rcsc/param/param_map.h>
 #include <rcsc/param/cmd_line_parser.h>
+#include <rcsc/param/conf_file_parser.h>
 
 #include <iostream>
 #include <sstream>
@@ -94,6 +111,7 @@ using namespace rcsc;
 SamplePlayer::SamplePlayer()
     : PlayerAgent(),
       M_communication(),
+      M_use_static_action_generator( true ),
       M_field_evaluator( createFieldEvaluator() ),
       M_action_generator( createActionGenerator() )
 {
@@ -124,6 +142,7 @@ SamplePlayer::SamplePlayer()
     addSayMessageParser( SayMessageParser::Ptr( new BallPlayerMessageParser( audio_memory ) ) );
     addSayMessageParser( SayMessageParser::Ptr( new StaminaMessageParser( audio_memory ) ) );
     addSayMessageParser( SayMessageParser::Ptr( new RecoveryMessageParser( audio_memory ) ) );
+    addSayMessageParser( SayMessageParser::Ptr( new PackedObjectMessageParser( audio_memory ) ) );
 
     // addSayMessageParser( SayMessageParser::Ptr( new FreeMessageParser< 9 >( audio_memory ) ) );
     // addSayMessageParser( SayMessageParser::Ptr( new FreeMessageParser< 8 >( audio_memory ) ) );
@@ -172,18 +191,90 @@ SamplePlayer::initImpl( CmdLineParser & cmd_parser )
     // read additional options
     result &= Strategy::instance().init( cmd_parser );
 
+    bool speculative_pass = true;
+    int pregeneration_threads = 2;
+    std::string budget_config_file;
+    bool static_action_generator = true;
+    std::string shared_segment;
+
     rcsc::ParamMap my_params( "Additional options" );
 #if 0
     std::string param_file_path = "params";
     param_map.add()
         ( "param-file", "", &param_file_path, "specified parameter file" );
 #endif
+    my_params.add()
+        ( "speculative_pass", "", &speculative_pass,
+          "precompute pass courses for the next passer in the idle time." )
+        ( "pregeneration_threads", "", &pregeneration_threads,
+          "the number of threads to generate the action courses concurrently. 0 disables the concurrent generation." )
+        ( "generator_budget_config", "", &budget_config_file,
+          "the configuration file that contains the search budgets of the action generators. (e.g. player.conf)" )
+        ( "static_action_generator", "", &static_action_generator,
+          "use the compile-time composed action generator. if off, the runtime composite generator is used." )
+        ( "shared_segment", "", &shared_segment,
+          "the name of the shared memory segment of the read-only tables (formations, fuzzy lookup tables). the first agent on the host creates it and the other agents attach it. empty disables the sharing." );
 
     cmd_parser.parse( my_params );
 
+    //
+    // search budgets of the action generators.
+    // *_msec is the time limit [ms] and *_count is the work limit.
+    // zero or a negative value means unlimited.
+    //
+    double pass_budget_msec = 0.0;
+    int pass_budget_count = 0;
+    double cross_budget_msec = 0.0;
+    int cross_budget_count = 0;
+    double shoot_budget_msec = 0.0;
+    int shoot_budget_count = 0;
+    double short_dribble_budget_msec = 0.0;
+    int short_dribble_budget_count = 0;
+    double self_pass_budget_msec = 0.0;
+    int self_pass_budget_count = 0;
+    double clear_budget_msec = 0.0;
+    int clear_budget_count = 0;
+
+    rcsc::ParamMap budget_params( "Generator budget options" );
+    budget_params.add()
+        ( "pass_budget_msec", "", &pass_budget_msec,
+          "the time limit of the pass generator [ms]." )
+        ( "pass_budget_count", "", &pass_budget_count,
+          "the maximum number of the receive points checked by the pass generator." )
+        ( "cross_budget_msec", "", &cross_budget_msec,
+          "the time limit of the cross generator [ms]." )
+        ( "cross_budget_count", "", &cross_budget_count,
+          "the maximum number of the receive points checked by the cross generator." )
+        ( "shoot_budget_msec", "", &shoot_budget_msec,
+          "the time limit of the shoot generator [ms]." )
+        ( "shoot_budget_count", "", &shoot_budget_count,
+          "the maximum number of the target points checked by the shoot generator." )
+        ( "short_dribble_budget_msec", "", &short_dribble_budget_msec,
+          "the time limit of the short dribble generator [ms]." )
+        ( "short_dribble_budget_count", "", &short_dribble_budget_count,
+          "the maximum number of the dash directions checked by the short dribble generator." )
+        ( "self_pass_budget_msec", "", &self_pass_budget_msec,
+          "the time limit of the self pass generator [ms]." )
+        ( "self_pass_budget_count", "", &self_pass_budget_count,
+          "the maximum number of the dash directions checked by the self pass generator." )
+        ( "clear_budget_msec", "", &clear_budget_msec,
+          "the time limit of the clear generator [ms]." )
+        ( "clear_budget_count", "", &clear_budget_count,
+          "the maximum number of the clear angles checked by the clear generator." );
+
+    if ( ! budget_config_file.empty() )
+    {
+        rcsc::ConfFileParser conf_parser( budget_config_file.c_str() );
+        conf_parser.parse( budget_params );
+    }
+
+    // the command line options have priority over the configuration file.
+    cmd_parser.parse( budget_params );
+
     if ( cmd_parser.count( "help" ) > 0 )
     {
         my_params.printHelp( std::cout );
+        budget_params.printHelp( std::cout );
         return false;
     }
 
@@ -199,6 +290,43 @@ SamplePlayer::initImpl( CmdLineParser & cmd_parser )
         return false;
     }
 
+    StrictCheckPassGenerator::instance().setSpeculationEnabled( speculative_pass );
+
+    //
+    // the action generator is stateless. it is created only once.
+    //
+    M_use_static_action_generator = static_action_generator;
+    M_action_generator = createActionGenerator();
+
+    StrictCheckPassGenerator::instance().setBudget( pass_budget_msec, pass_budget_count );
+    CrossGenerator::instance().setBudget( cross_budget_msec, cross_budget_count );
+    ShootGenerator::instance().setBudget( shoot_budget_msec, shoot_budget_count );
+    ShortDribbleGenerator::instance().setBudget( short_dribble_budget_msec, short_dribble_budget_count );
+    SelfPassGenerator::instance().setBudget( self_pass_budget_msec, self_pass_budget_count );
+    ClearGenerator::instance().setBudget( clear_budget_msec, clear_budget_count );
+
+    if ( ! CoursePregenerator::instance().startThreads( pregeneration_threads ) )
+    {
+        std::cerr << "***WARNING*** Failed to start the course generation threads."
+                  << std::endl;
+    }
+
+    //
+    // the startup tables are published to or read from the shared segment.
+    //
+    if ( ! shared_segment.empty() )
+    {
+        static const int SHARED_SEGMENT_WAIT_MSEC = 10 * 1000; // Magic Number
+
+        if ( ! SharedTableSegment::instance().open( shared_segment,
+                                                    SHARED_SEGMENT_WAIT_MSEC ) )
+        {
+            std::cerr << "***WARNING*** Failed to open the shared segment ["
+                      << shared_segment << "]. the tables are built privately."
+                      << std::endl;
+        }
+    }
+
     if ( ! Strategy::instance().read( config().configDir() ) )
     {
         std::cerr << "***ERROR*** Failed to read team strategy." << std::endl;
@@ -212,6 +340,33 @@ SamplePlayer::initImpl( CmdLineParser & cmd_parser )
                   << std::endl;
     }
 
+    //
+    // compile the fuzzy controllers into the lookup tables.
+    // the live controllers are used if the tables are not accurate enough.
+    //
+    if ( ! ActGen_DirectPassSpeed::isLookupTableEnabled() )
+    {
+        std::cerr << "***WARNING*** Disabled the direct pass speed lookup table. error="
+                  << ActGen_DirectPassSpeed::getLookupTableError()
+                  << std::endl;
+    }
+
+    if ( ! FuzzyOffensivePosEval::isLookupTableEnabled() )
+    {
+        std::cerr << "***WARNING*** Disabled the offensive position lookup table. error="
+                  << FuzzyOffensivePosEval::getLookupTableError()
+                  << std::endl;
+    }
+
+    if ( SharedTableSegment::i().isOwner() )
+    {
+        SharedTableSegment::instance().setReady();
+        std::cerr << "Created the shared segment ["
+                  << SharedTableSegment::i().name() << "] "
+                  << SharedTableSegment::i().usedSize() << " bytes"
+                  << std::endl;
+    }
+
     return true;
 }
 
@@ -228,12 +383,21 @@ SamplePlayer::actionImpl()
     //
     Strategy::instance().update( world() );
     FieldAnalyzer::instance().update( world() );
+    MarkingPlanner::instance().update( world() );
+    BallKinematics::instance().update( world() );
+    PlayerStateFusion::instance().update( world() );
+    OpponentReachTable::instance().update( world() );
+
+    //
+    // generate the courses of all generators concurrently.
+    // all generators have finished when this returns.
+    //
+    CoursePregenerator::instance().run( world() );
 
     //
     // prepare action chain
     //
     M_field_evaluator = createFieldEvaluator();
-    M_action_generator = createActionGenerator();
 
     ActionChainHolder::instance().setFieldEvaluator( M_field_evaluator );
     ActionChainHolder::instance().setActionGenerator( M_action_generator );
@@ -327,6 +491,11 @@ SamplePlayer::handleActionStart()
 void
 SamplePlayer::handleActionEnd()
 {
+    //
+    // the command has been sent. use the idle time until the next message.
+    //
+    StrictCheckPassGenerator::instance().speculate( world() );
+
     if ( world().self().posValid() )
     {
 #if 0
@@ -459,6 +628,13 @@ SamplePlayer::handleServerParam()
         M_client->setServerAlive( false );
     }
 
+    if ( ! BallKinematics::instance().createTables() )
+    {
+        std::cerr << world().teamName() << ' '
+                  << world().self().unum() << ": "
+                  << " BallKinematics failed..."
+                  << std::endl;
+    }
 
     if ( ServerParam::i().keepawayMode() )
     {
@@ -484,7 +660,7 @@ SamplePlayer::handlePlayerParam()
 void
 SamplePlayer::handlePlayerType()
 {
-
+    DashTrajectoryTable::instance().create();
 }
 
 /*-------------------------------------------------------------------*/
@@ -768,15 +944,40 @@ SamplePlayer::createFieldEvaluator() const
 #include "actgen_cross.h"
 #include "actgen_direct_pass.h"
 #include "actgen_self_pass.h"
+#include "actgen_state_pass.h"
 #include "actgen_strict_check_pass.h"
 #include "actgen_short_dribble.h"
 #include "actgen_simple_dribble.h"
 #include "actgen_shoot.h"
 #include "actgen_action_chain_length_filter.h"
+#include "actgen_static_pipeline.h"
+
+namespace {
+
+/*!
+  \brief compile-time composed version of the runtime composite generator
+  created in SamplePlayer::createActionGenerator().
+  Both lists must be kept in the same order.
+ */
+typedef ActGen_StaticComposite<
+    ActGen_StaticRangeFilter< ActGen_Shoot, 2, ActGen_RangeActionChainLengthFilter::MAX >, // shoot
+    ActGen_StaticMaxFilter< ActGen_StrictCheckPass, 1 >, // strict check pass
+    ActGen_StaticMaxFilter< ActGen_Cross, 1 >, // cross
+    ActGen_StaticRangeFilter< ActGen_StatePass, 2, 3 >, // pass on the predicted state
+    ActGen_StaticMaxFilter< ActGen_ShortDribble, 1 >, // short dribble
+    ActGen_StaticMaxFilter< ActGen_SelfPass, 1 > // self pass (long dribble)
+    > SampleActionGenerator;
+
+}
 
 ActionGenerator::ConstPtr
 SamplePlayer::createActionGenerator() const
 {
+    if ( M_use_static_action_generator )
+    {
+        return ActionGenerator::ConstPtr( new SampleActionGenerator() );
+    }
+
     CompositeActionGenerator * g = new CompositeActionGenerator();
 
     //
@@ -805,6 +1006,13 @@ SamplePlayer::createActionGenerator() const
     //                  ( new ActGen_DirectPass(),
     //                    2, ActGen_RangeActionChainLengthFilter::MAX ) );
 
+    //
+    // pass on the predicted state (2nd and 3rd actions)
+    //
+    g->addGenerator( new ActGen_RangeActionChainLengthFilter
+                     ( new ActGen_StatePass(),
+                       2, 3 ) );
+
     //
     // short dribble
     //
@@ -40,6 +40,9 @@ private:
 
     Communication::Ptr M_communication;
 
+    //! if true, createActionGenerator() returns the compile-time composed generator
+    bool M_use_static_action_generator;
+
     FieldEvaluator::ConstPtr M_field_evaluator;
     ActionGenerator::ConstPtr M_action_generator;
 
@@ -0,0 +1,582 @@
+// -*-c++-*-
+
+/*!
+  \file shared_table_segment.cpp
+  \brief named shared memory segment of read-only tables Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "shared_table_segment.h"
+
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+
+const std::size_t SharedTableSegment::CAPACITY = 64 * 1024 * 1024;
+
+/*!
+  \brief directory entry of the published block.
+ */
+struct SharedTableSegment::Block {
+    char key_[KEY_SIZE];
+    boost::uint64_t offset_; //!< from the head of the segment
+    boost::uint64_t size_;
+};
+
+/*!
+  \brief segment header. the owner writes magic_ last.
+ */
+struct SharedTableSegment::Header {
+    char magic_[8];
+    boost::uint32_t byte_order_;
+    boost::uint32_t version_;
+    boost::uint64_t exe_size_; //!< size of the owner's executable
+    boost::int64_t exe_mtime_; //!< modification time of the owner's executable
+    boost::int32_t owner_pid_;
+    volatile boost::int32_t ready_; //!< 1 after the startup tables are published
+    volatile boost::int32_t block_count_; //!< the number of the published blocks
+    boost::int32_t padding_;
+    boost::uint64_t used_; //!< end of the last block
+    Block blocks_[MAX_BLOCKS];
+};
+
+namespace {
+
+const char MAGIC[8] = { 'A', '2', 'D', 'S', 'H', 'M', '\0', '\0' };
+const boost::uint32_t BYTE_ORDER_MARK = 0x01020304;
+const boost::uint32_t FORMAT_VERSION = 1;
+
+//! block alignment (cache line size)
+const boost::uint64_t BLOCK_ALIGN = 64;
+
+//! polling interval while waiting for the owner [us]
+const int POLL_USEC = 10 * 1000;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+boost::uint64_t
+align_block( const boost::uint64_t size )
+{
+    return ( size + BLOCK_ALIGN - 1 ) & ~( BLOCK_ALIGN - 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the process does not exist.
+ */
+inline
+bool
+is_dead( const boost::int32_t pid )
+{
+    return ( ::kill( static_cast< pid_t >( pid ), 0 ) != 0
+             && errno == ESRCH );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief unlink the named segment if it is still the checked one.
+  another agent may already have replaced it with a new segment.
+ */
+void
+remove_segment( const std::string & shm_name,
+                const ino_t ino )
+{
+    int fd = ::shm_open( shm_name.c_str(), O_RDONLY, 0 );
+    if ( fd < 0 )
+    {
+        return;
+    }
+
+    struct stat st;
+    const bool same = ( ::fstat( fd, &st ) == 0
+                        && st.st_ino == ino );
+    ::close( fd );
+
+    if ( same )
+    {
+        ::shm_unlink( shm_name.c_str() );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the identity of the running executable.
+ */
+void
+get_exe_identity( boost::uint64_t * size,
+                  boost::int64_t * mtime )
+{
+    struct stat st;
+    if ( ::stat( "/proc/self/exe", &st ) == 0 )
+    {
+        *size = static_cast< boost::uint64_t >( st.st_size );
+        *mtime = static_cast< boost::int64_t >( st.st_mtime );
+    }
+    else
+    {
+        *size = 0;
+        *mtime = 0;
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SharedTableSegment::SharedTableSegment()
+    : M_addr( static_cast< void * >( 0 ) ),
+      M_size( 0 ),
+      M_owner( false )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SharedTableSegment::~SharedTableSegment()
+{
+    // the segment itself is kept for the other agents and the next match.
+    if ( M_addr )
+    {
+        ::munmap( M_addr, M_size );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SharedTableSegment &
+SharedTableSegment::instance()
+{
+    static SharedTableSegment s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const SharedTableSegment::Header *
+SharedTableSegment::header() const
+{
+    return static_cast< const Header * >( M_addr );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SharedTableSegment::open( const std::string & name,
+                          const int wait_msec )
+{
+    if ( M_addr
+         || name.empty() )
+    {
+        return false;
+    }
+
+    const std::string shm_name = '/' + name;
+
+    boost::uint64_t exe_size = 0;
+    boost::int64_t exe_mtime = 0;
+    get_exe_identity( &exe_size, &exe_mtime );
+
+    //
+    // a stale segment is removed once, and this agent tries to become
+    // the owner of a new one.
+    //
+    for ( int retry = 0; retry < 2; ++retry )
+    {
+        if ( create( shm_name, exe_size, exe_mtime ) )
+        {
+            M_name = name;
+            return true;
+        }
+
+        if ( errno != EEXIST )
+        {
+            std::cerr << "shared segment [" << name << "]: failed to create. "
+                      << std::strerror( errno ) << std::endl;
+            return false;
+        }
+
+        const OpenResult result = attach( shm_name, wait_msec, exe_size, exe_mtime );
+        if ( result == OPEN_OK )
+        {
+            M_name = name;
+            return true;
+        }
+
+        if ( result == OPEN_FAILED )
+        {
+            return false;
+        }
+
+        std::cerr << "shared segment [" << name << "]: removed the stale segment."
+                  << std::endl;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SharedTableSegment::create( const std::string & shm_name,
+                            const boost::uint64_t exe_size,
+                            const boost::int64_t exe_mtime )
+{
+    int fd = ::shm_open( shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644 );
+    if ( fd < 0 )
+    {
+        return false;
+    }
+
+    if ( ::ftruncate( fd, static_cast< off_t >( CAPACITY ) ) != 0 )
+    {
+        std::cerr << "shared segment [" << shm_name << "]: failed to resize. "
+                  << std::strerror( errno ) << std::endl;
+        ::close( fd );
+        ::shm_unlink( shm_name.c_str() );
+        errno = 0;
+        return false;
+    }
+
+    void * addr = ::mmap( 0, CAPACITY, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+
+    if ( addr == MAP_FAILED )
+    {
+        ::shm_unlink( shm_name.c_str() );
+        errno = 0;
+        return false;
+    }
+
+    // the pages of a new segment are zero filled.
+    Header * h = static_cast< Header * >( addr );
+    h->byte_order_ = BYTE_ORDER_MARK;
+    h->version_ = FORMAT_VERSION;
+    h->exe_size_ = exe_size;
+    h->exe_mtime_ = exe_mtime;
+    h->owner_pid_ = static_cast< boost::int32_t >( ::getpid() );
+    h->ready_ = 0;
+    h->block_count_ = 0;
+    h->used_ = align_block( sizeof( Header ) );
+    __sync_synchronize();
+    std::memcpy( h->magic_, MAGIC, sizeof( MAGIC ) );
+
+    M_addr = addr;
+    M_size = CAPACITY;
+    M_owner = true;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SharedTableSegment::OpenResult
+SharedTableSegment::attach( const std::string & shm_name,
+                            const int wait_msec,
+                            const boost::uint64_t exe_size,
+                            const boost::int64_t exe_mtime )
+{
+    int fd = ::shm_open( shm_name.c_str(), O_RDONLY, 0 );
+    if ( fd < 0 )
+    {
+        // removed by another agent. try to create it again.
+        return ( errno == ENOENT ? OPEN_STALE : OPEN_FAILED );
+    }
+
+    // the owner may not have resized the segment yet.
+    struct stat st;
+    int waited = 0;
+    while ( ::fstat( fd, &st ) == 0
+            && st.st_size < static_cast< off_t >( CAPACITY )
+            && waited < wait_msec )
+    {
+        ::usleep( POLL_USEC );
+        waited += POLL_USEC / 1000;
+    }
+
+    if ( st.st_size < static_cast< off_t >( CAPACITY ) )
+    {
+        // the creator has died before resizing it.
+        ::close( fd );
+        remove_segment( shm_name, st.st_ino );
+        return OPEN_STALE;
+    }
+
+    void * addr = ::mmap( 0, CAPACITY, PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+
+    if ( addr == MAP_FAILED )
+    {
+        return OPEN_FAILED;
+    }
+
+    M_addr = addr;
+    M_size = CAPACITY;
+    M_owner = false;
+
+    OpenResult result = OPEN_OK;
+
+    const Header * h = header();
+    while ( std::memcmp( h->magic_, MAGIC, sizeof( MAGIC ) ) != 0
+            && waited < wait_msec )
+    {
+        ::usleep( POLL_USEC );
+        waited += POLL_USEC / 1000;
+    }
+    __sync_synchronize();
+
+    if ( std::memcmp( h->magic_, MAGIC, sizeof( MAGIC ) ) != 0 )
+    {
+        // the creator has died before writing the header.
+        result = OPEN_STALE;
+    }
+    else if ( h->byte_order_ != BYTE_ORDER_MARK
+              || h->version_ != FORMAT_VERSION
+              || h->exe_size_ != exe_size
+              || h->exe_mtime_ != exe_mtime )
+    {
+        if ( is_dead( h->owner_pid_ ) )
+        {
+            // the agents still attached keep their mapping.
+            result = OPEN_STALE;
+        }
+        else
+        {
+            std::cerr << "shared segment [" << shm_name << "]: used by another build."
+                      << std::endl;
+            result = OPEN_FAILED;
+        }
+    }
+    else
+    {
+        result = waitReady( wait_msec - waited );
+        if ( result == OPEN_FAILED )
+        {
+            std::cerr << "shared segment [" << shm_name << "]: the owner is not ready."
+                      << std::endl;
+        }
+    }
+
+    if ( result != OPEN_OK )
+    {
+        ::munmap( M_addr, M_size );
+        M_addr = static_cast< void * >( 0 );
+        M_size = 0;
+
+        if ( result == OPEN_STALE )
+        {
+            remove_segment( shm_name, st.st_ino );
+        }
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SharedTableSegment::OpenResult
+SharedTableSegment::waitReady( const int wait_msec ) const
+{
+    const Header * h = header();
+
+    int waited = 0;
+    while ( ! h->ready_ )
+    {
+        // the owner has died before publishing the startup tables.
+        if ( is_dead( h->owner_pid_ ) )
+        {
+            return OPEN_STALE;
+        }
+
+        if ( waited >= wait_msec )
+        {
+            return OPEN_FAILED;
+        }
+
+        ::usleep( POLL_USEC );
+        waited += POLL_USEC / 1000;
+    }
+
+    __sync_synchronize();
+    return OPEN_OK;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const void *
+SharedTableSegment::find( const std::string & key,
+                          std::size_t * size ) const
+{
+    if ( ! M_addr )
+    {
+        return static_cast< const void * >( 0 );
+    }
+
+    const Header * h = header();
+
+    const int count = h->block_count_;
+    __sync_synchronize();
+
+    for ( int i = 0; i < count && i < MAX_BLOCKS; ++i )
+    {
+        const Block & b = h->blocks_[i];
+        if ( key.compare( 0, KEY_SIZE, b.key_ ) == 0 )
+        {
+            if ( b.offset_ + b.size_ > M_size )
+            {
+                return static_cast< const void * >( 0 );
+            }
+
+            if ( size ) *size = static_cast< std::size_t >( b.size_ );
+            return static_cast< const char * >( M_addr ) + b.offset_;
+        }
+    }
+
+    return static_cast< const void * >( 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const void *
+SharedTableSegment::publish( const std::string & key,
+                             const void * data,
+                             const std::size_t size )
+{
+    if ( ! M_owner
+         || key.length() >= static_cast< std::size_t >( KEY_SIZE ) )
+    {
+        return static_cast< const void * >( 0 );
+    }
+
+    std::size_t found_size = 0;
+    const void * found = find( key, &found_size );
+    if ( found )
+    {
+        return ( found_size == size ? found : static_cast< const void * >( 0 ) );
+    }
+
+    Header * h = static_cast< Header * >( M_addr );
+
+    const boost::uint64_t offset = align_block( h->used_ );
+    if ( h->block_count_ >= MAX_BLOCKS
+         || offset + size > M_size )
+    {
+        std::cerr << "shared segment [" << M_name << "]: no space for ["
+                  << key << "] size=" << size << std::endl;
+        return static_cast< const void * >( 0 );
+    }
+
+    char * dst = static_cast< char * >( M_addr ) + offset;
+    std::memcpy( dst, data, size );
+
+    Block & b = h->blocks_[h->block_count_];
+    std::memset( b.key_, 0, KEY_SIZE );
+    std::strncpy( b.key_, key.c_str(), KEY_SIZE - 1 );
+    b.offset_ = offset;
+    b.size_ = size;
+    h->used_ = offset + size;
+
+    // the block becomes visible after its content.
+    __sync_synchronize();
+    h->block_count_ = h->block_count_ + 1;
+
+    return dst;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SharedTableSegment::setReady()
+{
+    if ( M_owner )
+    {
+        __sync_synchronize();
+        static_cast< Header * >( M_addr )->ready_ = 1;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+SharedTableSegment::usedSize() const
+{
+    return ( M_addr
+             ? static_cast< std::size_t >( header()->used_ )
+             : 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::string
+SharedTableSegment::make_key( const char * kind,
+                              const boost::uint64_t value )
+{
+    char buf[KEY_SIZE];
+    std::snprintf( buf, KEY_SIZE, "%.32s/%016llx",
+                   kind, static_cast< unsigned long long >( value ) );
+    return std::string( buf );
+}
@@ -0,0 +1,211 @@
+// -*-c++-*-
+
+/*!
+  \file shared_table_segment.h
+  \brief named shared memory segment of read-only tables Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) robOTTO team
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifndef SHARED_TABLE_SEGMENT_H
+#define SHARED_TABLE_SEGMENT_H
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <cstddef>
+
+/*!
+  \class SharedTableSegment
+  \brief named POSIX shared memory segment that holds read-only tables
+  built at startup (compiled formations, baked formation grids and fuzzy
+  lookup tables) for all agents on the same host.
+
+  The first agent that opens the segment becomes its owner. The owner
+  publishes each table as a byte block under a key, and calls
+  setReady() when all startup tables have been published. The other
+  agents map the segment read-only, wait for the owner to become ready
+  and use the published blocks directly instead of building private
+  copies. A block that is not found is built privately as before.
+
+  Blocks are addressed by offsets only, so the segment may be mapped at
+  a different address in each process. Every block is 64 byte aligned.
+  Keys have to contain everything the block content depends on
+  (e.g. the checksum of the source file). The segment also records the
+  executable identity, and an agent of a different build does not use it.
+
+  The segment is not removed when the agents exit, so that the next
+  match on the same host can reuse it. The owner's pid is recorded. A
+  segment whose owner has died before it became ready (or one of another
+  build whose owner has exited) is unlinked and created again by the
+  next agent. Remove /dev/shm/<name> to reset it by hand.
+ */
+class SharedTableSegment {
+public:
+
+    //! max length of the block key (including the terminating null)
+    static const int KEY_SIZE = 56;
+    //! max number of the blocks
+    static const int MAX_BLOCKS = 128;
+
+    //! reserved size of the segment. pages are allocated on the first write.
+    static const std::size_t CAPACITY;
+
+private:
+
+    struct Header;
+    struct Block;
+
+    enum OpenResult {
+        OPEN_OK,
+        OPEN_FAILED,
+        OPEN_STALE //!< the segment has been left by a dead owner
+    };
+
+    std::string M_name;
+    void * M_addr;
+    std::size_t M_size;
+    bool M_owner;
+
+    // private for singleton
+    SharedTableSegment();
+
+    // not used
+    SharedTableSegment( const SharedTableSegment & );
+    SharedTableSegment & operator=( const SharedTableSegment & );
+
+public:
+
+    ~SharedTableSegment();
+
+    static
+    SharedTableSegment & instance();
+
+    static
+    const SharedTableSegment & i()
+      {
+          return instance();
+      }
+
+    /*!
+      \brief create or attach the named segment. an attached agent waits
+      until the owner has published the startup tables.
+      \param name segment name (without the leading '/')
+      \param wait_msec max waiting time for the owner [ms]
+      \return false if the segment can not be used. the agent builds
+      all tables privately in this case.
+     */
+    bool open( const std::string & name,
+               const int wait_msec );
+
+    /*!
+      \brief check if the segment is available.
+     */
+    bool isOpen() const
+      {
+          return M_addr != static_cast< void * >( 0 );
+      }
+
+    /*!
+      \brief check if this agent has created the segment.
+     */
+    bool isOwner() const
+      {
+          return M_owner;
+      }
+
+    const std::string & name() const
+      {
+          return M_name;
+      }
+
+    /*!
+      \brief find the published block.
+      \param key block key
+      \param size variable to store the block size (may be NULL)
+      \return head of the block or NULL
+     */
+    const void * find( const std::string & key,
+                       std::size_t * size ) const;
+
+    /*!
+      \brief copy the data into the segment. only the owner can publish.
+      \param key block key
+      \param data source data
+      \param size data size
+      \return head of the published block or NULL
+     */
+    const void * publish( const std::string & key,
+                          const void * data,
+                          const std::size_t size );
+
+    /*!
+      \brief notify the attached agents that all startup tables have
+      been published. called only by the owner.
+     */
+    void setReady();
+
+    /*!
+      \brief get the total size of the published blocks.
+     */
+    std::size_t usedSize() const;
+
+    /*!
+      \brief make the key string of the block.
+      \param kind block kind name
+      \param value 64 bit value that identifies the content
+      \return key string
+     */
+    static
+    std::string make_key( const char * kind,
+                          const boost::uint64_t value );
+
+private:
+
+    const Header * header() const;
+
+    /*!
+      \brief create the new segment and become its owner.
+      \return false if the segment already exists (errno == EEXIST) or
+      can not be created.
+     */
+    bool create( const std::string & shm_name,
+                 const boost::uint64_t exe_size,
+                 const boost::int64_t exe_mtime );
+
+    /*!
+      \brief map the existing segment read-only and wait for its owner.
+      a stale segment is unlinked before OPEN_STALE is returned.
+     */
+    OpenResult attach( const std::string & shm_name,
+                       const int wait_msec,
+                       const boost::uint64_t exe_size,
+                       const boost::int64_t exe_mtime );
+
+    OpenResult waitReady( const int wait_msec ) const;
+};
+
+#endif
@@ -23,6 +23,7 @@ DIR=`dirname $0`
 
 player="${DIR}/sample_player"
 coach="${DIR}/sample_coach"
+formation_compiler="${DIR}/formation_compiler"
 teamname="robOTTO" #"HELIOS_base"
 host="localhost"
 port=6000
@@ -32,6 +33,7 @@ debug_server_port=""
 
 player_conf="${DIR}/player.conf"
 config_dir="${DIR}/formations-dt"
+shared_segment=""
 
 coach_conf="${DIR}/coach.conf"
 team_graphic="--use_team_graphic off"
@@ -65,6 +67,8 @@ usage()
    echo "  -u, --unum UNUM              specifies the uniform number of players"
    echo "  -C, --without-coach          specifies not to run the coach"
    echo "  -f, --formation DIR          specifies the formation directory"
+   echo "  --shared-segment NAME        shares the read-only tables of the players"
+   echo "                               through the shared memory segment NAME"
    echo "  --team-graphic FILE          specifies the team graphic xpm file"
    echo "  --offline-logging            writes offline client log (default: off)"
    echo "  --offline-client-mode        starts as an offline client (default: off)"
@@ -155,6 +159,15 @@ do
       shift 1
       ;;
 
+    --shared-segment)
+      if [ $# -lt 2 ]; then
+        usage
+        exit 1
+      fi
+      shared_segment="${2}"
+      shift 1
+      ;;
+
     --team-graphic)
       if [ $# -lt 2 ]; then
         usage
@@ -281,6 +294,7 @@ if [ X"${debug_server_port}" = X'' ]; then
 fi
 
 opt="--player-config ${player_conf} --config_dir ${config_dir}"
+opt="${opt} --generator_budget_config ${player_conf}"
 opt="${opt} -h ${host} -p ${port} -t ${teamname}"
 opt="${opt} ${fullstateopt}"
 opt="${opt} --debug_server_host ${debug_server_host}"
@@ -288,6 +302,16 @@ opt="${opt} --debug_server_port ${debug_server_port}"
 opt="${opt} ${offline_logging}"
 opt="${opt} ${debugopt}"
 
+if [ X"${shared_segment}" != X'' ]; then
+  opt="${opt} --shared_segment ${shared_segment}"
+fi
+
+# update the compiled formation cache once for all players.
+# the players fall back to the text files if this fails.
+if [ -x "${formation_compiler}" ]; then
+  ${formation_compiler} ${config_dir}/*.conf > /dev/null
+fi
+
 ping -c 1 $host
 
 if [ $number -gt 0 ]; then
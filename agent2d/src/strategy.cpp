@@ -36,6 +36,7 @@
 #include "strategy.h"
 
 #include "soccer_role.h"
+#include "shared_table_segment.h"
 
 
 #ifndef USE_GENERIC_FACTORY
@@ -93,7 +94,12 @@ const std::string Strategy::INDIRECT_FREEKICK_OUR_FORMATION_CONF = "indirect-fre
 
  */
 Strategy::Strategy()
-    : M_goalie_unum( Unum_Unknown ),
+    : M_use_formation_cache( true ),
+      M_formation_grid_step( 0.0 ),
+      M_formation_full_check( false ),
+      M_prefetch_requested( false ),
+      M_prefetch_running( false ),
+      M_goalie_unum( Unum_Unknown ),
       M_current_situation( Normal_Situation ),
       M_role_number( 11, 0 ),
       M_position_types( 11, Position_Center ),
@@ -131,6 +137,29 @@ Strategy::Strategy()
     {
         M_role_number[i] = i + 1;
     }
+
+    for ( int i = 0; i < FormationType_Size; ++i )
+    {
+        M_formation_state[i] = Formation_NotLoaded;
+    }
+
+    pthread_mutex_init( &M_formation_mutex, NULL );
+    pthread_cond_init( &M_formation_cond, NULL );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Strategy::~Strategy()
+{
+    if ( M_prefetch_running )
+    {
+        pthread_join( M_prefetch_thread, NULL );
+    }
+
+    pthread_cond_destroy( &M_formation_cond );
+    pthread_mutex_destroy( &M_formation_mutex );
 }
 
 /*-------------------------------------------------------------------*/
@@ -157,6 +186,16 @@ Strategy::init( CmdLineParser & cmd_parser )
     //param_map.add()
     //    ( "fconf", "", &fconf, "another formation file." );
 
+    param_map.add()
+        ( "formation_cache", "", &M_use_formation_cache,
+          "map the compiled formation cache (*.conf.bin) if it is up to date. the cache files are created by formation_compiler." );
+    param_map.add()
+        ( "formation_grid_step", "", &M_formation_grid_step,
+          "if positive, bake the home positions into the grid of this interval and use the bilinear interpolation. check the error by formation_compiler -g." );
+    param_map.add()
+        ( "formation_full_check", "", &M_formation_full_check,
+          "read and check all formations at startup. if off, only the before-kick-off formation is read at startup, and the others are read when they are used first or by the background thread after kick-off." );
+
     //
     //
     //
@@ -199,97 +238,135 @@ Strategy::read( const std::string & formation_dir )
         configpath += '/';
     }
 
-    // before kick off
-    M_before_kick_off_formation = readFormation( configpath + BEFORE_KICK_OFF_CONF );
-    if ( ! M_before_kick_off_formation )
-    {
-        std::cerr << "Failed to read before_kick_off formation" << std::endl;
-        return false;
-    }
+    M_formation_path[BeforeKickOff_Formation] = configpath + BEFORE_KICK_OFF_CONF;
+    M_formation_path[Normal_Formation] = configpath + NORMAL_FORMATION_CONF;
+    M_formation_path[Defense_Formation] = configpath + DEFENSE_FORMATION_CONF;
+    M_formation_path[Offense_Formation] = configpath + OFFENSE_FORMATION_CONF;
+    M_formation_path[GoalKickOpp_Formation] = configpath + GOAL_KICK_OPP_FORMATION_CONF;
+    M_formation_path[GoalKickOur_Formation] = configpath + GOAL_KICK_OUR_FORMATION_CONF;
+    M_formation_path[GoalieCatchOpp_Formation] = configpath + GOALIE_CATCH_OPP_FORMATION_CONF;
+    M_formation_path[GoalieCatchOur_Formation] = configpath + GOALIE_CATCH_OUR_FORMATION_CONF;
+    M_formation_path[KickInOur_Formation] = configpath + KICKIN_OUR_FORMATION_CONF;
+    M_formation_path[SetPlayOpp_Formation] = configpath + SETPLAY_OPP_FORMATION_CONF;
+    M_formation_path[SetPlayOur_Formation] = configpath + SETPLAY_OUR_FORMATION_CONF;
+    M_formation_path[IndirectFreeKickOpp_Formation] = configpath + INDIRECT_FREEKICK_OPP_FORMATION_CONF;
+    M_formation_path[IndirectFreeKickOur_Formation] = configpath + INDIRECT_FREEKICK_OUR_FORMATION_CONF;
 
-    ///////////////////////////////////////////////////////////
-    M_normal_formation = readFormation( configpath + NORMAL_FORMATION_CONF );
-    if ( ! M_normal_formation )
-    {
-        std::cerr << "Failed to read normal formation" << std::endl;
-        return false;
-    }
+    //
+    // the before-kick-off formation is always read at startup.
+    // the owner of the shared segment publishes all formations for the other agents.
+    //
+    const bool read_all = ( M_formation_full_check
+                            || SharedTableSegment::i().isOwner() );
 
-    M_defense_formation = readFormation( configpath + DEFENSE_FORMATION_CONF );
-    if ( ! M_defense_formation )
+    for ( int i = 0; i < FormationType_Size; ++i )
     {
-        std::cerr << "Failed to read defense formation" << std::endl;
-        return false;
-    }
+        const FormationType type = static_cast< FormationType >( i );
 
-    M_offense_formation = readFormation( configpath + OFFENSE_FORMATION_CONF );
-    if ( ! M_offense_formation )
-    {
-        std::cerr << "Failed to read offense formation" << std::endl;
-        return false;
+        if ( read_all
+             || type == BeforeKickOff_Formation )
+        {
+            if ( ! loadFormation( type ) )
+            {
+                std::cerr << "Failed to read formation [" << M_formation_path[i] << "]"
+                          << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::ifstream fin( M_formation_path[i].c_str() );
+            if ( ! fin.is_open() )
+            {
+                std::cerr << "Failed to open formation [" << M_formation_path[i] << "]"
+                          << std::endl;
+                return false;
+            }
+        }
     }
 
-    M_goal_kick_opp_formation = readFormation( configpath + GOAL_KICK_OPP_FORMATION_CONF );
-    if ( ! M_goal_kick_opp_formation )
-    {
-        return false;
-    }
+    // no prefetch is needed if all formations have been read
+    M_prefetch_requested = read_all;
 
-    M_goal_kick_our_formation = readFormation( configpath + GOAL_KICK_OUR_FORMATION_CONF );
-    if ( ! M_goal_kick_our_formation )
-    {
-        return false;
-    }
+    s_initialized = true;
+    return true;
+}
 
-    M_goalie_catch_opp_formation = readFormation( configpath + GOALIE_CATCH_OPP_FORMATION_CONF );
-    if ( ! M_goalie_catch_opp_formation )
-    {
-        return false;
-    }
+/*-------------------------------------------------------------------*/
+/*!
 
-    M_goalie_catch_our_formation = readFormation( configpath + GOALIE_CATCH_OUR_FORMATION_CONF );
-    if ( ! M_goalie_catch_our_formation )
-    {
-        return false;
-    }
+ */
+CompiledFormation::Ptr
+Strategy::loadFormation( const FormationType type )
+{
+    CompiledFormation::Ptr f;
 
-    M_kickin_our_formation = readFormation( configpath + KICKIN_OUR_FORMATION_CONF );
-    if ( ! M_kickin_our_formation )
+    pthread_mutex_lock( &M_formation_mutex );
+    while ( M_formation_state[type] == Formation_Loading )
     {
-        std::cerr << "Failed to read kickin our formation" << std::endl;
-        return false;
+        // the other thread is reading this formation
+        pthread_cond_wait( &M_formation_cond, &M_formation_mutex );
     }
 
-    M_setplay_opp_formation = readFormation( configpath + SETPLAY_OPP_FORMATION_CONF );
-    if ( ! M_setplay_opp_formation )
+    if ( M_formation_state[type] != Formation_NotLoaded )
     {
-        std::cerr << "Failed to read setplay opp formation" << std::endl;
-        return false;
+        f = M_formations[type];
+        pthread_mutex_unlock( &M_formation_mutex );
+        return f;
     }
 
-    M_setplay_our_formation = readFormation( configpath + SETPLAY_OUR_FORMATION_CONF );
-    if ( ! M_setplay_our_formation )
-    {
-        std::cerr << "Failed to read setplay our formation" << std::endl;
-        return false;
-    }
+    M_formation_state[type] = Formation_Loading;
+    pthread_mutex_unlock( &M_formation_mutex );
+
+    // the slot is reserved. read the file without the lock.
+    f = readFormation( M_formation_path[type] );
 
-    M_indirect_freekick_opp_formation = readFormation( configpath + INDIRECT_FREEKICK_OPP_FORMATION_CONF );
-    if ( ! M_indirect_freekick_opp_formation )
+    pthread_mutex_lock( &M_formation_mutex );
+    if ( f
+         && ! checkGoalieUnum( *f, M_formation_path[type] ) )
     {
-        std::cerr << "Failed to read indirect freekick opp formation" << std::endl;
-        return false;
+        f.reset();
     }
+    M_formations[type] = f;
+    M_formation_state[type] = ( f ? Formation_Loaded : Formation_Failed );
+    pthread_cond_broadcast( &M_formation_cond );
+    pthread_mutex_unlock( &M_formation_mutex );
 
-    M_indirect_freekick_our_formation = readFormation( configpath + INDIRECT_FREEKICK_OUR_FORMATION_CONF );
-    if ( ! M_indirect_freekick_our_formation )
+    return f;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  M_formation_mutex has to be locked.
+ */
+bool
+Strategy::checkGoalieUnum( const CompiledFormation & f,
+                           const std::string & filepath )
+{
+    for ( int unum = 1; unum <= 11; ++unum )
     {
-        std::cerr << "Failed to read indirect freekick our formation" << std::endl;
-        return false;
-    }
+        const std::string role_name = f.getRoleName( unum );
+        if ( role_name == "Savior"
+             || role_name == "Goalie" )
+        {
+            if ( M_goalie_unum == Unum_Unknown )
+            {
+                M_goalie_unum = unum;
+            }
 
+            if ( M_goalie_unum != unum )
+            {
+                std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                          << " ***ERROR*** Illegal goalie's uniform number"
+                          << " read unum=" << unum
+                          << " expected=" << M_goalie_unum
+                          << " in [" << filepath << "]"
+                          << std::endl;
+                return false;
+            }
+        }
+    }
 
-    s_initialized = true;
     return true;
 }
 
@@ -297,73 +374,121 @@ Strategy::read( const std::string & formation_dir )
 /*!
 
  */
-Formation::Ptr
-Strategy::readFormation( const std::string & filepath )
+void
+Strategy::startPrefetch()
 {
-    Formation::Ptr f;
+    M_prefetch_requested = true;
 
-    std::ifstream fin( filepath.c_str() );
-    if ( ! fin.is_open() )
+    if ( pthread_create( &M_prefetch_thread, NULL, &Strategy::prefetch_main, this ) != 0 )
     {
         std::cerr << __FILE__ << ':' << __LINE__ << ':'
-                  << " ***ERROR*** failed to open file [" << filepath << "]"
+                  << " ***WARNING*** failed to start the formation prefetch thread."
+                  << " the formations are read when they are used."
                   << std::endl;
-        return f;
+        return;
     }
 
-    std::string temp, type;
-    fin >> temp >> type; // read training method type name
-    fin.seekg( 0 );
+    M_prefetch_running = true;
+}
 
-    f = createFormation( type );
+/*-------------------------------------------------------------------*/
+/*!
 
-    if ( ! f )
+ */
+void *
+Strategy::prefetch_main( void * arg )
+{
+    Strategy * self = static_cast< Strategy * >( arg );
+
+    for ( int i = 0; i < FormationType_Size; ++i )
+    {
+        self->loadFormation( static_cast< FormationType >( i ) );
+    }
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CompiledFormation::Ptr
+Strategy::readFormation( const std::string & filepath ) const
+{
+    CompiledFormation::Ptr f;
+
+    boost::uint64_t checksum = 0;
+    if ( ! CompiledFormation::checksum_file( filepath, &checksum ) )
     {
         std::cerr << __FILE__ << ':' << __LINE__ << ':'
-                  << " ***ERROR*** failed to create formation [" << filepath << "]"
+                  << " ***ERROR*** failed to open file [" << filepath << "]"
                   << std::endl;
         return f;
     }
 
+    SharedTableSegment & segment = SharedTableSegment::instance();
+    const std::string shared_key = SharedTableSegment::make_key( "formation", checksum );
+
     //
-    // read data from file
+    // refer to the block published by the owner of the shared segment.
     //
-    if ( ! f->read( fin ) )
     {
-        std::cerr << __FILE__ << ':' << __LINE__ << ':'
-                  << " ***ERROR*** failed to read formation [" << filepath << "]"
-                  << std::endl;
-        f.reset();
-        return f;
+        std::size_t size = 0;
+        const void * block = segment.find( shared_key, &size );
+        if ( block )
+        {
+            f = CompiledFormation::attach_memory( static_cast< const char * >( block ),
+                                                  size, checksum );
+        }
     }
 
+    //
+    // map the compiled cache. it is rejected if the text file has been changed.
+    //
+    if ( ! f
+         && M_use_formation_cache )
+    {
+        f = CompiledFormation::load( filepath + CompiledFormation::CACHE_SUFFIX,
+                                     checksum );
+    }
 
     //
-    // check role names
+    // read data from the text file
     //
-    for ( int unum = 1; unum <= 11; ++unum )
+    if ( ! f )
     {
-        const std::string role_name = f->getRoleName( unum );
-        if ( role_name == "Savior"
-             || role_name == "Goalie" )
+        f = readFormationText( filepath, checksum );
+        if ( ! f )
         {
-            if ( M_goalie_unum == Unum_Unknown )
-            {
-                M_goalie_unum = unum;
-            }
+            return f;
+        }
+    }
 
-            if ( M_goalie_unum != unum )
+    //
+    // publish the block and switch to the shared copy
+    //
+    if ( segment.isOwner() )
+    {
+        const void * block = segment.publish( shared_key, f->data(), f->dataSize() );
+        if ( block )
+        {
+            CompiledFormation::Ptr shared
+                = CompiledFormation::attach_memory( static_cast< const char * >( block ),
+                                                    f->dataSize(), checksum );
+            if ( shared )
             {
-                std::cerr << __FILE__ << ':' << __LINE__ << ':'
-                          << " ***ERROR*** Illegal goalie's uniform number"
-                          << " read unum=" << unum
-                          << " expected=" << M_goalie_unum
-                          << std::endl;
-                f.reset();
-                return f;
+                f = shared;
             }
         }
+    }
+
 
+    //
+    // check role names
+    //
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        const std::string role_name = f->getRoleName( unum );
 
 #ifdef USE_GENERIC_FACTORY
         SoccerRole::Ptr role = SoccerRole::create( role_name );
@@ -389,9 +514,101 @@ Strategy::readFormation( const std::string & filepath )
 #endif
     }
 
+    //
+    // bake the home positions
+    //
+    if ( M_formation_grid_step > 0.0
+         && f->triangleSize() > 0 )
+    {
+        char kind[32];
+        std::snprintf( kind, 32, "formation_grid_%g", M_formation_grid_step );
+        const std::string grid_key = SharedTableSegment::make_key( kind, checksum );
+
+        std::size_t size = 0;
+        const void * block = segment.find( grid_key, &size );
+        const bool shared = ( block
+                              && f->attachBaked( static_cast< const float * >( block ),
+                                                 size / sizeof( float ),
+                                                 M_formation_grid_step ) );
+        if ( ! shared )
+        {
+            if ( ! f->bake( M_formation_grid_step ) )
+            {
+                std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                          << " ***WARNING*** failed to bake the formation ["
+                          << filepath << "] step=" << M_formation_grid_step
+                          << std::endl;
+            }
+            else if ( segment.isOwner() )
+            {
+                block = segment.publish( grid_key, f->bakedData(),
+                                         f->bakedDataCount() * sizeof( float ) );
+                if ( block )
+                {
+                    f->attachBaked( static_cast< const float * >( block ),
+                                    f->bakedDataCount(),
+                                    M_formation_grid_step );
+                }
+            }
+        }
+    }
+
     return f;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CompiledFormation::Ptr
+Strategy::readFormationText( const std::string & filepath,
+                             const boost::uint64_t checksum ) const
+{
+    std::ifstream fin( filepath.c_str() );
+    if ( ! fin.is_open() )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " ***ERROR*** failed to open file [" << filepath << "]"
+                  << std::endl;
+        return CompiledFormation::Ptr();
+    }
+
+    std::string temp, type;
+    fin >> temp >> type; // read training method type name
+    fin.seekg( 0 );
+
+    Formation::Ptr f = createFormation( type );
+
+    if ( ! f )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " ***ERROR*** failed to create formation [" << filepath << "]"
+                  << std::endl;
+        return CompiledFormation::Ptr();
+    }
+
+    //
+    // read data from file
+    //
+    if ( ! f->read( fin ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " ***ERROR*** failed to read formation [" << filepath << "]"
+                  << std::endl;
+        return CompiledFormation::Ptr();
+    }
+
+    CompiledFormation::Ptr compiled = CompiledFormation::compile( *f, checksum );
+    if ( ! compiled )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " ***ERROR*** failed to compile formation [" << filepath << "]"
+                  << std::endl;
+    }
+
+    return compiled;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -442,6 +659,15 @@ Strategy::update( const WorldModel & wm )
     }
     s_update_time = wm.time();
 
+    //
+    // read the remaining formations in the background after kick-off
+    //
+    if ( ! M_prefetch_requested
+         && wm.gameMode().type() != GameMode::BeforeKickOff )
+    {
+        startPrefetch();
+    }
+
     updateSituation( wm );
     updatePosition( wm );
 }
@@ -561,7 +787,7 @@ Strategy::createRole( const int unum,
         return role;
     }
 
-    Formation::Ptr f = getFormation( world );
+    CompiledFormation::Ptr f = getFormation( world );
     if ( ! f )
     {
         std::cerr << __FILE__ << ": " << __LINE__
@@ -662,7 +888,7 @@ Strategy::updatePosition( const WorldModel & wm )
     }
     s_update_time = wm.time();
 
-    Formation::Ptr f = getFormation( wm );
+    CompiledFormation::Ptr f = getFormation( wm );
     if ( ! f )
     {
         std::cerr << wm.teamName() << ':' << wm.self().unum() << ": "
@@ -815,8 +1041,38 @@ Strategy::getPosition( const int unum ) const
 /*!
 
  */
-Formation::Ptr
+CompiledFormation::Ptr
 Strategy::getFormation( const WorldModel & wm ) const
+{
+    // reading the formation on demand does not change the logical state.
+    Strategy * self = const_cast< Strategy * >( this );
+
+    const FormationType type = getFormationType( wm );
+
+    CompiledFormation::Ptr f = self->loadFormation( type );
+    if ( f )
+    {
+        return f;
+    }
+
+    //
+    // the formation could not be read. use the normal formation instead.
+    //
+    f = self->loadFormation( Normal_Formation );
+    if ( f )
+    {
+        return f;
+    }
+
+    return self->loadFormation( BeforeKickOff_Formation );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Strategy::FormationType
+Strategy::getFormationType( const WorldModel & wm ) const
 {
     //
     // play on
@@ -825,13 +1081,13 @@ Strategy::getFormation( const WorldModel & wm ) const
     {
         switch ( M_current_situation ) {
         case Defense_Situation:
-            return M_defense_formation;
+            return Defense_Formation;
         case Offense_Situation:
-            return M_offense_formation;
+            return Offense_Formation;
         default:
             break;
         }
-        return M_normal_formation;
+        return Normal_Formation;
     }
 
     //
@@ -843,11 +1099,11 @@ Strategy::getFormation( const WorldModel & wm ) const
         if ( wm.ourSide() == wm.gameMode().side() )
         {
             // our kick-in or corner-kick
-            return M_kickin_our_formation;
+            return KickInOur_Formation;
         }
         else
         {
-            return M_setplay_opp_formation;
+            return SetPlayOpp_Formation;
         }
     }
 
@@ -859,7 +1115,7 @@ Strategy::getFormation( const WorldModel & wm ) const
          || ( wm.gameMode().type() == GameMode::IndFreeKick_
               && wm.gameMode().side() == wm.ourSide() ) )
     {
-        return M_indirect_freekick_our_formation;
+        return IndirectFreeKickOur_Formation;
     }
 
     //
@@ -870,7 +1126,7 @@ Strategy::getFormation( const WorldModel & wm ) const
          || ( wm.gameMode().type() == GameMode::IndFreeKick_
               && wm.gameMode().side() == wm.theirSide() ) )
     {
-        return M_indirect_freekick_opp_formation;
+        return IndirectFreeKickOpp_Formation;
     }
 
     //
@@ -887,11 +1143,11 @@ Strategy::getFormation( const WorldModel & wm ) const
             if ( wm.ball().pos().x < ServerParam::i().ourPenaltyAreaLineX() + 1.0
                  && wm.ball().pos().absY() < ServerParam::i().penaltyAreaHalfWidth() + 1.0 )
             {
-                return M_indirect_freekick_opp_formation;
+                return IndirectFreeKickOpp_Formation;
             }
             else
             {
-                return M_setplay_opp_formation;
+                return SetPlayOpp_Formation;
             }
         }
         else
@@ -902,11 +1158,11 @@ Strategy::getFormation( const WorldModel & wm ) const
             if ( wm.ball().pos().x > ServerParam::i().theirPenaltyAreaLineX()
                  && wm.ball().pos().absY() < ServerParam::i().penaltyAreaHalfWidth() )
             {
-                return M_indirect_freekick_our_formation;
+                return IndirectFreeKickOur_Formation;
             }
             else
             {
-                return M_setplay_our_formation;
+                return SetPlayOur_Formation;
             }
         }
     }
@@ -918,11 +1174,11 @@ Strategy::getFormation( const WorldModel & wm ) const
     {
         if ( wm.gameMode().side() == wm.ourSide() )
         {
-            return M_goal_kick_our_formation;
+            return GoalKickOur_Formation;
         }
         else
         {
-            return M_goal_kick_opp_formation;
+            return GoalKickOpp_Formation;
         }
     }
 
@@ -933,11 +1189,11 @@ Strategy::getFormation( const WorldModel & wm ) const
     {
         if ( wm.gameMode().side() == wm.ourSide() )
         {
-            return M_goalie_catch_our_formation;
+            return GoalieCatchOur_Formation;
         }
         else
         {
-            return M_goalie_catch_opp_formation;
+            return GoalieCatchOpp_Formation;
         }
     }
 
@@ -947,7 +1203,7 @@ Strategy::getFormation( const WorldModel & wm ) const
     if ( wm.gameMode().type() == GameMode::BeforeKickOff
          || wm.gameMode().type() == GameMode::AfterGoal_ )
     {
-        return M_before_kick_off_formation;
+        return BeforeKickOff_Formation;
     }
 
     //
@@ -955,12 +1211,12 @@ Strategy::getFormation( const WorldModel & wm ) const
     //
     if ( wm.gameMode().isOurSetPlay( wm.ourSide() ) )
     {
-        return M_setplay_our_formation;
+        return SetPlayOur_Formation;
     }
 
     if ( wm.gameMode().type() != GameMode::PlayOn )
     {
-        return M_setplay_opp_formation;
+        return SetPlayOpp_Formation;
     }
 
     //
@@ -968,14 +1224,14 @@ Strategy::getFormation( const WorldModel & wm ) const
     //
     switch ( M_current_situation ) {
     case Defense_Situation:
-        return M_defense_formation;
+        return Defense_Formation;
     case Offense_Situation:
-        return M_offense_formation;
+        return Offense_Formation;
     default:
         break;
     }
 
-    return M_normal_formation;
+    return Normal_Formation;
 }
 
 /*-------------------------------------------------------------------*/
@@ -33,11 +33,13 @@
 #define STRATEGY_H
 
 #include "soccer_role.h"
+#include "compiled_formation.h"
 
 #include <rcsc/formation/formation.h>
 #include <rcsc/geom/vector_2d.h>
 
 #include <boost/shared_ptr.hpp>
+#include <pthread.h>
 #include <map>
 #include <vector>
 #include <string>
@@ -90,6 +92,35 @@ public:
     };
 
 private:
+
+    /*!
+      \brief formations selected by the game mode and the situation
+     */
+    enum FormationType {
+        BeforeKickOff_Formation,
+        Normal_Formation,
+        Defense_Formation,
+        Offense_Formation,
+        GoalKickOpp_Formation,
+        GoalKickOur_Formation,
+        GoalieCatchOpp_Formation,
+        GoalieCatchOur_Formation,
+        KickInOur_Formation,
+        SetPlayOpp_Formation,
+        SetPlayOur_Formation,
+        IndirectFreeKickOpp_Formation,
+        IndirectFreeKickOur_Formation,
+
+        FormationType_Size
+    };
+
+    enum FormationState {
+        Formation_NotLoaded,
+        Formation_Loading,
+        Formation_Loaded,
+        Formation_Failed,
+    };
+
     //
     // factories
     //
@@ -106,21 +137,24 @@ private:
     // formations
     //
 
-    rcsc::Formation::Ptr M_before_kick_off_formation;
+    bool M_use_formation_cache; //!< if true, try to map the compiled formation cache
+    double M_formation_grid_step; //!< if positive, home positions are baked into the grid
+    bool M_formation_full_check; //!< if true, all formations are read and checked at startup
 
-    rcsc::Formation::Ptr M_normal_formation;
-    rcsc::Formation::Ptr M_defense_formation;
-    rcsc::Formation::Ptr M_offense_formation;
+    //
+    // formations are read when they are used first, or by the prefetch
+    // thread after kick-off. the slots are guarded by M_formation_mutex.
+    //
+    std::string M_formation_path[FormationType_Size];
+    CompiledFormation::Ptr M_formations[FormationType_Size];
+    FormationState M_formation_state[FormationType_Size];
+
+    pthread_mutex_t M_formation_mutex;
+    pthread_cond_t M_formation_cond; //!< signaled when a slot has been loaded
 
-    rcsc::Formation::Ptr M_goal_kick_opp_formation;
-    rcsc::Formation::Ptr M_goal_kick_our_formation;
-    rcsc::Formation::Ptr M_goalie_catch_opp_formation;
-    rcsc::Formation::Ptr M_goalie_catch_our_formation;
-    rcsc::Formation::Ptr M_kickin_our_formation;
-    rcsc::Formation::Ptr M_setplay_opp_formation;
-    rcsc::Formation::Ptr M_setplay_our_formation;
-    rcsc::Formation::Ptr M_indirect_freekick_opp_formation;
-    rcsc::Formation::Ptr M_indirect_freekick_our_formation;
+    bool M_prefetch_requested; //!< true after kick-off or if all formations are read
+    bool M_prefetch_running; //!< true if M_prefetch_thread has to be joined
+    pthread_t M_prefetch_thread;
 
 
     int M_goalie_unum;
@@ -144,6 +178,8 @@ private:
     const Strategy & operator=( const Strategy & );
 public:
 
+    ~Strategy();
+
     static
     Strategy & instance();
 
@@ -200,10 +236,25 @@ private:
     // update the current position table
     void updatePosition( const rcsc::WorldModel & wm );
 
-    rcsc::Formation::Ptr readFormation( const std::string & filepath );
+    /*!
+      \brief get the formation in the slot. it is read if not loaded yet.
+      \param type formation type
+      \return formation or NULL if it can not be read
+     */
+    CompiledFormation::Ptr loadFormation( const FormationType type );
+    CompiledFormation::Ptr readFormation( const std::string & filepath ) const;
+    CompiledFormation::Ptr readFormationText( const std::string & filepath,
+                                              const boost::uint64_t checksum ) const;
     rcsc::Formation::Ptr createFormation( const std::string & type_name ) const;
+    bool checkGoalieUnum( const CompiledFormation & f,
+                          const std::string & filepath );
+
+    void startPrefetch();
+    static
+    void * prefetch_main( void * arg );
 
-    rcsc::Formation::Ptr getFormation( const rcsc::WorldModel & wm ) const;
+    CompiledFormation::Ptr getFormation( const rcsc::WorldModel & wm ) const;
+    FormationType getFormationType( const rcsc::WorldModel & wm ) const;
 
 public:
     static
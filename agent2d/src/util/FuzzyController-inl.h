@@ -1,7 +1,7 @@
 /**
  * @brief
  * This code file represents a generic fuzzy logic controller
- * Code is divided into 3 classes: MembershipFunction, Rule and FuzzyController
+ * Code is divided into 2 classes: MembershipFunction and FuzzyController
  * In a nutshell:
  *   MembershipFunction represents any input/output in terms of
  *   its increase and decrease of strength on one or more levels (levels can
@@ -11,15 +11,20 @@
  *   for managing the relation between MembershipFunction and Rule,
  *   processing the input(s) to the Fuzzy Controller and calculating the
  *   output.
+ * Membership functions and rules are resolved to dense integer indices
+ *   when the controller is built, so the inference (fuzzify and
+ *   defuzzifyCentroid) works on flat arrays and allocates nothing.
  * */
 
 #ifndef UTILITIES_FUZZYCONTROLLER_H
 #define UTILITIES_FUZZYCONTROLLER_H
 
 #include <vector>
-#include <hash_map>
-#include <string.h>
-#include <stdarg.h>
+#include <map>
+#include <string>
+#include <cstring>
+#include <cstdarg>
+#include <cstddef>
 #include <limits>
 #include <iostream>
 #include <algorithm>
@@ -60,11 +65,12 @@ void trimNumeric(NumericalType* numeric,
 
 /**
  * @brief
- * The add rule function is generic in terms of accepting any
+ * The add rule function by names is generic in terms of accepting any
  *   number of antecedents and consequents by taking the "..."
  *   argument, so these constants must be passed to the function
  *   for it to be able to detect end of antecedents and end of
- *   consequents
+ *   consequents.
+ * Names are resolved only while the rule base is built.
  * */
 //const char* kRuleImplies = "__IMPLIES__";
 //const char* kRuleEnd     = "__END_RULE__";
@@ -80,9 +86,8 @@ const char* kRuleEnd() {
 
 /**
  * @brief
- * The fuzzification function takes the "..." argument as an input
- *   for it to be able to accept any number of numerical inputs for
- *   a fuzzy controller.
+ * The fuzzification function takes an array of inputs, input[i] is
+ *   bound to the fuzzification index i + 1.
  * In order to identify which input goes to which membership function,
  *   each membership function has an attribute "fuzzificationIndex"
  *   denoting which fuzzification input should fuzzify it.
@@ -110,16 +115,6 @@ enum MembershipFunctionKind {
   OUTPUT_MEMBERSHIP_FUNCTION
 };
 
-/**
- * @brief
- * Forward declaration because:
- *   1- Rule and FuzzyController are friends of MembershipFunction
- *   2- FuzzyController is friend of Rule
- * Friendship is used to allow access of private functions
- * */
-template <class MembershipType> class Rule;
-template <class MembershipType> class FuzzyController;
-
 /**
  * @brief
  * MembershipFunction is a way to represent a subset of any input or output
@@ -128,20 +123,12 @@ template <class MembershipType> class FuzzyController;
  * MembershipFunction only represents triangular and trapezoidal functions
  *   where the y-coordinate of start and end is always 0 while the one for
  *   topLeft and topRight is always 1
- * This design should suffice, however it can be modified easily; modification
- *   may need modifying the addRule function in the FuzzyController class
  * This design also reduces the runtime as it's a lot easier and faster to
- *   compute the fuzzyStrength for triangular and trapizoidal shapes
+ *   compute the fuzzy strength for triangular and trapizoidal shapes
  * */
 template <class MembershipType>
 class MembershipFunction {
   public:
-    /**
-		 * @brief
-     * fuzzificationIndex is useful to give each group of membership functions
-     *   (e.g.: low, medium and high of speed) an index to define which input
-     *   from the fuzzify function to be used with it.
-     * */
     MembershipFunction(void) {
       this->start    = 0;
       this->topLeft  = 0;
@@ -149,8 +136,6 @@ class MembershipFunction {
       this->end      = 0;
 
       this->fuzzificationIndex = kDummyFuzzificationIndex;
-
-      this->fuzzyStrength = 0;
     }
 
     /**
@@ -181,70 +166,19 @@ class MembershipFunction {
       this->end      = end;
 
       this->fuzzificationIndex = fuzzificationIndex;
-
-      this->fuzzyStrength = 0;
-    }
-
-  private:
-    friend class Rule<MembershipType>;
-    friend class FuzzyController<MembershipType>;
-
-    /*
-     * This function is mainly useful in making the controller dynamic in
-     *   a way that allows trying multiple values to get the desired results.
-     * This should be useful for training purposes.
-     * The following setters are for the same purpose.
-     * */
-    void updateMembershipFunction(MembershipType start,
-                                  MembershipType topLeft,
-                                  MembershipType topRight,
-                                  MembershipType end) {
-      this->start    = start;
-      this->topLeft  = topLeft;
-      this->topRight = topRight;
-      this->end      = end;
-
-      this->fuzzyStrength = 0;
-    }
-
-    void setStart(const MembershipType start) {
-      this->start = start;
-
-      this->fuzzyStrength = 0;
-    }
-
-    void setTopLeft(const MembershipType topLeft) {
-      this->topLeft = topLeft;
-
-      this->fuzzyStrength = 0;
-    }
-
-    void setTopRight(const MembershipType topRight) {
-      this->topRight = topRight;
-
-      this->fuzzyStrength = 0;
-    }
-
-    void setEnd(const MembershipType end) {
-      this->end = end;
-
-      this->fuzzyStrength = 0;
-    }
-
-    void setFuzzificationIndex(const int fuzzificationIndex) {
-      this->fuzzificationIndex = fuzzificationIndex;
     }
 
-    const int* getFuzzificationIndex(void) const {
-      return &this->fuzzificationIndex;
+    int getFuzzificationIndex(void) const {
+      return this->fuzzificationIndex;
     }
 
-    double* getFuzzyStrength(void) {
-      return &this->fuzzyStrength;
-    }
+    MembershipType getStart(void) const { return this->start; }
+    MembershipType getTopLeft(void) const { return this->topLeft; }
+    MembershipType getTopRight(void) const { return this->topRight; }
+    MembershipType getEnd(void) const { return this->end; }
 
     /*
-     * Given anyinput the fuzzy strength is set to a value ranging from
+     * Given any input the fuzzy strength is a value ranging from
      *   0.0 to 1.0 where this output represents the percentage of how
      *   the input represents this membership function
      * Typecasting is used since this is a template class that can
@@ -253,188 +187,191 @@ class MembershipFunction {
      *   will make it act like a crisp controller rather than a fuzzy one
      *   and lose the majority of its benefit.
      * */
-    void calculateFuzzyStrength(MembershipType &input) {
+    double calculateFuzzyStrength(const MembershipType input) const {
       if (input < this->start || input > this->end) {
-        this->fuzzyStrength = 0;
+        return 0;
       } else if (input >= this->topLeft && input <= this->topRight) {
-        this->fuzzyStrength = 1;
+        return 1;
       } else if (input < this->topLeft) {
-        this->fuzzyStrength = (double) ((double)(input - this->start) /
-                                        (double)(this->topLeft - this->start));
-      } else if (input > this->topRight) {
-        this->fuzzyStrength = (double) ((double)(this->end - input) /
-                                        (double)(this->end - this->topRight));
+        return (double) ((double)(input - this->start) /
+                         (double)(this->topLeft - this->start));
       }
+      return (double) ((double)(this->end - input) /
+                       (double)(this->end - this->topRight));
     }
 
+  private:
     MembershipType start,
                    topLeft,
                    topRight,
                    end;
 
-    double fuzzyStrength;
-
     int fuzzificationIndex;
 };
 
 /**
  * @brief
+ * Fuzzy Controller is the class the contains the fuzzification function,
+ *   the rulebase and the defuzzification function.
+ * Membership functions are stored in two vectors (inputs and outputs) and
+ *   they are referred by their position in the vector. The names are used
+ *   only while the controller is built.
  * A rule is a group of one or more input membership functions (antecedents)
  *   that implies a group of one or more output membership functions
- *   (consequents).
- * This is where the logic of the Fuzzy Controller is represented simply
- *   in natural language (e.g.: IF weather_cold AND sky_raining THEN
+ *   (consequents) (e.g.: IF weather_cold AND sky_raining THEN
  *   close_window AND turn_heater_high).
- * Similar to the fact that a Membership Function has a fuzzy strength
- *   depending on the corresponding input's value, a rule has firing
- *   strength depending on the combined fuzzy strengths of its
- *   antecedents (usually the min fuzzy strength of its antecedents)
+ * The firing strength of a rule is the min fuzzy strength of its
+ *   antecedents.
+ * Rules are stored as flat arrays:
+ *   ruleAntecedents[ruleAntecedentsBegin[r] .. ruleAntecedentsBegin[r+1])
+ *     holds the input membership function indices of the rule r.
+ *   ruleConsequents[r * outputsCount + (o - 1)] holds the output membership
+ *     function index of the rule r for the fuzzification index o, or -1.
  * */
 template <class MembershipType>
-class Rule {
+class FuzzyController {
   public:
-    /**
-		 * @brief
-     * Rules point to membership functions rather than taking a copy
-     *   because the same membership function can be used in multiple rules
-     *   while a change in value on the membership side should reflect
-     *   on the rule without the need for any changes in the rule.
-     * */
-    Rule(std::vector<MembershipFunction<MembershipType>*> antecedents,
-         std::vector<MembershipFunction<MembershipType>*> consequents) {
-      this->antecedents = antecedents;
-      this->consequents = consequents;
-
-      this->antecedentsCount = antecedents.size();
-      this->consequentsCount = consequents.size();
+    FuzzyController(void) {
+      this->outputsCount = 0;
+      this->valid = true;
 
-      this->firingStrength = 0;
+      this->ruleAntecedentsBegin.push_back(0);
     }
 
-  private:
-    friend class FuzzyController<MembershipType>;
-
-    /*
-     * The output strength is useful to set the upper limit for the
-     *   contribution of any output value in the final result. Let's say
-     *   we have possible output values O1-On and corresponding output
-     *   strengths S1-Sn where the output function is similar to
-     *   Output = S1*O1 + ... + Sn*On / S1 + ... + Sn where each Oi
-     *   correspods to an output membership function, so the following
-     *   function is responsible for calculating the corresponding Si.
-     *   Si is simply the minimum of the the fuzzy strength and the
-     *   corresponding rule's firing strength. In case the output is
-     *   included in more than one rule, the maximum outputStrength is
-     *   considered.
-     * @param consequentIndex: represents the order of the output in the
-     *                         rule (e.g.: if we want Y in the rule
-     *                         A and B --> X and Y then the index is 1)
-     * @param input: is any Oi according to the above explanation,
-     *               it's called input because it's an input from the
-     *               output membership function's prespective; however it's
-     *               still an output (consequent) from the Fuzzy Controller's
-     *               prespective
+    /**
+     * @brief
+     * addMembershipFunction simply adds a new Membership Function.
+     *   A function with an existing name replaces the old one.
+     * @param name: is used as a key to the membership function when rules
+     *              are added by names
+     * @param start, topLeft, topRight and end: represent the x-axis points
+     *              of the membership function from the smallest to the largest
+     *              as explained in the MembershipFunction class
+     * @param fuzzificationIndex: defines the order of the Memership Functions
+     *                            group that this one belongs to.
+     * @param membershipFunctionKind: defines whether this membership function
+     *                                belongs to input or output membership
+     *                                functions
+     * @return the index of the membership function
      * */
-    double getOutputStrength(const unsigned int consequentIndex,
-                             MembershipType input) const {
-      for (std::size_t i = 0; i < consequentsCount; i++) {
-        if (*(this->consequents[i]->getFuzzificationIndex()) ==
-              consequentIndex) {
-          this->consequents[i]->calculateFuzzyStrength(input);
-          return std::min(this->firingStrength,
-                          *(this->consequents[i]->getFuzzyStrength()));
+    int addMembershipFunction(const char* name,
+                              MembershipType start,
+                              MembershipType topLeft,
+                              MembershipType topRight,
+                              MembershipType end,
+                              int fuzzificationIndex,
+                              MembershipFunctionKind membershipFunctionKind) {
+      const MembershipFunction<MembershipType> function(start,
+                                                        topLeft,
+                                                        topRight,
+                                                        end,
+                                                        fuzzificationIndex);
+
+      std::vector<MembershipFunction<MembershipType> >& functions
+        = (membershipFunctionKind == INPUT_MEMBERSHIP_FUNCTION
+           ? this->inputMembershipFunctions
+           : this->outputMembershipFunctions);
+      std::map<std::string, int>& names
+        = (membershipFunctionKind == INPUT_MEMBERSHIP_FUNCTION
+           ? this->inputNames
+           : this->outputNames);
+
+      std::map<std::string, int>::iterator it = names.find(name);
+      if (it != names.end()) {
+        functions[it->second] = function;
+        return it->second;
+      }
+
+      const int index = (int)functions.size();
+      functions.push_back(function);
+      names.insert(std::make_pair(std::string(name), index));
+
+      if (membershipFunctionKind == INPUT_MEMBERSHIP_FUNCTION) {
+        this->inputStrengths.push_back(0.0);
+      } else {
+        this->outputStrengths.push_back(0.0);
+        if (fuzzificationIndex > this->outputsCount) {
+          resizeOutputs(fuzzificationIndex);
         }
       }
 
-      // default return
-      return 0.0;
+      return index;
     }
 
-    /*
-     * calculateFiringStrength function is responsible for calculating
-     *   the firing strength of the rule by getting the min. of its
-     *   antecedents' fuzzy strengths.
+    /**
+     * @return the index of the membership function or -1 if not found
      * */
-    void calculateFiringStrength(void) {
-      this->firingStrength = *(this->antecedents[0]->getFuzzyStrength());
+    int findMembershipFunction(const char* name,
+                               MembershipFunctionKind membershipFunctionKind)
+        const {
+      const std::map<std::string, int>& names
+        = (membershipFunctionKind == INPUT_MEMBERSHIP_FUNCTION
+           ? this->inputNames
+           : this->outputNames);
+
+      std::map<std::string, int>::const_iterator it = names.find(name);
+      return (it == names.end() ? -1 : it->second);
+    }
 
-      for (std::size_t i = 1; i < antecedentsCount; i ++) {
-        this->firingStrength =
-          std::min(this->firingStrength,
-                   *(this->antecedents[i]->getFuzzyStrength()));
+    /**
+     * @brief
+     * addRule adds a rule given the indices of its membership functions.
+     *   The rule is validated here: it MUST have at least one antecedent and
+     *   one consequent and all indices MUST refer to existing membership
+     *   functions. An invalid rule is not added and makes the controller
+     *   invalid.
+     * @return true if the rule is added
+     * */
+    bool addRule(const int* antecedents,
+                 const int antecedentsCount,
+                 const int* consequents,
+                 const int consequentsCount) {
+      bool ok = (antecedentsCount > 0 && consequentsCount > 0);
+
+      for (int i = 0; ok && i < antecedentsCount; i ++) {
+        ok = (antecedents[i] >= 0
+              && antecedents[i] < (int)this->inputMembershipFunctions.size());
       }
-    }
 
-    std::vector<MembershipFunction<MembershipType>*> antecedents,
-                                                     consequents;
+      for (int i = 0; ok && i < consequentsCount; i ++) {
+        ok = (consequents[i] >= 0
+              && consequents[i] < (int)this->outputMembershipFunctions.size());
+      }
 
-    std::size_t antecedentsCount,
-                consequentsCount;
+      if (!ok) {
+        std::cerr << "fuzzy::FuzzyController: invalid rule #"
+                  << getRulesCount() << std::endl;
+        this->valid = false;
+        return false;
+      }
 
-    double firingStrength;
-};
+      const std::size_t r = getRulesCount();
 
-/**
- * @brief
- * Fuzzy Controller is the class the contains the fuzzification function,
- *   the rulebase and the defuzzification function; those 3 main components
- *   deal with and use stored objects from the MembershipFunction and the
- *   Rule classes.
- * MembershipFunction objects are stored in a hash table where the 'name'
- *   (describing the functionality and type of the MembershipFunction) is
- *   the key. Hash table is used since upon the creation of rules,
- *   MembershipFunction objects are pointed to multiple times.
- * Rules are stored in a vector since all rule-related operations involve
- *   looping on all the available rules.
- * */
-template <class MembershipType>
-class FuzzyController {
-  public:
-    FuzzyController(void) {
-      this->rulesCount = 0;
-    }
-    /**
-		 * @brief
-     * addMembershipFunction simply adds a new Membership Function to the
-     *   hash table
-     * @param name: is used as a key to the membership function when storing
-     *              it in the hash table
-     * @param start, topLeft, topRight and end: represent the x-axis points
-     *              of the membership function from the smallest to the largest
-     *              as explained in the MembershipFunction class
-     * @param fuzzificationIndex: defines the order of the Memership Functions
-     *                            group that this one belongs to.
-     * @param membershipFunctionKind: defines whether this membership function
-     *                                belongs to input or output membership
-     *                                functions
-     * */
-    void addMembershipFunction(const char* name,
-                               MembershipType start,
-                               MembershipType topLeft,
-                               MembershipType topRight,
-                               MembershipType end,
-                               int fuzzificationIndex,
-                               MembershipFunctionKind membershipFunctionKind) {
-      if (membershipFunctionKind == INPUT_MEMBERSHIP_FUNCTION) {
-        inputMembershipFunctions[name] =
-          MembershipFunction<MembershipType>(start,
-                                             topLeft,
-                                             topRight,
-                                             end,
-                                             fuzzificationIndex);
-      } else if (membershipFunctionKind == OUTPUT_MEMBERSHIP_FUNCTION) {
-        outputMembershipFunctions[name] =
-          MembershipFunction<MembershipType>(start,
-                                             topLeft,
-                                             topRight,
-                                             end,
-                                             fuzzificationIndex);
+      for (int i = 0; i < antecedentsCount; i ++) {
+        this->ruleAntecedents.push_back(antecedents[i]);
+      }
+      this->ruleAntecedentsBegin.push_back(this->ruleAntecedents.size());
+
+      this->firingStrengths.push_back(0.0);
+      this->ruleConsequents.resize((r + 1) * this->outputsCount, -1);
+
+      // only the first consequent of each output group is used,
+      //   consequents with the dummy index are ignored
+      for (int i = consequentsCount - 1; i >= 0; i --) {
+        const int o = this->outputMembershipFunctions[consequents[i]]
+                        .getFuzzificationIndex();
+        if (o >= kMinValidFuzzificationIndex) {
+          this->ruleConsequents[r * this->outputsCount + (o - 1)]
+            = consequents[i];
+        }
       }
+
+      return true;
     }
 
     /**
-		 * @brief
-     * addRule function MUST get at least one antecedent and one
+     * @brief
+     * addRule function by names MUST get at least one antecedent and one
      *   concequent.
      * The function accepts the '...' paramter in order to allow for a rule
      *   with any number of antecedents/concequents.
@@ -446,94 +383,94 @@ class FuzzyController {
      *   concequents.
      * Example: addRule("watherHot",
      *                  "sunny",
-     *                  kRuleImplies,
+     *                  kRuleImplies(),
      *                  "curtainsDown",
      *                  "coolerOn",
-     *                  kRuleEnd);
+     *                  kRuleEnd());
+     * Unknown names make the rule invalid.
      * */
-    void addRule(const char* firstAntecedent, ...) {
-      antecedents.clear();
-      consequents.clear();
+    bool addRule(const char* firstAntecedent, ...) {
+      std::vector<int> antecedents,
+                       consequents;
+      bool known = true;
 
       va_list argsPointer;
       va_start(argsPointer, firstAntecedent);
 
       const char* currentArg = firstAntecedent;
 
-      while (strcmp(currentArg, kRuleImplies()) != 0) {
-        antecedents.push_back
-          (&inputMembershipFunctions.find(currentArg)->second);
+      while (std::strcmp(currentArg, kRuleImplies()) != 0) {
+        const int index = findMembershipFunction(currentArg,
+                                                 INPUT_MEMBERSHIP_FUNCTION);
+        if (index < 0) {
+          std::cerr << "fuzzy::FuzzyController: unknown antecedent "
+                    << currentArg << std::endl;
+          known = false;
+        }
+        antecedents.push_back(index);
         currentArg = va_arg(argsPointer, const char*);
       }
 
       currentArg = va_arg(argsPointer, const char*);
 
-      while (strcmp(currentArg, kRuleEnd()) != 0) {
-        consequents.push_back
-          (&outputMembershipFunctions.find(currentArg)->second);
+      while (std::strcmp(currentArg, kRuleEnd()) != 0) {
+        const int index = findMembershipFunction(currentArg,
+                                                 OUTPUT_MEMBERSHIP_FUNCTION);
+        if (index < 0) {
+          std::cerr << "fuzzy::FuzzyController: unknown consequent "
+                    << currentArg << std::endl;
+          known = false;
+        }
+        consequents.push_back(index);
         currentArg = va_arg(argsPointer, const char*);
       }
 
       va_end(argsPointer);
 
-      rules.push_back(Rule<MembershipType>(antecedents, consequents));
+      if (!known || antecedents.empty() || consequents.empty()) {
+        this->valid = false;
+        return false;
+      }
 
-      this->rulesCount += 1;
+      return addRule(&antecedents[0],
+                     (int)antecedents.size(),
+                     &consequents[0],
+                     (int)consequents.size());
     }
 
     /**
-		 * @brief
+     * @brief
      * After all membership functions and rules are added to the fuzzy
      *   controller, the the controller is ready to function. On the cycle
      *   of passing an input and getting an output, fuzzify is the 1st step.
      * The functionality of this function is to accept some inputs, and
      *   calculate the fuzzy strength of membership function(s) corresponding
-     *   to each of the inputs, where the order of the input (0 - N) binds
-     *   this input with the corresponding membership function(s).
-     * The '...' parameter is passed to the function to allow for the
-     *   flexibility of passing any number of inputs,
-     *   numeric_limits<MembershipType>::max() MUST be the last parameter
-     *   to be passed to the function to mark the end of input.
+     *   to each of the inputs, where input[i] is bound to the membership
+     *   function(s) whose fuzzification index is i + 1.
+     * Membership functions bound to an index larger than inputsCount keep
+     *   their previous strength.
      * Example (assuming MembershipType = float and assuming 3 groups of
      *   input membership functions):
-     *   fuzzify(20.0,
-     *           12.3,
-     *           44.7,
-     *           numeric_limits<float>::max());
-     * NOTE: this function won't behave correctly in case one of the parameters
-     *       was equivalent to std::numeric_limits<MembershipType>::max()
-     *       because std::numeric_limits<MembershipType>::max() is used to
-     *       mark the end of input for the function. Usually this mistake
-     *       doesn't happen.
+     *   const float input[3] = { 20.0, 12.3, 44.7 };
+     *   fuzzify(input, 3);
      * */
-    void fuzzify(MembershipType firstInput, ...) {
-      MembershipType currentInput = firstInput;
-
-      va_list argsPointer;
-      va_start(argsPointer, firstInput);
-
-      for (int inputIndex = kMinValidFuzzificationIndex;
-           (currentInput != std::numeric_limits<MembershipType>::max()) &&
-           (inputIndex != std::numeric_limits<int>::max());
-           inputIndex ++) {
-        for (membershipFunctionsIterator =  inputMembershipFunctions.begin();
-             membershipFunctionsIterator != inputMembershipFunctions.end  ();
-             membershipFunctionsIterator ++){
-          if (*(membershipFunctionsIterator->second.getFuzzificationIndex()) ==
-              inputIndex) {
-            membershipFunctionsIterator->second.calculateFuzzyStrength(
-              currentInput);
-          }
+    void fuzzify(const MembershipType* input,
+                 const int inputsCount) {
+      const std::size_t size = this->inputMembershipFunctions.size();
+
+      for (std::size_t m = 0; m < size; m ++) {
+        const int index =
+          this->inputMembershipFunctions[m].getFuzzificationIndex() - 1;
+        if (index >= 0 && index < inputsCount) {
+          this->inputStrengths[m] =
+            this->inputMembershipFunctions[m]
+              .calculateFuzzyStrength(input[index]);
         }
-
-        currentInput = va_arg(argsPointer, MembershipType);
       }
-
-      va_end(argsPointer);
     }
 
     /**
-		 * @brief
+     * @brief
      * defuzzifyCentroid function is responsible for calculating the output
      *   of the Fuzzy Controller for some combination of inputs.
      * @param consequentIndex: defines which group of output membership
@@ -546,46 +483,165 @@ class FuzzyController {
      *                         of the minimum membership function representing
      *                         the output).
      * @param consequentEnd: same as consequentStart but for the maximum
-     * @param discretization: defines how many discrete points should be used
-     *                        during output calculation
      * The consequentStart and consequentEnd parameters gives flexibility
      *   in defining the output limits in a dynamic real-time way.
+     * The output membership function M of the group is clipped at the
+     *   strength S(M), the max firing strength of the rules implying M.
+     *   The output is the centroid of the max envelope of the clipped
+     *   functions on [consequentStart, consequentEnd]:
+     *   Integral(x * E(x)) / Integral(E(x))
+     * Since the clipped functions are piecewise linear, both integrals are
+     *   calculated exactly: the envelope is linear between the knots of the
+     *   clipped functions and the crossing points of their pieces.
+     * 0 is returned if no rule fires.
      * */
     MembershipType defuzzifyCentroid(unsigned int consequentIndex,
                                      MembershipType consequentStart,
-                                     MembershipType consequentEnd,
-                                     MembershipType discretization
-                                       = 8) {
-      for (std::size_t i = 0; i < rulesCount; i ++) {
-        this->rules[i].calculateFiringStrength();
+                                     MembershipType consequentEnd) {
+      const std::size_t rulesCount = getRulesCount();
+
+      for (std::size_t r = 0; r < rulesCount; r ++) {
+        double strength = 1.0;
+        for (std::size_t a = this->ruleAntecedentsBegin[r];
+             a < this->ruleAntecedentsBegin[r + 1];
+             a ++) {
+          strength = std::min(strength,
+                              this->inputStrengths[this->ruleAntecedents[a]]);
+        }
+        this->firingStrengths[r] = strength;
       }
 
-      MembershipType discretizationDelta = (consequentEnd - consequentStart) /
-                                           discretization;
+      if (consequentIndex < 1
+          || (int)consequentIndex > this->outputsCount
+          || this->ruleConsequents.empty()) {
+        return (MembershipType) 0;
+      }
 
-      double currentOutputStrength,
-             numerator,
-             dominator;
+      //
+      // clip level of each output membership function
+      //
+      std::fill(this->outputStrengths.begin(),
+                this->outputStrengths.end(),
+                0.0);
+
+      const int* consequents = &this->ruleConsequents[consequentIndex - 1];
+      for (std::size_t r = 0; r < rulesCount; r ++) {
+        const int c = consequents[r * this->outputsCount];
+        if (c >= 0) {
+          this->outputStrengths[c] = std::max(this->outputStrengths[c],
+                                              this->firingStrengths[r]);
+        }
+      }
 
-      numerator = 0.0;
-      dominator = 0.0;
+      //
+      // knots of the clipped functions
+      //
+      const double lower = (double) consequentStart;
+      const double upper = (double) consequentEnd;
+
+      this->activeOutputs.clear();
+      this->knots.clear();
+      this->knots.push_back(lower);
+      this->knots.push_back(upper);
+
+      for (std::size_t c = 0; c < this->outputStrengths.size(); c ++) {
+        const double level = this->outputStrengths[c];
+        if (level <= 0.0) {
+          continue;
+        }
 
-      for (MembershipType i = consequentStart;
-           i <= consequentEnd;
-           i += discretizationDelta) {
-        currentOutputStrength = 0.0;
-        for (std::size_t j = 0; j < rulesCount; j ++) {
-          currentOutputStrength =
-            std::max(currentOutputStrength,
-                     this->rules[j].getOutputStrength(consequentIndex, i));
+        const MembershipFunction<MembershipType>& function
+          = this->outputMembershipFunctions[c];
+        const double start    = (double) function.getStart();
+        const double topLeft  = (double) function.getTopLeft();
+        const double topRight = (double) function.getTopRight();
+        const double end      = (double) function.getEnd();
+
+        this->activeOutputs.push_back((int) c);
+        this->knots.push_back(start);
+        this->knots.push_back(topLeft);
+        this->knots.push_back(topRight);
+        this->knots.push_back(end);
+
+        if (level < 1.0) {
+          this->knots.push_back(start + level * (topLeft - start));
+          this->knots.push_back(end - level * (end - topRight));
+        }
+      }
+
+      if (this->activeOutputs.empty()) {
+        return (MembershipType) 0;
+      }
+
+      std::sort(this->knots.begin(), this->knots.end());
+
+      //
+      // integrate the envelope piece by piece
+      //
+      const std::size_t activeCount = this->activeOutputs.size();
+      this->slopes.resize(activeCount);
+      this->intercepts.resize(activeCount);
+
+      double numerator = 0.0,
+             dominator = 0.0;
+
+      for (std::size_t k = 1; k < this->knots.size(); k ++) {
+        const double x0 = std::max(this->knots[k - 1], lower);
+        const double x1 = std::min(this->knots[k], upper);
+        if (x1 <= x0) {
+          continue;
+        }
+
+        // every clipped function is linear on (x0, x1)
+        const double middle = (x0 + x1) * 0.5;
+        for (std::size_t j = 0; j < activeCount; j ++) {
+          const int c = this->activeOutputs[j];
+          getClippedLine(this->outputMembershipFunctions[c],
+                         this->outputStrengths[c],
+                         middle,
+                         &this->slopes[j],
+                         &this->intercepts[j]);
+        }
+
+        // the envelope is linear between the crossing points of the lines
+        this->crossings.clear();
+        this->crossings.push_back(x0);
+        this->crossings.push_back(x1);
+        for (std::size_t i = 0; i < activeCount; i ++) {
+          for (std::size_t j = i + 1; j < activeCount; j ++) {
+            const double da = this->slopes[i] - this->slopes[j];
+            if (da == 0.0) {
+              continue;
+            }
+            const double x = (this->intercepts[j] - this->intercepts[i]) / da;
+            if (x0 < x && x < x1) {
+              this->crossings.push_back(x);
+            }
+          }
+        }
+
+        if (this->crossings.size() > 2) {
+          std::sort(this->crossings.begin(), this->crossings.end());
+        } else {
+          this->crossings[0] = x0;
+          this->crossings[1] = x1;
+        }
+
+        double p0 = this->crossings[0];
+        double y0 = getEnvelope(activeCount, p0);
+
+        for (std::size_t i = 1; i < this->crossings.size(); i ++) {
+          const double p1 = this->crossings[i];
+          const double y1 = getEnvelope(activeCount, p1);
+          const double width = p1 - p0;
+
+          dominator += width * (y0 + y1) * 0.5;
+          numerator += width * (p0 * (2.0 * y0 + y1) + p1 * (y0 + 2.0 * y1))
+                       / 6.0;
+
+          p0 = p1;
+          y0 = y1;
         }
-        // This part gives more strength for discrete points with
-        //   higher outputStrength (>0.5) than those that are lower
-        /*currentOutputStrength = currentOutputStrength > 0.5?
-                                  currentOutputStrength*2 :
-                                  currentOutputStrength/2;*/
-        numerator += i * currentOutputStrength;
-        dominator +=     currentOutputStrength;
       }
 
       dominator = dominator == 0? 1 : dominator;
@@ -593,27 +649,110 @@ class FuzzyController {
       return (MembershipType) (numerator / dominator);
     }
 
+    /**
+     * @return false if an invalid rule was given while building the
+     *         controller
+     * */
+    bool isValid(void) const {
+      return this->valid;
+    }
+
+    std::size_t getRulesCount(void) const {
+      return this->firingStrengths.size();
+    }
+
   private:
 
-    // Two hash tables are used to store input and output membership functions
-    __gnu_cxx::hash_map <const char*, MembershipFunction<MembershipType> >
-      inputMembershipFunctions,
-      outputMembershipFunctions;
-    // The following iterator is used to iterate on the previous hashtables
-    typename __gnu_cxx::hash_map <const char*,
-                                  MembershipFunction<MembershipType> >::iterator
-      membershipFunctionsIterator;
-    // The following vector is used to store rules
-    std::vector<Rule<MembershipType> > rules;
     /*
-     * The following variable is used to store the count of rules instead of
-     *   calculating it everytime.
+     * getClippedLine gets the line y = slope * x + intercept that the
+     *   function clipped at level follows around the point x.
+     * */
+    static void getClippedLine(const MembershipFunction<MembershipType>& function,
+                               const double level,
+                               const double x,
+                               double* slope,
+                               double* intercept) {
+      const double start    = (double) function.getStart();
+      const double topLeft  = (double) function.getTopLeft();
+      const double topRight = (double) function.getTopRight();
+      const double end      = (double) function.getEnd();
+
+      if (x < start || x > end) {
+        *slope = 0.0;
+        *intercept = 0.0;
+      } else if (x >= topLeft && x <= topRight) {
+        *slope = 0.0;
+        *intercept = 1.0;
+      } else if (x < topLeft) {
+        *slope = 1.0 / (topLeft - start);
+        *intercept = -start * (*slope);
+      } else {
+        *slope = -1.0 / (end - topRight);
+        *intercept = end / (end - topRight);
+      }
+
+      if ((*slope) * x + (*intercept) > level) {
+        *slope = 0.0;
+        *intercept = level;
+      }
+    }
+
+    double getEnvelope(const std::size_t activeCount,
+                       const double x) const {
+      double y = 0.0;
+      for (std::size_t j = 0; j < activeCount; j ++) {
+        y = std::max(y, this->slopes[j] * x + this->intercepts[j]);
+      }
+      return y;
+    }
+
+    /*
+     * resizeOutputs widens the consequent table when an output membership
+     *   function with a new fuzzification index is added after some rules.
      * */
-    std::size_t rulesCount;
-    // The following are temp. vectors used during the construction
-    //   of a new rule.
-    std::vector<MembershipFunction<MembershipType>*> antecedents,
-                                                     consequents;
+    void resizeOutputs(const int outputsCount) {
+      const std::size_t rulesCount = getRulesCount();
+      std::vector<int> consequents(rulesCount * outputsCount, -1);
+
+      for (std::size_t r = 0; r < rulesCount; r ++) {
+        for (int o = 0; o < this->outputsCount; o ++) {
+          consequents[r * outputsCount + o] =
+            this->ruleConsequents[r * this->outputsCount + o];
+        }
+      }
+
+      this->ruleConsequents.swap(consequents);
+      this->outputsCount = outputsCount;
+    }
+
+    // membership functions, referred by their index
+    std::vector<MembershipFunction<MembershipType> >
+      inputMembershipFunctions,
+      outputMembershipFunctions;
+    // name to index, used only while the controller is built
+    std::map<std::string, int> inputNames,
+                               outputNames;
+    // fuzzy strength of each input membership function
+    std::vector<double> inputStrengths;
+
+    // flat rule base (see the class comment)
+    std::vector<int> ruleAntecedents;
+    std::vector<std::size_t> ruleAntecedentsBegin;
+    std::vector<int> ruleConsequents;
+    int outputsCount;
+    // firing strength of each rule
+    std::vector<double> firingStrengths;
+    // clip level of each output membership function
+    std::vector<double> outputStrengths;
+
+    // work area of defuzzifyCentroid, reused to avoid allocation
+    std::vector<int> activeOutputs;
+    std::vector<double> knots,
+                        crossings,
+                        slopes,
+                        intercepts;
+
+    bool valid;
 };
 
 }
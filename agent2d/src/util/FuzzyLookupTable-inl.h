@@ -0,0 +1,321 @@
+/**
+ * @brief
+ * This code file represents a lookup table compiled from a fuzzy controller.
+ * A fuzzy controller with bounded inputs is a fixed function of its inputs,
+ *   so it can be sampled once on a regular grid at startup and evaluated
+ *   later by interpolating the grid values.
+ * In a nutshell:
+ *   FuzzyLookupTable holds one axis for every input of the controller
+ *   (min, max and sample count). compile() evaluates the live controller
+ *   on every grid point, check() compares the interpolated values with the
+ *   live controller at the centers of the grid cells and lookup() returns
+ *   the multilinear interpolation of the 2^N corners of the cell that
+ *   contains the input.
+ *   The grid values can also be attached from a memory block shared with
+ *   other processes instead of compiling them (see attach()).
+ * */
+
+#ifndef UTILITIES_FUZZYLOOKUPTABLE_H
+#define UTILITIES_FUZZYLOOKUPTABLE_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+namespace fuzzy {
+
+/**
+ * @brief
+ * The table is sampled on a regular grid, inputs outside the grid are
+ *   clamped to the nearest border, so callers are expected to trim the
+ *   inputs in the same way as they do for the live controller.
+ * The Function template parameter of compile() and check() can be any
+ *   object that has the following operator:
+ *   NumericalType operator()(const NumericalType* input) const;
+ *   where input[0] .. input[N-1] are the inputs in the order of the axes.
+ * */
+template <class NumericalType>
+class FuzzyLookupTable {
+  public:
+    static const int kMaxDimensions = 8;
+
+    FuzzyLookupTable(void) {
+      this->dimensions = 0;
+      this->table = 0;
+      this->valid = false;
+      this->maxError = 0.0;
+    }
+
+    /**
+     * @brief
+     * addAxis adds a new input axis, axes MUST be added in the order of
+     *   the inputs and before calling compile().
+     * @param min: the lowest sampled input value
+     * @param max: the highest sampled input value
+     * @param samples: the number of grid points on this axis (>= 2)
+     * @return false if the axis can't be added
+     * */
+    bool addAxis(NumericalType min,
+                 NumericalType max,
+                 int samples) {
+      if (this->dimensions >= kMaxDimensions
+          || samples < 2
+          || max <= min) {
+        return false;
+      }
+
+      const int d = this->dimensions;
+
+      this->axisMin[d] = min;
+      this->axisMax[d] = max;
+      this->samples[d] = samples;
+      this->inverseStep[d] = (double)(samples - 1) / (double)(max - min);
+
+      this->dimensions += 1;
+      this->valid = false;
+
+      return true;
+    }
+
+    /**
+     * @brief
+     * compile samples the function on every grid point.
+     * The table becomes valid after this call, check() can disable it.
+     * */
+    template <class Function>
+    void compile(const Function& function) {
+      std::size_t size = 1;
+      for (int d = this->dimensions - 1; d >= 0; d --) {
+        this->stride[d] = size;
+        size *= this->samples[d];
+      }
+
+      this->values.assign(size, NumericalType(0));
+      this->table = &this->values[0];
+
+      NumericalType input[kMaxDimensions];
+      int index[kMaxDimensions];
+
+      for (int d = 0; d < this->dimensions; d ++) {
+        index[d] = 0;
+      }
+
+      for (std::size_t i = 0; i < size; i ++) {
+        for (int d = 0; d < this->dimensions; d ++) {
+          input[d] = gridValue(d, index[d]);
+        }
+
+        this->values[i] = function(input);
+
+        // increment the index counter, the last axis changes fastest
+        for (int d = this->dimensions - 1; d >= 0; d --) {
+          if (++index[d] < this->samples[d]) {
+            break;
+          }
+          index[d] = 0;
+        }
+      }
+
+      this->valid = (this->dimensions > 0);
+      this->maxError = 0.0;
+    }
+
+    /**
+     * @brief
+     * check compares the table with the function at the center of every
+     *   grid cell, where the interpolation error is expected to be the
+     *   largest.
+     * @param function: the live controller
+     * @param tolerance: the table is disabled if the maximum absolute error
+     *                   exceeds this value
+     * @return the maximum absolute error
+     * */
+    template <class Function>
+    double check(const Function& function,
+                 const double tolerance) {
+      if (this->table == 0) {
+        this->valid = false;
+        return 0.0;
+      }
+
+      const bool compiled = this->valid;
+      this->valid = true;
+
+      std::size_t cells = 1;
+      for (int d = 0; d < this->dimensions; d ++) {
+        cells *= (this->samples[d] - 1);
+      }
+
+      NumericalType input[kMaxDimensions];
+      int index[kMaxDimensions];
+
+      for (int d = 0; d < this->dimensions; d ++) {
+        index[d] = 0;
+      }
+
+      double error = 0.0;
+
+      for (std::size_t i = 0; i < cells; i ++) {
+        for (int d = 0; d < this->dimensions; d ++) {
+          input[d] = (gridValue(d, index[d]) + gridValue(d, index[d] + 1)) / 2;
+        }
+
+        error = std::max(error,
+                         std::fabs((double)(lookup(input) - function(input))));
+
+        for (int d = this->dimensions - 1; d >= 0; d --) {
+          if (++index[d] < this->samples[d] - 1) {
+            break;
+          }
+          index[d] = 0;
+        }
+      }
+
+      this->maxError = error;
+      this->valid = compiled && (error <= tolerance);
+
+      return error;
+    }
+
+    /**
+     * @brief
+     * lookup returns the multilinear interpolation of the grid values.
+     *   It MUST NOT be called while the table is invalid.
+     * @param input: input[0] .. input[N-1] in the order of the axes
+     * */
+    NumericalType lookup(const NumericalType* input) const {
+      double fraction[kMaxDimensions];
+      std::size_t base = 0;
+
+      for (int d = 0; d < this->dimensions; d ++) {
+        double t = (double)(input[d] - this->axisMin[d]) * this->inverseStep[d];
+        t = std::max(0.0, std::min(t, (double)(this->samples[d] - 1)));
+
+        int i = (int)t;
+        if (i > this->samples[d] - 2) {
+          i = this->samples[d] - 2;
+        }
+
+        fraction[d] = t - i;
+        base += i * this->stride[d];
+      }
+
+      // gather the 2^N corners, bit d of the corner index selects the
+      //   upper grid point on axis d
+      const int corners = 1 << this->dimensions;
+      double value[1 << kMaxDimensions];
+
+      for (int c = 0; c < corners; c ++) {
+        std::size_t offset = base;
+        for (int d = 0; d < this->dimensions; d ++) {
+          if (c & (1 << d)) {
+            offset += this->stride[d];
+          }
+        }
+        value[c] = (double)this->table[offset];
+      }
+
+      // reduce one axis at a time
+      for (int d = this->dimensions - 1; d >= 0; d --) {
+        const int half = 1 << d;
+        for (int c = 0; c < half; c ++) {
+          value[c] += fraction[d] * (value[c + half] - value[c]);
+        }
+      }
+
+      return (NumericalType)value[0];
+    }
+
+    /**
+     * @brief
+     * attach uses the grid values compiled and checked by another table
+     *   with the same axes, e.g. in a shared memory segment. The private
+     *   values are released.
+     * @param shared: the grid values, MUST outlive this table
+     * @param count: the number of the grid values
+     * @param error: the maximum error measured by check()
+     * @return false if count does not match the axes
+     * */
+    bool attach(const NumericalType* shared,
+                std::size_t count,
+                double error) {
+      std::size_t size = 1;
+      for (int d = this->dimensions - 1; d >= 0; d --) {
+        this->stride[d] = size;
+        size *= this->samples[d];
+      }
+
+      if (this->dimensions == 0
+          || shared == 0
+          || count != size) {
+        return false;
+      }
+
+      std::vector<NumericalType>().swap(this->values);
+      this->table = shared;
+      this->valid = true;
+      this->maxError = error;
+
+      return true;
+    }
+
+    /**
+     * @brief
+     * data returns the grid values (the last axis is contiguous),
+     *   size() values are available.
+     * */
+    const NumericalType* data(void) const {
+      return this->table;
+    }
+
+    bool isValid(void) const {
+      return this->valid;
+    }
+
+    double getMaxError(void) const {
+      return this->maxError;
+    }
+
+    std::size_t size(void) const {
+      if (this->table == 0) {
+        return 0;
+      }
+
+      std::size_t size = 1;
+      for (int d = 0; d < this->dimensions; d ++) {
+        size *= this->samples[d];
+      }
+      return size;
+    }
+
+  private:
+    NumericalType gridValue(const int axis,
+                            const int index) const {
+      if (index >= this->samples[axis] - 1) {
+        return this->axisMax[axis];
+      }
+      return (NumericalType)(this->axisMin[axis]
+                             + index / this->inverseStep[axis]);
+    }
+
+    int dimensions;
+
+    NumericalType axisMin[kMaxDimensions],
+                  axisMax[kMaxDimensions];
+    int samples[kMaxDimensions];
+    double inverseStep[kMaxDimensions];
+    std::size_t stride[kMaxDimensions];
+
+    // grid values, the last axis is contiguous
+    std::vector<NumericalType> values;
+    // points to values or to the attached block
+    const NumericalType* table;
+
+    bool valid;
+    double maxError;
+};
+
+}
+
+#endif // #ifndef UTILITIES_FUZZYLOOKUPTABLE_H